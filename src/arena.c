@@ -0,0 +1,51 @@
+#include "arena.h"
+
+#include "common.h"
+
+/* Alignment of every allocation */
+#define ARENA_ALIGN (sizeof(max_align_t))
+
+void arena_construct(Arena* arena) {
+	ASSERT(arena != NULL, "Arena is null");
+	vec_construct(&arena->chunks);
+	arena->chunk_used = 0;
+	arena->chunk_size = 0;
+	arena->bytes_used = 0;
+	arena->bytes_reserved = 0;
+}
+
+void arena_destruct(Arena* arena) {
+	ASSERT(arena != NULL, "Arena is null");
+	for (int i = 0; i < vec_size(&arena->chunks); ++i) {
+		cfree(vec_at(&arena->chunks, i));
+	}
+	vec_destruct(&arena->chunks);
+}
+
+void* arena_alloc(Arena* arena, size_t bytes) {
+	ASSERT(arena != NULL, "Arena is null");
+	bytes = (bytes + ARENA_ALIGN - 1) & ~(ARENA_ALIGN - 1);
+
+	if (arena->chunk_used + bytes > arena->chunk_size) {
+		size_t size = bytes > ARENA_CHUNK_SIZE ? bytes : ARENA_CHUNK_SIZE;
+		char* chunk = cmalloc(size);
+		if (chunk == NULL) return NULL;
+		if (!vec_push_back(&arena->chunks, chunk)) {
+			cfree(chunk);
+			return NULL;
+		}
+		arena->chunk_used = 0;
+		arena->chunk_size = size;
+		arena->bytes_reserved += size;
+	}
+
+	void* ptr = vec_back(&arena->chunks) + arena->chunk_used;
+	arena->chunk_used += bytes;
+	arena->bytes_used += bytes;
+	return ptr;
+}
+
+int arena_chunk_count(const Arena* arena) {
+	ASSERT(arena != NULL, "Arena is null");
+	return vec_size(&arena->chunks);
+}
@@ -0,0 +1,39 @@
+/* Bump allocator
+   Memory is handed out from large chunks and is only freed when the
+   arena is destructed */
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+#include "errorcode.h"
+#include "vec.h"
+
+/* Size of chunk allocated by the arena, allocations larger than this
+   are given their own chunk */
+#define ARENA_CHUNK_SIZE 65536
+
+typedef struct
+{
+	vec_t(char*) chunks;
+	size_t chunk_used; /* Bytes used in last chunk */
+	size_t chunk_size; /* Bytes in last chunk */
+
+	/* Bytes handed out and bytes in chunks */
+	size_t bytes_used;
+	size_t bytes_reserved;
+} Arena;
+
+void arena_construct(Arena* arena);
+
+/* Frees all memory allocated from the arena */
+void arena_destruct(Arena* arena);
+
+/* Allocates bytes from the arena, aligned for any type
+   Returns NULL if out of memory */
+void* arena_alloc(Arena* arena, size_t bytes);
+
+/* Returns number of chunks allocated by the arena */
+int arena_chunk_count(const Arena* arena);
+
+#endif
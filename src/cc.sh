@@ -56,8 +56,13 @@ if [ ${#input_files[@]} -eq 0 ]; then
     exit 2
 elif [ ${#input_files[@]} -eq 1 ]; then
     file=${input_files[0]}
-    gcc -E -x c               "${pp_flags[@]}"    "$file"                   -o "$(dirname "$file")/imm1"  || fail "Preprocessor error"       5
-    "$(dirname "$0")/parse"   "${parse_flags[@]}" "$(dirname "$file")/imm1" -o "$(dirname "$file")/imm2"  || fail "Parser error"             6
+    # Preprocessor output is piped into the parser, the preprocessor is
+    # terminated by SIGPIPE (status 141) if the parser exits early
+    gcc -E -x c               "${pp_flags[@]}"    "$file"                   -o -                        |
+    "$(dirname "$0")/parse"   "${parse_flags[@]}" -                         -o "$(dirname "$file")/imm2"
+    status=("${PIPESTATUS[@]}")
+    [ "${status[0]}" -eq 0 ] || [ "${status[0]}" -eq 141 ]                                                || fail "Preprocessor error"       5
+    [ "${status[1]}" -eq 0 ]                                                                              || fail "Parser error"             6
     "$(dirname "$0")/asmgen"  "${ag_flags[@]}"    "$(dirname "$file")/imm2" -o "$(dirname "$file")/imm3"  || fail "Assembly generator error" 7
     nasm -felf64              "${asm_flags[@]}"   "$(dirname "$file")/imm3" -o "$(dirname "$file")/imm4"  || fail "Assembler error"          8
     ld                        "${ln_flags[@]}"    "$(dirname "$file")/imm4" -o "$(dirname "$file")/a.out" || fail "Linker error"             9
@@ -8,6 +8,7 @@ ErrorCode block_construct(Block* blk) {
 	vec_construct(&blk->il_stats);
 	blk->next[0] = 0;
 	blk->next[1] = 0;
+	blk->next_count = 0;
 	return ec_noerr;
 }
 
@@ -53,16 +54,50 @@ ErrorCode block_add_ilstat(Block* blk, IL2Statement stat) {
 	return ec_noerr;
 }
 
+void block_remove_ilstat(Block* blk, int i) {
+	ASSERT(blk != NULL, "Block is null");
+	ASSERT(i >= 0, "Index out of range");
+	ASSERT(i < block_ilstat_count(blk), "Index out of range");
+	vec_splice(&blk->il_stats, i, 1);
+}
+
+void block_compact(Block* blk) {
+	ASSERT(blk != NULL, "Block is null");
+	int count = 0;
+	for (int i = 0; i < vec_size(&blk->il_stats); ++i) {
+		if (il2stat_ins(&vec_at(&blk->il_stats, i)) == il2_none) continue;
+		vec_at(&blk->il_stats, count++) = vec_at(&blk->il_stats, i);
+	}
+	vec_splice(&blk->il_stats, count, vec_size(&blk->il_stats) - count);
+}
+
+void block_clear(Block* blk) {
+	ASSERT(blk != NULL, "Block is null");
+	vec_clear(&blk->labels);
+	vec_clear(&blk->il_stats);
+	blk->next_count = 0;
+}
+
 void block_link(Block* blk, Block* next) {
 	ASSERT(blk != NULL, "Block is null");
-	ASSERT(blk != next, "Cannot link block to self");
-	for (int i = 0; i < MAX_BLOCK_LINK; ++i) {
-		if (blk->next[i] == 0) {
-			blk->next[i] = (int)(next - blk);
-			return;
-		}
+	ASSERT(blk->next_count < MAX_BLOCK_LINK, "Too many links out of block");
+	blk->next[blk->next_count] = (int)(next - blk);
+	++blk->next_count;
+}
+
+void block_unlink(Block* blk, int i) {
+	ASSERT(blk != NULL, "Block is null");
+	ASSERT(i >= 0, "Index out of range");
+	ASSERT(i < blk->next_count, "Index out of range");
+	for (; i + 1 < blk->next_count; ++i) {
+		blk->next[i] = blk->next[i + 1];
 	}
-	ASSERT(0, "Too many links out of block");
+	--blk->next_count;
+}
+
+int block_next_count(Block* blk) {
+	ASSERT(blk != NULL, "Block is null");
+	return blk->next_count;
 }
 
 Block* block_next(Block* blk, int i) {
@@ -70,7 +105,7 @@ Block* block_next(Block* blk, int i) {
 	ASSERT(i >= 0, "Index out of range");
 	ASSERT(i < MAX_BLOCK_LINK, "Index out of range");
 
-	if (blk->next[i] == 0) {
+	if (i >= blk->next_count) {
 		return NULL;
 	}
 	return blk + blk->next[i];
@@ -78,11 +113,13 @@ Block* block_next(Block* blk, int i) {
 
 ErrorCode cfg_construct(Cfg* cfg) {
 	vec_construct(&cfg->blocks);
+	vec_construct(&cfg->labels);
 	return ec_noerr;
 }
 
 void cfg_destruct(Cfg* cfg) {
 	cfg_clear(cfg);
+	vec_destruct(&cfg->labels);
 	vec_destruct(&cfg->blocks);
 }
 
@@ -91,6 +128,7 @@ void cfg_clear(Cfg* cfg) {
 		block_destruct(&vec_at(&cfg->blocks, i));
 	}
 	vec_clear(&cfg->blocks);
+	vec_clear(&cfg->labels);
 }
 
 ErrorCode cfg_new_block(Cfg* cfg, Block** block_ptr) {
@@ -104,13 +142,112 @@ ErrorCode cfg_new_block(Cfg* cfg, Block** block_ptr) {
 	return ec_noerr;
 }
 
-Block* cfg_find_labelled(Cfg* cfg, Symbol* lab) {
-	for (int i = 0; i < vec_size(&cfg->blocks); ++i) {
+/* Orders labels by their Symbol* */
+static int cfg_label_cmp(const void* lhs, const void* rhs) {
+	uintptr_t lab1 = (uintptr_t)((const CfgLabel*)lhs)->lab;
+	uintptr_t lab2 = (uintptr_t)((const CfgLabel*)rhs)->lab;
+	if (lab1 < lab2) return -1;
+	if (lab1 > lab2) return 1;
+	return 0;
+}
+
+/* Returns 1 if control cannot flow past the instruction to the next
+   statement, 0 otherwise */
+static int cfg_isexit(IL2Ins ins) {
+	return ins == il2_jmp || ins == il2_ret;
+}
+
+ErrorCode cfg_partition(Cfg* cfg) {
+	ASSERT(cfg != NULL, "Cfg is null");
+	ASSERT(vec_size(&cfg->blocks) > 0, "No block to partition");
+	ErrorCode ecode;
+
+	int first = vec_size(&cfg->blocks) - 1;
+	int count = block_ilstat_count(&vec_at(&cfg->blocks, first));
+
+	/* Statements of the first block are moved towards the front in place
+	   as the lab statements are removed, statements of the other blocks
+	   are copied into them */
+	int kept = 0;
+	int curr = first;
+	int curr_count = 0;
+	int ended = 0; /* Current block ends with a jump or return */
+	for (int i = 0; i < count; ++i) {
+		IL2Statement stat = *block_ilstat(&vec_at(&cfg->blocks, first), i);
+		IL2Ins ins = il2stat_ins(&stat);
+
+		if ((ins == il2_lab && curr_count > 0) || ended) {
+			Block* new_blk;
+			if ((ecode = cfg_new_block(cfg, &new_blk)) != ec_noerr) return ecode;
+			++curr;
+			curr_count = 0;
+			ended = 0;
+		}
+
+		Block* blk = &vec_at(&cfg->blocks, curr);
+		if (ins == il2_lab) {
+			if ((ecode = block_add_label(blk, il2stat_arg(&stat, 0))) != ec_noerr) return ecode;
+			if (!vec_push_back(&cfg->labels, ((CfgLabel){il2stat_arg(&stat, 0), curr}))) return ec_badalloc;
+			continue;
+		}
+
+		if (curr == first) {
+			*block_ilstat(blk, kept) = stat;
+			++kept;
+		}
+		else {
+			if ((ecode = block_add_ilstat(blk, stat)) != ec_noerr) return ecode;
+		}
+		++curr_count;
+		ended = il2_isjump(ins) || ins == il2_ret;
+	}
+	Block* first_blk = &vec_at(&cfg->blocks, first);
+	vec_splice(&first_blk->il_stats, kept, count - kept);
+
+	if (vec_size(&cfg->labels) > 1) {
+		quicksort(vec_data(&cfg->labels), (size_t)vec_size(&cfg->labels),
+				sizeof(CfgLabel), cfg_label_cmp);
+	}
+
+	/* Link blocks, blocks do not move anymore. The blocks of the
+	   function end at end, its last block never flows into the blocks of
+	   a function partitioned after it */
+	int end = vec_size(&cfg->blocks);
+	for (int i = first; i < end; ++i) {
 		Block* blk = &vec_at(&cfg->blocks, i);
-		for (int j = 0; j < block_lab_count(blk); ++j) {
-			if (block_lab(blk, j) == lab) {
-				return blk;
-			}
+		int stat_count = block_ilstat_count(blk);
+		IL2Statement* last = stat_count > 0 ? block_ilstat(blk, stat_count - 1) : NULL;
+		IL2Ins ins = last != NULL ? il2stat_ins(last) : il2_none;
+
+		Block* next = NULL;
+		if (!cfg_isexit(ins) && i + 1 < end) {
+			next = blk + 1;
+			block_link(blk, next);
+		}
+		if (il2_isjump(ins)) {
+			Block* target = cfg_find_labelled(cfg, il2stat_arg(last, 0));
+			ASSERT(target != NULL, "Jump to label which is not in cfg");
+			/* Jump to the block after is the same as flowing through */
+			if (target != next) block_link(blk, target);
+		}
+	}
+	return ec_noerr;
+}
+
+Block* cfg_find_labelled(Cfg* cfg, Symbol* lab) {
+	int low = 0;
+	int high = vec_size(&cfg->labels) - 1;
+	while (low <= high) {
+		int mid = low + (high - low) / 2;
+		CfgLabel label = vec_at(&cfg->labels, mid);
+		if (label.lab == lab) {
+			return &vec_at(&cfg->blocks, label.block);
+		}
+		if ((uintptr_t)label.lab < (uintptr_t)lab) {
+			low = mid + 1;
+		}
+		else {
+			high = mid - 1;
 		}
 	}
 	return NULL;
@@ -150,10 +287,8 @@ void debug_print_cfg(Cfg* cfg) {
 
 		/* Print next block index */
 		LOG("    ->");
-		for (int j = 0; j < 2; ++j) {
-			if (block_next(blk, j)) {
-				LOGF(" %ld", block_next(blk, j) - vec_data(&cfg->blocks));
-			}
+		for (int j = 0; j < block_next_count(blk); ++j) {
+			LOGF(" %ld", block_next(blk, j) - vec_data(&cfg->blocks));
 		}
 		LOG("\n");
 	}
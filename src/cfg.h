@@ -21,8 +21,10 @@ typedef struct
 	   1. Flow through to next block
 	   2. Jump at end
 	   Is offset (in Block) from current location, cannot use pointer
-	   as container holding Block may resize */
+	   as container holding Block may resize
+	   A block which jumps to its own label links to itself with offset 0 */
 	int next[MAX_BLOCK_LINK];
+	int next_count;
 } Block;
 
 ErrorCode block_construct(Block* blk);
@@ -47,15 +49,42 @@ IL2Statement* block_ilstat(Block* blk, int i);
 /* Adds IL statement to block */
 ErrorCode block_add_ilstat(Block* blk, IL2Statement stat);
 
+/* Removes IL statement at index in block */
+void block_remove_ilstat(Block* blk, int i);
+
+/* Removes the IL statements with instruction il2_none from block, the
+   other statements keep their order */
+void block_compact(Block* blk);
+
+/* Removes the labels, IL statements and links of block */
+void block_clear(Block* blk);
+
 /* Links block to next block */
 void block_link(Block* blk, Block* next);
 
-/* Returns pointer to ith next block */
+/* Removes link at index from block, the links after it move down */
+void block_unlink(Block* blk, int i);
+
+/* Returns number of blocks linked to from block */
+int block_next_count(Block* blk);
+
+/* Returns pointer to ith next block, null if there is no ith link */
 Block* block_next(Block* blk, int i);
 
+/* Label of a block and the index of the block */
+typedef struct
+{
+	Symbol* lab;
+	int block;
+} CfgLabel;
+
 typedef struct
 {
 	vec_t(Block) blocks;
+
+	/* Labels of the partitioned blocks, sorted by Symbol* to find the
+	   block of a label by binary search */
+	vec_t(CfgLabel) labels;
 } Cfg;
 
 ErrorCode cfg_construct(Cfg* cfg);
@@ -69,7 +98,16 @@ void cfg_clear(Cfg* cfg);
    Block saved to provided pointer */
 ErrorCode cfg_new_block(Cfg* cfg, Block** block_ptr);
 
-/* Finds the first block which has the provided label
+/* Splits the IL2 statements of the last block into basic blocks, which
+   are added after it. A block begins at a label, or after a jump or
+   return. lab statements become the labels of the blocks, and blocks
+   are linked to the blocks control can flow to
+   The statements are those of one function, the blocks are never linked
+   to the blocks of other functions in the cfg */
+ErrorCode cfg_partition(Cfg* cfg);
+
+/* Finds the block which has the provided label, only labels of blocks
+   made by cfg_partition can be found
    Returns null if not found */
 Block* cfg_find_labelled(Cfg* cfg, Symbol* lab);
 
@@ -0,0 +1,192 @@
+#include "charscan.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)) && defined(__SSE2__)
+#define CHARSCAN_X86 1
+#include <immintrin.h>
+#else
+#define CHARSCAN_X86 0
+#endif
+
+#define O_ 0
+#define W_ (CHARSCAN_WHITESPACE | CHARSCAN_BLANK)
+#define N_ CHARSCAN_WHITESPACE
+#define P_ CHARSCAN_PUNCTUATOR
+#define I_ CHARSCAN_IDENTIFIER
+
+/* Characters 128 to 255 are other */
+const uint8_t charscan_class[256] = {
+	/*  0 */ O_, O_, O_, O_, O_, O_, O_, O_, O_, W_, N_, O_, O_, O_, O_, O_,
+	/* 16 */ O_, O_, O_, O_, O_, O_, O_, O_, O_, O_, O_, O_, O_, O_, O_, O_,
+	/*  ! " # $ % & ' ( ) * + , - . / */
+	/* 32 */ W_, P_, O_, P_, O_, P_, P_, O_, P_, P_, P_, P_, P_, P_, P_, P_,
+	/* 0 1 2 3 4 5 6 7 8 9 : ; < = > ? */
+	/* 48 */ I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, P_, P_, P_, P_, P_, P_,
+	/* @ A B C D E F G H I J K L M N O */
+	/* 64 */ O_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_,
+	/* P Q R S T U V W X Y Z [ \ ] ^ _ */
+	/* 80 */ I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, P_, O_, P_, P_, I_,
+	/* ` a b c d e f g h i j k l m n o */
+	/* 96 */ O_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_,
+	/* p q r s t u v w x y z { | } ~ */
+	/* 112 */ I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, I_, P_, P_, P_, P_, O_};
+
+#undef O_
+#undef W_
+#undef N_
+#undef P_
+#undef I_
+
+/* -1 if not yet chosen */
+static int charscan_current_level = -1;
+
+CharscanLevel charscan_level_max(void) {
+#if CHARSCAN_X86
+	if (__builtin_cpu_supports("avx2")) return charscan_avx2;
+	return charscan_sse2;
+#else
+	return charscan_scalar;
+#endif
+}
+
+void charscan_set_level(CharscanLevel level) {
+	CharscanLevel max = charscan_level_max();
+	charscan_current_level = (int)(level > max ? max : level);
+}
+
+CharscanLevel charscan_level(void) {
+	if (charscan_current_level < 0) charscan_set_level(charscan_level_max());
+	return (CharscanLevel)charscan_current_level;
+}
+
+/* Returns number of characters at start of str with any of the class bits */
+static int scan_scalar(const char* str, int len, uint8_t class_bits) {
+	int i = 0;
+	while (i < len && (charscan_class[(uint8_t)str[i]] & class_bits)) {
+		++i;
+	}
+	return i;
+}
+
+#if CHARSCAN_X86
+
+/* Each bit of mask is set for a character not part of the run,
+   returns index of first such character */
+static int first_set_bit(unsigned int mask) {
+	return __builtin_ctz(mask);
+}
+
+static int blank_sse2(const char* str, int len) {
+	const __m128i space = _mm_set1_epi8(' ');
+	const __m128i tab = _mm_set1_epi8('\t');
+
+	int i = 0;
+	while (len - i >= 16) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(str + i));
+		__m128i blank = _mm_or_si128(_mm_cmpeq_epi8(x, space), _mm_cmpeq_epi8(x, tab));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(blank) ^ 0xFFFFu;
+		if (mask != 0) return i + first_set_bit(mask);
+		i += 16;
+	}
+	return i + scan_scalar(str + i, len - i, CHARSCAN_BLANK);
+}
+
+static int identifier_sse2(const char* str, int len) {
+	/* Bytes compare as signed, characters >= 128 are negative and
+	   fall outside every range */
+	const __m128i case_bit = _mm_set1_epi8(0x20);
+	const __m128i before_a = _mm_set1_epi8('a' - 1);
+	const __m128i after_z = _mm_set1_epi8('z' + 1);
+	const __m128i before_0 = _mm_set1_epi8('0' - 1);
+	const __m128i after_9 = _mm_set1_epi8('9' + 1);
+	const __m128i underscore = _mm_set1_epi8('_');
+
+	int i = 0;
+	while (len - i >= 16) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(str + i));
+		__m128i lower = _mm_or_si128(x, case_bit);
+		__m128i alpha = _mm_and_si128(_mm_cmpgt_epi8(lower, before_a), _mm_cmpgt_epi8(after_z, lower));
+		__m128i digit = _mm_and_si128(_mm_cmpgt_epi8(x, before_0), _mm_cmpgt_epi8(after_9, x));
+		__m128i ident = _mm_or_si128(_mm_or_si128(alpha, digit), _mm_cmpeq_epi8(x, underscore));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(ident) ^ 0xFFFFu;
+		if (mask != 0) return i + first_set_bit(mask);
+		i += 16;
+	}
+	return i + scan_scalar(str + i, len - i, CHARSCAN_IDENTIFIER);
+}
+
+__attribute__((target("avx2"))) static int blank_avx2(const char* str, int len) {
+	const __m256i space = _mm256_set1_epi8(' ');
+	const __m256i tab = _mm256_set1_epi8('\t');
+
+	int i = 0;
+	while (len - i >= 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)(str + i));
+		__m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(x, space), _mm256_cmpeq_epi8(x, tab));
+		unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(blank);
+		if (mask != 0) return i + first_set_bit(mask);
+		i += 32;
+	}
+	return i + blank_sse2(str + i, len - i);
+}
+
+__attribute__((target("avx2"))) static int identifier_avx2(const char* str, int len) {
+	/* See identifier_sse2 */
+	const __m256i case_bit = _mm256_set1_epi8(0x20);
+	const __m256i before_a = _mm256_set1_epi8('a' - 1);
+	const __m256i after_z = _mm256_set1_epi8('z' + 1);
+	const __m256i before_0 = _mm256_set1_epi8('0' - 1);
+	const __m256i after_9 = _mm256_set1_epi8('9' + 1);
+	const __m256i underscore = _mm256_set1_epi8('_');
+
+	int i = 0;
+	while (len - i >= 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)(str + i));
+		__m256i lower = _mm256_or_si256(x, case_bit);
+		__m256i alpha = _mm256_and_si256(_mm256_cmpgt_epi8(lower, before_a), _mm256_cmpgt_epi8(after_z, lower));
+		__m256i digit = _mm256_and_si256(_mm256_cmpgt_epi8(x, before_0), _mm256_cmpgt_epi8(after_9, x));
+		__m256i ident = _mm256_or_si256(_mm256_or_si256(alpha, digit), _mm256_cmpeq_epi8(x, underscore));
+		unsigned int mask = ~(unsigned int)_mm256_movemask_epi8(ident);
+		if (mask != 0) return i + first_set_bit(mask);
+		i += 32;
+	}
+	return i + identifier_sse2(str + i, len - i);
+}
+
+#endif
+
+/* Runs of up to this many characters are scanned without vectors, short
+   runs are common (e.g., a single space between tokens) and do not make
+   up for the setup of the vectors */
+#define CHARSCAN_SHORT_RUN 4
+
+int charscan_blank(const char* str, int len) {
+	int i = scan_scalar(str, len < CHARSCAN_SHORT_RUN ? len : CHARSCAN_SHORT_RUN, CHARSCAN_BLANK);
+	if (i < CHARSCAN_SHORT_RUN) return i;
+
+	switch (charscan_level()) {
+#if CHARSCAN_X86
+	case charscan_avx2:
+		return i + blank_avx2(str + i, len - i);
+	case charscan_sse2:
+		return i + blank_sse2(str + i, len - i);
+#endif
+	default:
+		return i + scan_scalar(str + i, len - i, CHARSCAN_BLANK);
+	}
+}
+
+int charscan_identifier(const char* str, int len) {
+	int i = scan_scalar(str, len < CHARSCAN_SHORT_RUN ? len : CHARSCAN_SHORT_RUN, CHARSCAN_IDENTIFIER);
+	if (i < CHARSCAN_SHORT_RUN) return i;
+
+	switch (charscan_level()) {
+#if CHARSCAN_X86
+	case charscan_avx2:
+		return i + identifier_avx2(str + i, len - i);
+	case charscan_sse2:
+		return i + identifier_sse2(str + i, len - i);
+#endif
+	default:
+		return i + scan_scalar(str + i, len - i, CHARSCAN_IDENTIFIER);
+	}
+}
@@ -0,0 +1,45 @@
+/* Character classification and scanning of character runs
+   Runs are scanned 16 or 32 bytes at a time when SSE2 or AVX2 is
+   available, with a scalar fallback */
+#ifndef CHARSCAN_H
+#define CHARSCAN_H
+
+#include <stdint.h>
+
+/* Bits of charscan_class */
+#define CHARSCAN_WHITESPACE 1 /* Space, tab, newline */
+#define CHARSCAN_BLANK      2 /* Space, tab */
+#define CHARSCAN_PUNCTUATOR 4 /* Character which is part of a punctuator */
+#define CHARSCAN_IDENTIFIER 8 /* Letter, digit, underscore */
+
+/* Class of each character, indexed by the character as unsigned char */
+extern const uint8_t charscan_class[256];
+
+typedef enum
+{
+	charscan_scalar = 0,
+	charscan_sse2,
+	charscan_avx2
+} CharscanLevel;
+
+/* Returns the highest level supported by the compiler and processor */
+CharscanLevel charscan_level_max(void);
+
+/* Sets the level used for scanning, clamped to charscan_level_max()
+   Defaults to charscan_level_max() */
+void charscan_set_level(CharscanLevel level);
+
+/* Returns the level used for scanning
+   The level is chosen on the first call, which is not thread safe, it
+   must happen before threads scan */
+CharscanLevel charscan_level(void);
+
+/* Returns the number of characters at the start of str which are blank,
+   reads at most len characters */
+int charscan_blank(const char* str, int len);
+
+/* Returns the number of characters at the start of str which are
+   identifier characters, reads at most len characters */
+int charscan_identifier(const char* str, int len);
+
+#endif
@@ -255,9 +255,9 @@ static inline int strtoi2(const char* str, int len) {
 	int str1len__ = strlength(str1__);        \
 	int str2len__ = strlength(str2__);        \
 	int buflen__ = str1len__ + str2len__ + 1; \
-	char buf[buflen__];                       \
-	strcopy(str1__, buf);                     \
-	strcopy(str2__, buf + str1len__)
+	char name__[buflen__];                    \
+	strcopy(str1__, name__);                  \
+	strcopy(str2__, name__ + str1len__)
 
 /* Raises integer base to positive integer exponent */
 static inline int64_t powip(int base, unsigned exponent) {
@@ -0,0 +1,229 @@
+#include "copyprop.h"
+
+#include "common.h"
+#include "type.h"
+
+ErrorCode copyprop_construct(CopyProp* cp) {
+	ASSERT(cp != NULL, "CopyProp is null");
+	cp->ssa = NULL;
+	vec_construct(&cp->uses);
+	vec_construct(&cp->copy);
+	return ec_noerr;
+}
+
+void copyprop_destruct(CopyProp* cp) {
+	ASSERT(cp != NULL, "CopyProp is null");
+	vec_destruct(&cp->copy);
+	vec_destruct(&cp->uses);
+}
+
+/* Returns the index of the variable sym is or is a version of, -1 if
+   none */
+static int copyprop_var(CopyProp* cp, Symbol* sym) {
+	Ssa* ssa = cp->ssa;
+	int name = (int)symbol_aux(sym) - 1;
+	if (name < 0) return -1;
+	if (name < vec_size(&ssa->var)) return name;
+	return (&svec_at(&ssa->version, name - vec_size(&ssa->var)))->var;
+}
+
+/* Returns 1 if sym is a temporary whose reads are all known, 0
+   otherwise */
+static int copyprop_temporary(CopyProp* cp, Symbol* sym) {
+	int var = copyprop_var(cp, sym);
+	if (var < 0) return 0;
+	SsaVar* v = &vec_at(&cp->ssa->var, var);
+	return !v->escaped && symbol_valcat(v->sym) == vc_nlval;
+}
+
+/* Returns 1 if sym is a temporary which is not renamed, it is assigned
+   once and only read after the assignment in the same block, 0
+   otherwise */
+static int copyprop_local(CopyProp* cp, Symbol* sym) {
+	int name = (int)symbol_aux(sym) - 1;
+	if (name < 0 || name >= vec_size(&cp->ssa->var)) return 0;
+	return !vec_at(&cp->ssa->var, name).renamed && copyprop_temporary(cp, sym);
+}
+
+/* Returns 1 if both symbols are the same variable, or versions of the
+   same variable, 0 otherwise */
+static int copyprop_same_var(CopyProp* cp, Symbol* lhs, Symbol* rhs) {
+	if (lhs == rhs) return 1;
+	int var = copyprop_var(cp, lhs);
+	return var >= 0 && var == copyprop_var(cp, rhs);
+}
+
+/* Returns 1 if the statement is a mov, or a mtc between types of the
+   same representation, 0 otherwise */
+static int copyprop_is_copy(IL2Statement* stat) {
+	IL2Ins ins = il2stat_ins(stat);
+	if (ins != il2_mov && ins != il2_mtc) return 0;
+	return type_same_representation(symbol_type(il2stat_arg(stat, 0)), symbol_type(il2stat_arg(stat, 1)));
+}
+
+/* Returns 1 if the instruction only assigns its first argument, and
+   cannot fault, 0 otherwise */
+static int copyprop_pure(IL2Ins ins) {
+	switch (ins) {
+	case il2_add:
+	case il2_sub:
+	case il2_mul:
+	case il2_ce:
+	case il2_cl:
+	case il2_cle:
+	case il2_cne:
+	case il2_not:
+	case il2_mov:
+	case il2_mtc:
+	case il2_mad:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* Returns 1 if the instruction may read or write memory through a
+   pointer, 0 otherwise */
+static int copyprop_memory(IL2Ins ins) {
+	return ins == il2_call || ins == il2_mfi || ins == il2_mti;
+}
+
+/* Counts the reads of each variable and version */
+static ErrorCode copyprop_count(CopyProp* cp) {
+	Ssa* ssa = cp->ssa;
+	int names = vec_size(&ssa->var) + svec_size(&ssa->version);
+	for (int i = 0; i < names; ++i) {
+		if (!vec_push_back(&cp->uses, 0)) return ec_badalloc;
+		if (!vec_push_back(&cp->copy, NULL)) return ec_badalloc;
+	}
+
+	for (int i = 0; i < vec_size(&ssa->rpo); ++i) {
+		int b = vec_at(&ssa->rpo, i);
+		SsaBlock* sblk = ssa_block(ssa, b);
+		for (int j = 0; j < vec_size(&sblk->phi); ++j) {
+			SsaPhi* phi = &vec_at(&sblk->phi, j);
+			for (int k = 0; k < vec_size(&sblk->pred); ++k) {
+				int name = (int)symbol_aux(vec_at(&ssa->phi_arg, phi->arg + k)) - 1;
+				if (name >= 0) ++vec_at(&cp->uses, name);
+			}
+		}
+
+		Block* blk = &vec_at(&ssa->cfg->blocks, b);
+		for (int j = 0; j < block_ilstat_count(blk); ++j) {
+			IL2Statement* stat = block_ilstat(blk, j);
+			for (int k = 0; k < il2stat_argc(stat); ++k) {
+				if (!il2stat_isuse(stat, k)) continue;
+				int name = (int)symbol_aux(stat->arg[k]) - 1;
+				if (name >= 0) ++vec_at(&cp->uses, name);
+			}
+		}
+	}
+	return ec_noerr;
+}
+
+/* Replaces the reads of temporaries which are copies in the block at
+   index blk by the temporaries they copy, then records the copies made
+   by the block */
+static void copyprop_propagate_block(CopyProp* cp, int blk) {
+	Block* block = &vec_at(&cp->ssa->cfg->blocks, blk);
+	for (int i = 0; i < block_ilstat_count(block); ++i) {
+		IL2Statement* stat = block_ilstat(block, i);
+		for (int j = 0; j < il2stat_argc(stat); ++j) {
+			/* mad reads the address, not the value */
+			if (!il2stat_isuse(stat, j) || il2stat_ins(stat) == il2_mad) continue;
+			int name = (int)symbol_aux(stat->arg[j]) - 1;
+			if (name < 0 || vec_at(&cp->copy, name) == NULL) continue;
+
+			Symbol* copy = vec_at(&cp->copy, name);
+			--vec_at(&cp->uses, name);
+			++vec_at(&cp->uses, (int)symbol_aux(copy) - 1);
+			stat->arg[j] = copy;
+		}
+
+		/* Both temporaries are local to the block, the copy is always
+		   assigned before the reads of the temporary it replaces */
+		if (!copyprop_is_copy(stat)) continue;
+		Symbol* dest = il2stat_arg(stat, 0);
+		Symbol* src = il2stat_arg(stat, 1);
+		if (copyprop_local(cp, dest) && copyprop_local(cp, src)) {
+			vec_at(&cp->copy, (int)symbol_aux(dest) - 1) = src;
+		}
+	}
+}
+
+/* Merges the copy at index i in block out of a temporary read only by
+   the copy, into the statement assigning the temporary
+   Returns 1 if merged, 0 otherwise */
+static int copyprop_merge(CopyProp* cp, Block* block, int i) {
+	IL2Statement* stat = block_ilstat(block, i);
+	if (!copyprop_is_copy(stat)) return 0;
+	Symbol* dest = il2stat_arg(stat, 0);
+	Symbol* src = il2stat_arg(stat, 1);
+	if (symbol_class(dest) != sl_normal) return 0;
+	if (!copyprop_local(cp, src) || vec_at(&cp->uses, (int)symbol_aux(src) - 1) != 1) return 0;
+
+	/* dest is assigned earlier, nothing in between may read or write it */
+	for (int j = i - 1; j >= 0; --j) {
+		IL2Statement* prev = block_ilstat(block, j);
+		IL2Ins ins = il2stat_ins(prev);
+		if (ins == il2_none) continue;
+		if (il2_isdef(ins) && il2stat_arg(prev, 0) == src) {
+			prev->arg[0] = dest;
+			stat->ins = il2_none;
+			vec_at(&cp->uses, (int)symbol_aux(src) - 1) = 0;
+			return 1;
+		}
+		if (copyprop_memory(ins)) return 0;
+		for (int k = 0; k < il2stat_argc(prev); ++k) {
+			if (copyprop_same_var(cp, il2stat_arg(prev, k), dest)) return 0;
+		}
+	}
+	return 0;
+}
+
+/* Removes the statements of the block at index blk assigning to
+   temporaries which are not read, then merges copies into the
+   statements they copy */
+static void copyprop_sweep_block(CopyProp* cp, int blk) {
+	Block* block = &vec_at(&cp->ssa->cfg->blocks, blk);
+	for (int i = block_ilstat_count(block) - 1; i >= 0; --i) {
+		IL2Statement* stat = block_ilstat(block, i);
+		IL2Ins ins = il2stat_ins(stat);
+		if (!copyprop_pure(ins) || !copyprop_temporary(cp, il2stat_arg(stat, 0))) continue;
+		if (vec_at(&cp->uses, (int)symbol_aux(il2stat_arg(stat, 0)) - 1) != 0) continue;
+
+		for (int j = 1; j < il2stat_argc(stat); ++j) {
+			int name = (int)symbol_aux(stat->arg[j]) - 1;
+			if (name >= 0) --vec_at(&cp->uses, name);
+		}
+		stat->ins = il2_none;
+	}
+	/* The temporaries merged are local to the block, the uses left are
+	   all known */
+	for (int i = block_ilstat_count(block) - 1; i >= 0; --i) {
+		copyprop_merge(cp, block, i);
+	}
+	block_compact(block);
+}
+
+ErrorCode copyprop_run(CopyProp* cp, Ssa* ssa) {
+	ASSERT(cp != NULL, "CopyProp is null");
+	ASSERT(ssa != NULL, "Ssa is null");
+	ASSERT(ssa->cfg != NULL, "Ssa holds no cfg");
+	ErrorCode ecode;
+
+	cp->ssa = ssa;
+	vec_clear(&cp->uses);
+	vec_clear(&cp->copy);
+	if ((ecode = copyprop_count(cp)) != ec_noerr) return ecode;
+
+	for (int i = 0; i < vec_size(&ssa->rpo); ++i) {
+		copyprop_propagate_block(cp, vec_at(&ssa->rpo, i));
+	}
+	/* The reads of a temporary are usually after it in reverse
+	   postorder, so they are removed first */
+	for (int i = vec_size(&ssa->rpo) - 1; i >= 0; --i) {
+		copyprop_sweep_block(cp, vec_at(&ssa->rpo, i));
+	}
+	return ec_noerr;
+}
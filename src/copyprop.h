@@ -0,0 +1,38 @@
+/* Copy propagation and dead temporary elimination over the SSA form of
+   the IL2 in a Cfg */
+#ifndef COPYPROP_H
+#define COPYPROP_H
+
+#include "errorcode.h"
+#include "ssa.h"
+#include "symbol.h"
+#include "vec.h"
+
+/* The IL2 generated for expressions moves every result through a new
+   temporary, and converts with mtc between types which are the same
+   once written, e.g., int and long
+
+   A temporary which is a copy of another temporary, by a mov or by a
+   mtc between types of the same representation, is replaced by the
+   temporary it copies. Then in a backward sweep, statements assigning
+   to temporaries nothing reads are removed, and a mov out of a
+   temporary read once is merged into the statement computing the
+   temporary */
+typedef struct
+{
+	Ssa* ssa;
+
+	/* Indexed by the aux of a variable or version minus 1, see Ssa */
+	vec_t(int) uses;      /* Number of arguments of statements and phis reading it */
+	vec_t(Symbol*) copy; /* Temporary it is a copy of, null if none */
+} CopyProp;
+
+ErrorCode copyprop_construct(CopyProp* cp);
+
+void copyprop_destruct(CopyProp* cp);
+
+/* Propagates the copies in the cfg ssa holds and removes the dead
+   temporaries, the cfg stays in SSA form */
+ErrorCode copyprop_run(CopyProp* cp, Ssa* ssa);
+
+#endif
@@ -4,22 +4,24 @@
 
 /* pbufexceed: Parser buffer exceeded
    fileposfailed: Change file position indicator failed */
-#define ERROR_CODES                \
-	ERROR_CODE(noerr)              \
-                                   \
-	ERROR_CODE(lexer_tokbufexceed) \
-	ERROR_CODE(lexer_fopenfail)    \
-                                   \
-	ERROR_CODE(symbol_nametoolong) \
-                                   \
-	ERROR_CODE(symtab_dupname)     \
-                                   \
-	ERROR_CODE(tnode_childexceed)  \
-                                   \
-	ERROR_CODE(badalloc)           \
-	ERROR_CODE(badclioption)       \
-	ERROR_CODE(syntaxerr)          \
-	ERROR_CODE(writefailed)        \
+#define ERROR_CODES                  \
+	ERROR_CODE(noerr)                \
+                                     \
+	ERROR_CODE(lexer_tokbufexceed)   \
+	ERROR_CODE(lexer_fopenfail)      \
+	ERROR_CODE(lexer_readfailed)     \
+	ERROR_CODE(lexer_locunavailable) \
+                                     \
+	ERROR_CODE(symbol_nametoolong)   \
+                                     \
+	ERROR_CODE(symtab_dupname)       \
+                                     \
+	ERROR_CODE(tnode_childexceed)    \
+                                     \
+	ERROR_CODE(badalloc)             \
+	ERROR_CODE(badclioption)         \
+	ERROR_CODE(syntaxerr)            \
+	ERROR_CODE(writefailed)          \
 	ERROR_CODE(fileposfailed)
 
 /* Should always be initialized to ec_noerr */
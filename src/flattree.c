@@ -0,0 +1,85 @@
+#include "flattree.h"
+
+#include "common.h"
+
+/* Node of the tree whose children are yet to be copied, and the index
+   its copy is at */
+typedef struct
+{
+	TNode* node;
+	FNodeId id;
+} FlattenEntry;
+
+/* Copies type, data and child count of node to id, children are
+   filled in later */
+static void flatten_copy(FlatTree* ftree, FNodeId id, TNode* node) {
+	FNode* fnode = &vec_at(&ftree->nodes, id);
+	fnode->data = *tnode_data(node);
+	fnode->type = tnode_type(node);
+	fnode->child_count = (uint32_t)tnode_count_child(node);
+	fnode->first_child = 0;
+}
+
+ErrorCode flat_tree_construct(FlatTree* ftree, Tree* tree) {
+	ASSERT(ftree != NULL, "Flat tree is null");
+	ASSERT(tree != NULL, "Tree is null");
+	ErrorCode ecode = ec_noerr;
+
+	vec_construct(&ftree->nodes);
+
+	/* Depth first with a stack, so deep trees do not overflow the call
+	   stack. The children of a node are given consecutive indices when
+	   the node is popped, so the children of the first child follow
+	   shortly after */
+	vec_t(FlattenEntry) stack;
+	vec_construct(&stack);
+
+	if (!vec_push_backu(&ftree->nodes)) goto badalloc;
+	flatten_copy(ftree, 0, tree_root(tree));
+	FlattenEntry root = {tree_root(tree), 0};
+	if (!vec_push_back(&stack, root)) goto badalloc;
+
+	while (!vec_empty(&stack)) {
+		FlattenEntry entry = vec_pop_back(&stack);
+		int child_count = tnode_count_child(entry.node);
+		if (child_count == 0) continue;
+
+		FNodeId first_child = (FNodeId)vec_size(&ftree->nodes);
+		int size = vec_size(&ftree->nodes) + child_count;
+		if (size > ftree->nodes.capacity) {
+			int capacity = ftree->nodes.capacity * 2;
+			if (!vec_reserve(&ftree->nodes, size > capacity ? size : capacity)) goto badalloc;
+		}
+		vec_size(&ftree->nodes) = size;
+		vec_at(&ftree->nodes, entry.id).first_child = first_child;
+
+		for (int i = 0; i < child_count; ++i) {
+			flatten_copy(ftree, first_child + (FNodeId)i, tnode_child(entry.node, i));
+		}
+		/* Pushed in reverse so the first child is visited first */
+		for (int i = child_count - 1; i >= 0; --i) {
+			FlattenEntry child = {tnode_child(entry.node, i), first_child + (FNodeId)i};
+			if (!vec_push_back(&stack, child)) goto badalloc;
+		}
+	}
+	goto exit;
+
+badalloc:
+	ecode = ec_badalloc;
+	vec_destruct(&ftree->nodes);
+exit:
+	vec_destruct(&stack);
+	return ecode;
+}
+
+void flat_tree_destruct(FlatTree* ftree) {
+	vec_destruct(&ftree->nodes);
+}
+
+void debug_print_flat_tree_stats(FlatTree* ftree) {
+	ASSERT(ftree != NULL, "Flat tree is null");
+	LOG("Flat tree stats:\n");
+	LOGF("  Nodes: %d\n", flat_tree_size(ftree));
+	LOGF("  Node size: %zu bytes\n", sizeof(FNode));
+	LOGF("  Memory: %zu bytes\n", (size_t)vec_size(&ftree->nodes) * sizeof(FNode));
+}
@@ -0,0 +1,78 @@
+/* Flat layout of the tree built from the program, made once parsing is
+   done for the passes which only read the tree
+   Nodes are stored in one array and refer to each other by index, the
+   children of a node are stored next to each other so visiting them
+   walks forward through memory */
+#ifndef FLATTREE_H
+#define FLATTREE_H
+
+#include <stdint.h>
+
+#include "errorcode.h"
+#include "tree.h"
+#include "vec.h"
+
+/* Index of a node in the flat tree */
+typedef uint32_t FNodeId;
+
+typedef struct
+{
+	TNodeData data;
+	TNodeType type;
+	uint32_t child_count;
+	FNodeId first_child; /* Children are at first_child to first_child + child_count - 1 */
+} FNode;
+
+typedef struct
+{
+	/* Root is at index 0 */
+	vec_t(FNode) nodes;
+} FlatTree;
+
+/* Copies the nodes of tree into flat tree
+   Data of the nodes is copied, data which points elsewhere
+   (e.g., symbols) must outlive the flat tree. tree can be destructed
+   after the flat tree is constructed */
+ErrorCode flat_tree_construct(FlatTree* ftree, Tree* tree);
+
+void flat_tree_destruct(FlatTree* ftree);
+
+/* Returns the root of the flat tree */
+static inline FNodeId flat_tree_root(const FlatTree* ftree) {
+	(void)ftree;
+	return 0;
+}
+
+/* Returns number of nodes in the flat tree */
+static inline int flat_tree_size(const FlatTree* ftree) {
+	return vec_size(&ftree->nodes);
+}
+
+/* Retrieves the type for node */
+static inline TNodeType fnode_type(const FlatTree* ftree, FNodeId node) {
+	return vec_at(&ftree->nodes, node).type;
+}
+
+/* Retrieves data for node
+   Cast into the appropriate type based on TNodeType */
+static inline TNodeData* fnode_data(const FlatTree* ftree, FNodeId node) {
+	return &vec_at(&ftree->nodes, node).data;
+}
+
+/* Counts number of children for given node */
+static inline int fnode_count_child(const FlatTree* ftree, FNodeId node) {
+	return (int)vec_at(&ftree->nodes, node).child_count;
+}
+
+/* Retrieves the child at index for node
+   negative to index backwards (-1 means last child, -2 second last) */
+static inline FNodeId fnode_child(const FlatTree* ftree, FNodeId node, int i) {
+	const FNode* fnode = &vec_at(&ftree->nodes, node);
+	if (i < 0) i += (int)fnode->child_count;
+	return fnode->first_child + (FNodeId)i;
+}
+
+/* Prints out the memory used by the flat tree */
+void debug_print_flat_tree_stats(FlatTree* ftree);
+
+#endif
@@ -1,4 +1,15 @@
 int g_debug_print_cfg = 0;
+int g_debug_print_dom = 0;
+int g_debug_print_lex_throughput = 0;
 int g_debug_print_parse_recursion = 0;
+int g_debug_print_parse_stats = 0;
+int g_debug_print_ssa = 0;
 int g_debug_print_tree = 0;
+int g_debug_print_tree_stats = 0;
 int g_debug_print_symtab = 0;
+int g_debug_profile_parse = 0;
+
+int g_no_optimize = 0;
+int g_parallel_lex = 0;
+int g_per_function = 0;
+int g_pretokenize = 0;
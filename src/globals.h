@@ -3,8 +3,24 @@
 #define GLOBALS_H
 
 extern int g_debug_print_cfg;
+extern int g_debug_print_dom;
+extern int g_debug_print_lex_throughput;
 extern int g_debug_print_parse_recursion;
+extern int g_debug_print_parse_stats;
+extern int g_debug_print_ssa;
 extern int g_debug_print_tree;
+extern int g_debug_print_tree_stats;
 extern int g_debug_print_symtab;
+extern int g_debug_profile_parse;
+
+/* Write the IL2 as generated, without converting it to SSA form and
+   optimizing it */
+extern int g_no_optimize;
+/* Lex the entire input file before parsing */
+extern int g_pretokenize;
+/* Same as g_pretokenize, lexing on multiple threads */
+extern int g_parallel_lex;
+/* Parse, generate and write IL2 for one external declaration at a time */
+extern int g_per_function;
 
 #endif
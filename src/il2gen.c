@@ -1,47 +1,60 @@
+#include <inttypes.h>
+
 #include "il2gen.h"
 
 #include "common.h"
 
-ErrorCode il2_construct(IL2Gen* il2, Cfg* cfg, Symtab* stab, Tree* tree) {
+ErrorCode il2_construct(IL2Gen* il2, Cfg* cfg, Symtab* stab, FlatTree* ftree) {
 	il2->cfg = cfg;
 	il2->stab = stab;
-	il2->tree = tree;
+	il2->ftree = ftree;
+	vec_construct(&il2->frame);
+	vec_construct(&il2->operand);
 	return ec_noerr;
 }
 
+void il2_destruct(IL2Gen* il2) {
+	vec_destruct(&il2->frame);
+	vec_destruct(&il2->operand);
+}
+
 /* Codegen (cg) functions assume the parse tree is valid
    Those accepting Symbol** stores the Symbol* representing the result of the
-   operator at the provided location */
+   operator at the provided location
+   Code for the operands of an expression is generated by call_cg before
+   the cg_ function for the expression is called, their results are in
+   operand */
 
 /* 6.4 Lexical elements */
-static ErrorCode cg_identifier(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
-static ErrorCode cg_constant(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
+static ErrorCode cg_identifier(IL2Gen* il2, Symbol** sym, FNodeId node, Block* blk);
+static ErrorCode cg_constant(IL2Gen* il2, Symbol** sym, FNodeId node, Block* blk);
 /* 6.5 Expressions */
-static ErrorCode cg_postfix_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
-static ErrorCode cg_unary_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
-static ErrorCode cg_cast_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
-static ErrorCode cg_binary_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
-static ErrorCode cg_logical_and_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
-static ErrorCode cg_logical_or_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
-static ErrorCode cg_assignment_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk);
+static ErrorCode cg_postfix_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk);
+static ErrorCode cg_unary_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk);
+static ErrorCode cg_cast_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk);
+static ErrorCode cg_binary_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk);
+static ErrorCode cg_logical_and_expression(IL2Gen* il2, Symbol** sym, IL2GenFrame* frame, Block* blk);
+static ErrorCode cg_logical_or_expression(IL2Gen* il2, Symbol** sym, IL2GenFrame* frame, Block* blk);
+static ErrorCode cg_assignment_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk);
 /* 6.7 Declarators */
-static ErrorCode cg_declaration(IL2Gen* il2, TNode* node, Block* blk);
+static ErrorCode cg_declaration(IL2Gen* il2, FNodeId node, Block* blk);
 /* 6.8 Statements and blocks */
-static ErrorCode cg_compound_statement(IL2Gen* il2, TNode* node, Block* blk);
-static ErrorCode cg_selection_statement(IL2Gen* il2, TNode* node, Block* blk);
-static ErrorCode cg_while_statement(IL2Gen* il2, TNode* node, Block* blk);
-static ErrorCode cg_do_statement(IL2Gen* il2, TNode* node, Block* blk);
-static ErrorCode cg_for_statement(IL2Gen* il2, TNode* node, Block* blk);
-static ErrorCode cg_jump_statement(IL2Gen* il2, TNode* node, Block* blk);
+static ErrorCode cg_compound_statement(IL2Gen* il2, FNodeId node, Block* blk);
+static ErrorCode cg_selection_statement(IL2Gen* il2, FNodeId node, Block* blk);
+static ErrorCode cg_while_statement(IL2Gen* il2, FNodeId node, Block* blk);
+static ErrorCode cg_do_statement(IL2Gen* il2, FNodeId node, Block* blk);
+static ErrorCode cg_for_statement(IL2Gen* il2, FNodeId node, Block* blk);
+static ErrorCode cg_jump_statement(IL2Gen* il2, FNodeId node, Block* blk);
 /* 6.9 External definitions */
-static ErrorCode cg_function_definition(IL2Gen* il2, TNode* node);
+static ErrorCode cg_function_definition(IL2Gen* il2, FNodeId node);
 
 /* If left and right are different types, right operand is converted
    to type of left operand and the value of the provided right operand
-   is changed to a temporary which has the same type as the left operand */
+   is changed to a temporary which has the same type as the left operand
+   Types of symbols are canonical, equal types have the same handle */
 static ErrorCode cg_com_type_rtol(IL2Gen* il2, Symbol* opl, Symbol** opr, Block* blk) {
 	ErrorCode ecode;
-	if (!type_equal(symbol_type(opl), symbol_type(*opr))) {
+	if (symbol_type(opl) != symbol_type(*opr)) {
 		Symbol* promoted_sym;
 		if ((ecode = symtab_add_temporary(il2->stab, &promoted_sym, symbol_type(opl))) != ec_noerr) return ecode;
 		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_mtc, promoted_sym, *opr))) != ec_noerr) return ecode;
@@ -53,91 +66,166 @@ static ErrorCode cg_com_type_rtol(IL2Gen* il2, Symbol* opl, Symbol** opr, Block*
 /* A common type is calculated with op1 and op2, if necessary both
    are converted to the common type and the provided op1 op2 changed
    to temporaries holding op1 and op2 as common type
-   The common type is stored at the provided pointer */
-static ErrorCode cg_com_type_lr(IL2Gen* il2, Type* type_ptr, Symbol** op1, Symbol** op2, Block* blk) {
+   The handle of the canonical common type is stored at the provided pointer */
+static ErrorCode cg_com_type_lr(IL2Gen* il2, Type** type_ptr, Symbol** op1, Symbol** op2, Block* blk) {
 	ErrorCode ecode;
+	if ((ecode = typetable_common(&il2->stab->types, symbol_type(*op1), symbol_type(*op2), type_ptr)) != ec_noerr)
+		return ecode;
 
-	/* Promote types smaller than int to int */
-	Type t1;
-	Type t2;
-	if ((ecode = type_promotion(symbol_type(*op1), &t1)) != ec_noerr) goto exit1;
-	if ((ecode = type_promotion(symbol_type(*op2), &t2)) != ec_noerr) goto exit2;
-	/* Evaluate common type */
-	if ((ecode = type_common(&t1, &t2, type_ptr)) != ec_noerr) goto exit3;
-
-	if (!type_equal(symbol_type(*op1), type_ptr)) {
+	if (symbol_type(*op1) != *type_ptr) {
 		Symbol* promoted_sym;
-		if ((ecode = symtab_add_temporary(il2->stab, &promoted_sym, type_ptr)) != ec_noerr) goto exit3;
-		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_mtc, promoted_sym, *op1))) != ec_noerr) goto exit3;
+		if ((ecode = symtab_add_temporary(il2->stab, &promoted_sym, *type_ptr)) != ec_noerr) return ecode;
+		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_mtc, promoted_sym, *op1))) != ec_noerr) return ecode;
 		*op1 = promoted_sym;
 	}
-	if (!type_equal(symbol_type(*op2), type_ptr)) {
+	if (symbol_type(*op2) != *type_ptr) {
 		Symbol* promoted_sym;
-		if ((ecode = symtab_add_temporary(il2->stab, &promoted_sym, type_ptr)) != ec_noerr) goto exit3;
-		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_mtc, promoted_sym, *op2))) != ec_noerr) goto exit3;
+		if ((ecode = symtab_add_temporary(il2->stab, &promoted_sym, *type_ptr)) != ec_noerr) return ecode;
+		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_mtc, promoted_sym, *op2))) != ec_noerr) return ecode;
 		*op2 = promoted_sym;
 	}
-
-exit3:
-	type_destruct(&t2);
-exit2:
-	type_destruct(&t1);
-exit1:
-	return ecode;
+	return ec_noerr;
 }
 
-/* Calls the appropriate cg_ based on the type of the TNode type */
-static ErrorCode call_cg(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
-	ASSERT(il2 != NULL, "IL2Gen is null");
-	ASSERT(sym != NULL, "Symbol is null");
-	ASSERT(node != NULL, "TNode is null");
-	ASSERT(blk != NULL, "Block is null");
-
-	ErrorCode ecode;
-	switch (tnode_type(node)) {
+/* Returns the number of operands of expression node */
+static int cg_operand_count(IL2Gen* il2, FNodeId node) {
+	switch (fnode_type(il2->ftree, node)) {
 	case tt_identifier:
-		ecode = cg_identifier(il2, sym, node, blk);
-		break;
 	case tt_constant:
-		ecode = cg_constant(il2, sym, node, blk);
-		break;
+		return 0;
 	case tt_postfix_expression:
-		ecode = cg_postfix_expression(il2, sym, node, blk);
-		break;
 	case tt_unary_expression:
-		ecode = cg_unary_expression(il2, sym, node, blk);
-		break;
 	case tt_cast_expression:
-		ecode = cg_cast_expression(il2, sym, node, blk);
-		break;
-	case tt_binary_expression:
-		ecode = cg_binary_expression(il2, sym, node, blk);
-		break;
-	case tt_logical_and_expression:
-		ecode = cg_logical_and_expression(il2, sym, node, blk);
-		break;
-	case tt_logical_or_expression:
-		ecode = cg_logical_or_expression(il2, sym, node, blk);
-		break;
-	case tt_assignment_expression:
-		ecode = cg_assignment_expression(il2, sym, node, blk);
-		break;
+		return 1;
 	default:
-		ASSERT(0, "Unknown node type");
-		break;
+		return fnode_count_child(il2->ftree, node);
+	}
+}
+
+/* Returns operand i of expression node */
+static FNodeId cg_operand(IL2Gen* il2, FNodeId node, int i) {
+	/* Type name of the cast comes before the operand */
+	if (fnode_type(il2->ftree, node) == tt_cast_expression) i += 2;
+	return fnode_child(il2->ftree, node, i);
+}
+
+/* Called each time call_cg visits frame of a logical expression, makes
+   the labels before the first operand is generated. After an operand is
+   generated, jumps if the operand decides the result */
+static ErrorCode cg_logical_operand(IL2Gen* il2, IL2GenFrame* frame, Block* blk) {
+	ErrorCode ecode;
+	int is_and = fnode_type(il2->ftree, frame->node) == tt_logical_and_expression;
+
+	if (frame->operand == 0) {
+		/* Labels are made before the code of any operand */
+		if ((ecode = symtab_add_label(il2->stab, &frame->label_short)) != ec_noerr) return ecode;
+		if ((ecode = symtab_add_label(il2->stab, &frame->label_end)) != ec_noerr) return ecode;
+		return ec_noerr;
 	}
+
+	/* Short-circuit once the last generated operand decides the result */
+	Symbol* operand = vec_pop_back(&il2->operand);
+	IL2Ins ins = is_and ? il2_jz : il2_jnz;
+	return block_add_ilstat(blk, il2stat_make2(ins, frame->label_short, operand));
+}
+
+/* Calls the appropriate cg_ based on the type of the node
+   The expressions within node are generated depth first using the
+   frame stack, an expression is generated after its operands */
+static ErrorCode call_cg(IL2Gen* il2, Symbol** sym, FNodeId node, Block* blk) {
+	ASSERT(il2 != NULL, "IL2Gen is null");
+	ASSERT(sym != NULL, "Symbol is null");
+	ASSERT(blk != NULL, "Block is null");
+	ASSERT(vec_empty(&il2->frame), "Expression already being generated");
+
+	ErrorCode ecode = ec_noerr;
+	IL2GenFrame root = {node, 0, NULL, NULL};
+	if (!vec_push_back(&il2->frame, root)) goto badalloc;
+
+	while (!vec_empty(&il2->frame)) {
+		IL2GenFrame* frame = &vec_back(&il2->frame);
+		TNodeType type = fnode_type(il2->ftree, frame->node);
+		int is_logical = type == tt_logical_and_expression || type == tt_logical_or_expression;
+
+		if (is_logical) {
+			if ((ecode = cg_logical_operand(il2, frame, blk)) != ec_noerr) goto exit;
+		}
+
+		/* Generate the next operand */
+		int operand_count = cg_operand_count(il2, frame->node);
+		if (frame->operand < operand_count) {
+			IL2GenFrame child = {cg_operand(il2, frame->node, frame->operand), 0, NULL, NULL};
+			++frame->operand;
+			if (!vec_push_back(&il2->frame, child)) goto badalloc;
+			continue;
+		}
+
+		/* All operands generated, operands of logical expressions were
+		   consumed as they were generated */
+		if (is_logical) operand_count = 0;
+		Symbol** operand = &vec_at(&il2->operand, vec_size(&il2->operand) - operand_count);
+
+		Symbol* result;
+		switch (type) {
+		case tt_identifier:
+			ecode = cg_identifier(il2, &result, frame->node, blk);
+			break;
+		case tt_constant:
+			ecode = cg_constant(il2, &result, frame->node, blk);
+			break;
+		case tt_postfix_expression:
+			ecode = cg_postfix_expression(il2, &result, frame->node, operand, blk);
+			break;
+		case tt_unary_expression:
+			ecode = cg_unary_expression(il2, &result, frame->node, operand, blk);
+			break;
+		case tt_cast_expression:
+			ecode = cg_cast_expression(il2, &result, frame->node, operand, blk);
+			break;
+		case tt_binary_expression:
+			ecode = cg_binary_expression(il2, &result, frame->node, operand, blk);
+			break;
+		case tt_logical_and_expression:
+			ecode = cg_logical_and_expression(il2, &result, frame, blk);
+			break;
+		case tt_logical_or_expression:
+			ecode = cg_logical_or_expression(il2, &result, frame, blk);
+			break;
+		case tt_assignment_expression:
+			ecode = cg_assignment_expression(il2, &result, frame->node, operand, blk);
+			break;
+		default:
+			ASSERT(0, "Unknown node type");
+			break;
+		}
+		if (ecode != ec_noerr) goto exit;
+
+		/* Result replaces the operands */
+		vec_size(&il2->operand) -= operand_count;
+		(void)vec_pop_back(&il2->frame);
+		if (!vec_push_back(&il2->operand, result)) goto badalloc;
+	}
+
+	*sym = vec_pop_back(&il2->operand);
+	ASSERT(vec_empty(&il2->operand), "Operands left after expression");
+	goto exit;
+
+badalloc:
+	ecode = ec_badalloc;
+exit:
+	vec_clear(&il2->frame);
+	vec_clear(&il2->operand);
 	return ecode;
 }
 
-/* Calls the appropriate cg_ based on the type of the TNode type */
-static ErrorCode call_cgs(IL2Gen* il2, TNode* node, Block* blk) {
+/* Calls the appropriate cg_ based on the type of the node */
+static ErrorCode call_cgs(IL2Gen* il2, FNodeId node, Block* blk) {
 	ASSERT(il2 != NULL, "IL2Gen is null");
-	ASSERT(node != NULL, "TNode is null");
 	ASSERT(blk != NULL, "Block is null");
 
 	ErrorCode ecode;
 	Symbol* sym; /* Not used, discards result from call_cg */
-	switch (tnode_type(node)) {
+	switch (fnode_type(il2->ftree, node)) {
 	case tt_declaration:
 		ecode = cg_declaration(il2, node, blk);
 		break;
@@ -167,26 +255,29 @@ static ErrorCode call_cgs(IL2Gen* il2, TNode* node, Block* blk) {
 	return ecode;
 }
 
-static ErrorCode cg_identifier(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
-	TNodeIdentifier* data = (TNodeIdentifier*)tnode_data(node);
+static ErrorCode cg_identifier(IL2Gen* il2, Symbol** sym, FNodeId node, Block* blk) {
+	TNodeIdentifier* data = (TNodeIdentifier*)fnode_data(il2->ftree, node);
 	*sym = data->symbol;
 	return ec_noerr;
 }
 
-static ErrorCode cg_constant(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
-	TNodeConstant* data = (TNodeConstant*)tnode_data(node);
+static ErrorCode cg_constant(IL2Gen* il2, Symbol** sym, FNodeId node, Block* blk) {
+	TNodeConstant* data = (TNodeConstant*)fnode_data(il2->ftree, node);
 	*sym = data->symbol;
 	return ec_noerr;
 }
 
-static ErrorCode cg_postfix_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
+static ErrorCode cg_postfix_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk) {
 	ErrorCode ecode;
 
-	TNodePostfixExpression* data = (TNodePostfixExpression*)tnode_data(node);
-	TNode* child = tnode_child(node, 0);
+	TNodePostfixExpression* data = (TNodePostfixExpression*)fnode_data(il2->ftree, node);
+	Symbol* result = operand[0];
 
-	Symbol* result;
-	if ((ecode = call_cg(il2, &result, child, blk)) != ec_noerr) return ecode;
+	/* No IL2 exists for calls, the result would be left unassigned */
+	if (data->type == TNodePostfixExpression_call) {
+		ERRMSG("Function calls are not supported\n");
+		return ec_syntaxerr;
+	}
 
 	if ((ecode = symtab_add_temporary(il2->stab, sym, symbol_type(result))) != ec_noerr) return ecode;
 
@@ -211,11 +302,6 @@ static ErrorCode cg_postfix_expression(IL2Gen* il2, Symbol** sym, TNode* node, B
 			ec_noerr)
 			return ecode;
 	} break;
-	case TNodePostfixExpression_call:
-	{
-		/* TODO */
-		break;
-	}
 	default:
 		ASSERT(0, "Unknown node type");
 		break;
@@ -223,13 +309,10 @@ static ErrorCode cg_postfix_expression(IL2Gen* il2, Symbol** sym, TNode* node, B
 	return ecode;
 }
 
-static ErrorCode cg_unary_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
+static ErrorCode cg_unary_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk) {
 	ErrorCode ecode;
-	TNodeUnaryExpression* data = (TNodeUnaryExpression*)tnode_data(node);
-	TNode* child = tnode_child(node, 0);
-
-	Symbol* child_result;
-	if ((ecode = call_cg(il2, &child_result, child, blk)) != ec_noerr) return ecode;
+	TNodeUnaryExpression* data = (TNodeUnaryExpression*)fnode_data(il2->ftree, node);
+	Symbol* child_result = operand[0];
 
 	if ((ecode = symtab_add_temporary(il2->stab, sym, symbol_type(child_result))) != ec_noerr) return ecode;
 
@@ -266,41 +349,35 @@ static ErrorCode cg_unary_expression(IL2Gen* il2, Symbol** sym, TNode* node, Blo
 	return ec_noerr;
 }
 
-static ErrorCode cg_cast_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
+static ErrorCode cg_cast_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk) {
 	ErrorCode ecode;
-	TNodeDeclarationSpecifiers* declspec = (TNodeDeclarationSpecifiers*)tnode_data(tnode_child(node, 0));
-	TNodePointer* pointer = (TNodePointer*)tnode_data(tnode_child(node, 1));
-	TNode* expr = tnode_child(node, 2);
-
-	if ((ecode = call_cg(il2, sym, expr, blk)) != ec_noerr) goto exit1;
+	TNodeDeclarationSpecifiers* declspec = (TNodeDeclarationSpecifiers*)fnode_data(il2->ftree, fnode_child(il2->ftree, node, 0));
+	TNodePointer* pointer = (TNodePointer*)fnode_data(il2->ftree, fnode_child(il2->ftree, node, 1));
+	*sym = operand[0];
 
 	Type type;
-	if ((ecode = type_construct(&type, declspec->ts, pointer->pointers)) != ec_noerr) goto exit1;
+	if ((ecode = type_construct(&type, declspec->ts, pointer->pointers)) != ec_noerr) return ecode;
+	Type* cast_type;
+	ecode = typetable_intern(&il2->stab->types, &type, &cast_type);
+	type_destruct(&type);
+	if (ecode != ec_noerr) return ecode;
 
-	if (!type_equal(&type, symbol_type(*sym))) {
+	if (cast_type != symbol_type(*sym)) {
 		Symbol* expr_result = *sym;
-		if ((ecode = symtab_add_temporary(il2->stab, sym, &type)) != ec_noerr) goto exit2;
-		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_mtc, *sym, expr_result))) != ec_noerr) goto exit2;
+		if ((ecode = symtab_add_temporary(il2->stab, sym, cast_type)) != ec_noerr) return ecode;
+		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_mtc, *sym, expr_result))) != ec_noerr) return ecode;
 	}
-
-exit2:
-	type_destruct(&type);
-exit1:
-	return ecode;
+	return ec_noerr;
 }
 
-static ErrorCode cg_binary_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
+static ErrorCode cg_binary_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk) {
 	ErrorCode ecode;
-	TNodeBinaryExpression* data = (TNodeBinaryExpression*)tnode_data(node);
-	TNode* lchild = tnode_child(node, 0);
-	TNode* rchild = tnode_child(node, 1);
-
-	Symbol* lresult;
-	if ((ecode = call_cg(il2, &lresult, lchild, blk)) != ec_noerr) return ecode;
-
-	Symbol* rresult;
-	if ((ecode = call_cg(il2, &rresult, rchild, blk)) != ec_noerr) return ecode;
+	TNodeBinaryExpression* data = (TNodeBinaryExpression*)fnode_data(il2->ftree, node);
+	Symbol* lresult = operand[0];
+	Symbol* rresult = operand[1];
 
+	Type* com_type;
+	if ((ecode = cg_com_type_lr(il2, &com_type, &lresult, &rresult, blk)) != ec_noerr) return ecode;
 	switch (data->type) {
 	/* Relational and equality operators always have int as their result */
 	case TNodeBinaryExpression_l:
@@ -312,13 +389,8 @@ static ErrorCode cg_binary_expression(IL2Gen* il2, Symbol** sym, TNode* node, Bl
 		if ((ecode = symtab_add_temporary(il2->stab, sym, symtab_type_int(il2->stab))) != ec_noerr) return ecode;
 		break;
 	default:
-	{
-		Type com_type;
-		if ((ecode = cg_com_type_lr(il2, &com_type, &lresult, &rresult, blk)) != ec_noerr) return ecode;
-		ecode = symtab_add_temporary(il2->stab, sym, &com_type);
-		type_destruct(&com_type);
-		if (ecode != ec_noerr) return ecode;
-	} break;
+		if ((ecode = symtab_add_temporary(il2->stab, sym, com_type)) != ec_noerr) return ecode;
+		break;
 	}
 
 
@@ -363,26 +435,13 @@ static ErrorCode cg_binary_expression(IL2Gen* il2, Symbol** sym, TNode* node, Bl
 	return ecode;
 }
 
-static ErrorCode cg_logical_and_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
+static ErrorCode cg_logical_and_expression(IL2Gen* il2, Symbol** sym, IL2GenFrame* frame, Block* blk) {
 	ErrorCode ecode;
 
-	/* Short-circuit logical and */
-
-	Symbol* label_false;
-	Symbol* label_end;
-	if ((ecode = symtab_add_label(il2->stab, &label_false)) != ec_noerr) return ecode;
-	;
-	if ((ecode = symtab_add_label(il2->stab, &label_end)) != ec_noerr) return ecode;
-	;
-
-	for (int i = 0; i < tnode_count_child(node); ++i) {
-		TNode* child = tnode_child(node, i);
-
-		Symbol* child_result;
-		if ((ecode = call_cg(il2, &child_result, child, blk)) != ec_noerr) return ecode;
-
-		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_jz, label_false, child_result))) != ec_noerr) return ecode;
-	}
+	/* Short-circuit logical and, the operands jump to label_false when
+	   zero (see cg_logical_operand) */
+	Symbol* label_false = frame->label_short;
+	Symbol* label_end = frame->label_end;
 
 	if ((ecode = symtab_add_temporary(il2->stab, sym, symtab_type_int(il2->stab))) != ec_noerr) return ecode;
 
@@ -401,26 +460,13 @@ static ErrorCode cg_logical_and_expression(IL2Gen* il2, Symbol** sym, TNode* nod
 	return ec_noerr;
 }
 
-static ErrorCode cg_logical_or_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
+static ErrorCode cg_logical_or_expression(IL2Gen* il2, Symbol** sym, IL2GenFrame* frame, Block* blk) {
 	ErrorCode ecode;
 
-	/* Short-circuit logical or */
-
-	Symbol* label_true;
-	Symbol* label_end;
-	if ((ecode = symtab_add_label(il2->stab, &label_true)) != ec_noerr) return ecode;
-	;
-	if ((ecode = symtab_add_label(il2->stab, &label_end)) != ec_noerr) return ecode;
-	;
-
-	for (int i = 0; i < tnode_count_child(node); ++i) {
-		TNode* child = tnode_child(node, i);
-
-		Symbol* child_result;
-		if ((ecode = call_cg(il2, &child_result, child, blk)) != ec_noerr) return ecode;
-
-		if ((ecode = block_add_ilstat(blk, il2stat_make2(il2_jnz, label_true, child_result))) != ec_noerr) return ecode;
-	}
+	/* Short-circuit logical or, the operands jump to label_true when
+	   non-zero (see cg_logical_operand) */
+	Symbol* label_true = frame->label_short;
+	Symbol* label_end = frame->label_end;
 
 	if ((ecode = symtab_add_temporary(il2->stab, sym, symtab_type_int(il2->stab))) != ec_noerr) return ecode;
 
@@ -439,17 +485,11 @@ static ErrorCode cg_logical_or_expression(IL2Gen* il2, Symbol** sym, TNode* node
 	return ec_noerr;
 }
 
-static ErrorCode cg_assignment_expression(IL2Gen* il2, Symbol** sym, TNode* node, Block* blk) {
+static ErrorCode cg_assignment_expression(IL2Gen* il2, Symbol** sym, FNodeId node, Symbol** operand, Block* blk) {
 	ErrorCode ecode;
-	TNodeAssignmentExpression* data = (TNodeAssignmentExpression*)tnode_data(node);
-	TNode* lchild = tnode_child(node, 0);
-	TNode* rchild = tnode_child(node, 1);
-
-	Symbol* lresult;
-	if ((ecode = call_cg(il2, &lresult, lchild, blk)) != ec_noerr) return ecode;
-
-	Symbol* rresult;
-	if ((ecode = call_cg(il2, &rresult, rchild, blk)) != ec_noerr) return ecode;
+	TNodeAssignmentExpression* data = (TNodeAssignmentExpression*)fnode_data(il2->ftree, node);
+	Symbol* lresult = operand[0];
+	Symbol* rresult = operand[1];
 
 	/* Convert right to type of left */
 	if ((ecode = cg_com_type_rtol(il2, lresult, &rresult, blk)) != ec_noerr) return ecode;
@@ -490,10 +530,10 @@ static ErrorCode cg_assignment_expression(IL2Gen* il2, Symbol** sym, TNode* node
 	return ec_noerr;
 }
 
-static ErrorCode cg_declaration(IL2Gen* il2, TNode* node, Block* blk) {
+static ErrorCode cg_declaration(IL2Gen* il2, FNodeId node, Block* blk) {
 	ErrorCode ecode;
-	TNodeIdentifier* identifier = (TNodeIdentifier*)tnode_data(tnode_child(node, 2));
-	TNode* initializer = tnode_child(node, 3);
+	TNodeIdentifier* identifier = (TNodeIdentifier*)fnode_data(il2->ftree, fnode_child(il2->ftree, node, 2));
+	FNodeId initializer = fnode_child(il2->ftree, node, 3);
 
 	Symbol* result;
 	if ((ecode = call_cg(il2, &result, initializer, blk)) != ec_noerr) return ecode;
@@ -506,16 +546,16 @@ static ErrorCode cg_declaration(IL2Gen* il2, TNode* node, Block* blk) {
 	return ec_noerr;
 }
 
-static ErrorCode cg_compound_statement(IL2Gen* il2, TNode* node, Block* blk) {
+static ErrorCode cg_compound_statement(IL2Gen* il2, FNodeId node, Block* blk) {
 	ErrorCode ecode = ec_noerr;
-	for (int i = 0; i < tnode_count_child(node); ++i) {
-		TNode* child = tnode_child(node, i);
+	for (int i = 0; i < fnode_count_child(il2->ftree, node); ++i) {
+		FNodeId child = fnode_child(il2->ftree, node, i);
 		if ((ecode = call_cgs(il2, child, blk)) != ec_noerr) return ecode;
 	}
 	return ecode;
 }
 
-static ErrorCode cg_selection_statement(IL2Gen* il2, TNode* node, Block* blk) {
+static ErrorCode cg_selection_statement(IL2Gen* il2, FNodeId node, Block* blk) {
 	/* Generate as follows: (if only, no else):
 	   evaluate expression
 	   jz false
@@ -531,12 +571,9 @@ static ErrorCode cg_selection_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	   end: */
 	ErrorCode ecode;
 
-	TNode* expr = tnode_child(node, 0);
-	TNode* statement_true = tnode_child(node, 1);
-	TNode* statement_false = NULL;
-	if (tnode_count_child(node) == 3) {
-		statement_false = tnode_child(node, 2);
-	}
+	FNodeId expr = fnode_child(il2->ftree, node, 0);
+	FNodeId statement_true = fnode_child(il2->ftree, node, 1);
+	int has_else = fnode_count_child(il2->ftree, node) == 3;
 
 	Symbol* label_false;
 	Symbol* label_end;
@@ -553,7 +590,7 @@ static ErrorCode cg_selection_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	if ((ecode = call_cgs(il2, statement_true, blk)) != ec_noerr) return ecode;
 
 	/* Has else: jump past statement when false after statement when true */
-	if (statement_false != NULL) {
+	if (has_else) {
 		if ((ecode = block_add_ilstat(blk, il2stat_make1(il2_jmp, label_end))) != ec_noerr) return ecode;
 	}
 
@@ -561,7 +598,8 @@ static ErrorCode cg_selection_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	if ((ecode = block_add_ilstat(blk, il2stat_make1(il2_lab, label_false))) != ec_noerr) return ecode;
 
 	/* Statement when false */
-	if (statement_false != NULL) {
+	if (has_else) {
+		FNodeId statement_false = fnode_child(il2->ftree, node, 2);
 		if ((ecode = call_cgs(il2, statement_false, blk)) != ec_noerr) return ecode;
 
 		if ((ecode = block_add_ilstat(blk, il2stat_make1(il2_lab, label_end))) != ec_noerr) return ecode;
@@ -570,7 +608,7 @@ static ErrorCode cg_selection_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	return ec_noerr;
 }
 
-static ErrorCode cg_while_statement(IL2Gen* il2, TNode* node, Block* blk) {
+static ErrorCode cg_while_statement(IL2Gen* il2, FNodeId node, Block* blk) {
 	/* Generate as follows:
 	   eval expr1
 	   jz end
@@ -582,8 +620,8 @@ static ErrorCode cg_while_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	   end: */
 	ErrorCode ecode;
 
-	TNode* expr = tnode_child(node, 0);
-	TNode* statement = tnode_child(node, 1);
+	FNodeId expr = fnode_child(il2->ftree, node, 0);
+	FNodeId statement = fnode_child(il2->ftree, node, 1);
 
 	Symbol* label_loop;
 	Symbol* label_body_end;
@@ -627,7 +665,7 @@ static ErrorCode cg_while_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	return ec_noerr;
 }
 
-static ErrorCode cg_do_statement(IL2Gen* il2, TNode* node, Block* blk) {
+static ErrorCode cg_do_statement(IL2Gen* il2, FNodeId node, Block* blk) {
 	/* Generate as follows:
 	   loop:
 	   statement
@@ -637,8 +675,8 @@ static ErrorCode cg_do_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	   end: */
 	ErrorCode ecode;
 
-	TNode* statement = tnode_child(node, 0);
-	TNode* expr = tnode_child(node, 1);
+	FNodeId statement = fnode_child(il2->ftree, node, 0);
+	FNodeId expr = fnode_child(il2->ftree, node, 1);
 
 	Symbol* label_loop;
 	Symbol* label_body_end;
@@ -675,7 +713,7 @@ static ErrorCode cg_do_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	return ec_noerr;
 }
 
-static ErrorCode cg_for_statement(IL2Gen* il2, TNode* node, Block* blk) {
+static ErrorCode cg_for_statement(IL2Gen* il2, FNodeId node, Block* blk) {
 	/* Generate as follows:
 	   expr1 / declaration
 	   eval expr2
@@ -688,14 +726,14 @@ static ErrorCode cg_for_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	   end: */
 	ErrorCode ecode;
 
-	TNode* decl_expr = tnode_child(node, 0);
-	TNode* expr2 = tnode_child(node, 1);
-	TNode* expr3 = tnode_child(node, 2);
-	TNode* statement = tnode_child(node, 3);
+	FNodeId decl_expr = fnode_child(il2->ftree, node, 0);
+	FNodeId expr2 = fnode_child(il2->ftree, node, 1);
+	FNodeId expr3 = fnode_child(il2->ftree, node, 2);
+	FNodeId statement = fnode_child(il2->ftree, node, 3);
 
-	if (tnode_type(decl_expr) == tt_dummy) decl_expr = NULL;
-	if (tnode_type(expr2) == tt_dummy) expr2 = NULL;
-	if (tnode_type(expr3) == tt_dummy) expr3 = NULL;
+	int has_decl_expr = fnode_type(il2->ftree, decl_expr) != tt_dummy;
+	int has_expr2 = fnode_type(il2->ftree, expr2) != tt_dummy;
+	int has_expr3 = fnode_type(il2->ftree, expr3) != tt_dummy;
 
 	Symbol* label_loop;
 	Symbol* label_body_end;
@@ -710,13 +748,13 @@ static ErrorCode cg_for_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	Symbol* expr_result;
 
 	/* Evaluate declaration / expression */
-	if (decl_expr) {
-		if ((ecode = call_cgs(il2, tnode_child(node, 0), blk)) != ec_noerr) return ecode;
+	if (has_decl_expr) {
+		if ((ecode = call_cgs(il2, decl_expr, blk)) != ec_noerr) return ecode;
 	}
 
 
 	/* Evaluate expression2 */
-	if (expr2) {
+	if (has_expr2) {
 		if ((ecode = call_cg(il2, &expr_result, expr2, blk)) != ec_noerr) return ecode;
 
 		/* Skip loop if false */
@@ -733,11 +771,11 @@ static ErrorCode cg_for_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	if ((ecode = block_add_ilstat(blk, il2stat_make1(il2_lab, label_body_end))) != ec_noerr) return ecode;
 
 	/* Evaluate expression3 */
-	if (expr3) {
+	if (has_expr3) {
 		if ((ecode = call_cg(il2, &expr_result, expr3, blk)) != ec_noerr) return ecode;
 	}
 
-	if (expr2) {
+	if (has_expr2) {
 		/* Repeat loop while true */
 		if ((ecode = call_cg(il2, &expr_result, expr2, blk)) != ec_noerr) return ecode;
 
@@ -758,9 +796,9 @@ static ErrorCode cg_for_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	return ec_noerr;
 }
 
-static ErrorCode cg_jump_statement(IL2Gen* il2, TNode* node, Block* blk) {
+static ErrorCode cg_jump_statement(IL2Gen* il2, FNodeId node, Block* blk) {
 	ErrorCode ecode;
-	TNodeJumpStatement* jump = (TNodeJumpStatement*)tnode_data(node);
+	TNodeJumpStatement* jump = (TNodeJumpStatement*)fnode_data(il2->ftree, node);
 
 	if (jump->type == TNodeJumpStatement_break) {
 		Symbol* label = symtab_last_cat(il2->stab, sc_lab_loopend);
@@ -771,12 +809,12 @@ static ErrorCode cg_jump_statement(IL2Gen* il2, TNode* node, Block* blk) {
 		if ((ecode = block_add_ilstat(blk, il2stat_make1(il2_jmp, label))) != ec_noerr) return ecode;
 	}
 	else if (jump->type == TNodeJumpStatement_return) {
-		if (tnode_count_child(node) == 1) {
+		if (fnode_count_child(il2->ftree, node) == 1) {
 			/* Has something to return */
-			TNode* child = tnode_child(node, 0);
+			FNodeId child = fnode_child(il2->ftree, node, 0);
 
 			Symbol* result;
-			call_cg(il2, &result, child, blk);
+			if ((ecode = call_cg(il2, &result, child, blk)) != ec_noerr) return ecode;
 
 			if ((ecode = block_add_ilstat(blk, il2stat_make1(il2_ret, result))) != ec_noerr) return ecode;
 		}
@@ -788,16 +826,16 @@ static ErrorCode cg_jump_statement(IL2Gen* il2, TNode* node, Block* blk) {
 	return ec_noerr;
 }
 
-static ErrorCode cg_function_definition(IL2Gen* il2, TNode* node) {
+static ErrorCode cg_function_definition(IL2Gen* il2, FNodeId node) {
 	ErrorCode ecode;
 
 	/*
-	TNode* declspec = tnode_child(node, 0);
-	TNode* pointer = tnode_child(node, 1);
-	TNode* identifier = tnode_child(node, 2);
-	TNode* param_type_list = tnode_child(node, 3);
+	FNodeId declspec = fnode_child(il2->ftree, node, 0);
+	FNodeId pointer = fnode_child(il2->ftree, node, 1);
+	FNodeId identifier = fnode_child(il2->ftree, node, 2);
+	FNodeId param_type_list = fnode_child(il2->ftree, node, 3);
 	*/
-	TNode* compound_stat = tnode_child(node, 4);
+	FNodeId compound_stat = fnode_child(il2->ftree, node, 4);
 
 	Block* blk;
 	if ((ecode = cfg_new_block(il2->cfg, &blk)) != ec_noerr) return ecode;
@@ -806,14 +844,14 @@ static ErrorCode cg_function_definition(IL2Gen* il2, TNode* node) {
 	if ((ecode = cg_compound_statement(il2, compound_stat, blk)) != ec_noerr) return ecode;
 
 	symtab_pop_scope(il2->stab);
-	return ec_noerr;
+	return cfg_partition(il2->cfg);
 }
 
-static ErrorCode traverse_tree(IL2Gen* il2, TNode* node) {
+static ErrorCode traverse_tree(IL2Gen* il2, FNodeId node) {
 	ErrorCode ecode;
-	for (int i = 0; i < tnode_count_child(node); ++i) {
-		TNode* child = tnode_child(node, i);
-		switch (tnode_type(child)) {
+	for (int i = 0; i < fnode_count_child(il2->ftree, node); ++i) {
+		FNodeId child = fnode_child(il2->ftree, node, i);
+		switch (fnode_type(il2->ftree, child)) {
 		case tt_function_definition:
 			ecode = cg_function_definition(il2, child);
 			break;
@@ -827,112 +865,177 @@ static ErrorCode traverse_tree(IL2Gen* il2, TNode* node) {
 }
 
 ErrorCode il2_gen(IL2Gen* il2) {
-	return traverse_tree(il2, tree_root(il2->tree));
+	return traverse_tree(il2, flat_tree_root(il2->ftree));
 }
 
-ErrorCode il2_write(IL2Gen* il2, const char* filepath) {
-	FILE* f = fopen(filepath, "w");
-	if (f == NULL) {
-		ERRMSG("Failed to open output file\n");
-		return ec_writefailed;
+/* Returns the IL2 name of the type specifiers */
+static const char* il2_type_str(TypeSpecifiers ts) {
+	switch (ts) {
+	case ts_void:
+		return "void";
+	case ts_char:
+	case ts_schar:
+		return "i8";
+	case ts_uchar:
+		return "u8";
+	case ts_short:
+		return "i16";
+	case ts_ushort:
+		return "u16";
+	case ts_int:
+	case ts_long:
+		return "i32";
+	case ts_uint:
+	case ts_ulong:
+		return "u32";
+	case ts_longlong:
+		return "i64";
+	case ts_ulonglong:
+		return "u64";
+	case ts_float:
+		return "f32";
+	case ts_double:
+	case ts_ldouble:
+		return "f64_";
+	default:
+		return "???";
 	}
+}
 
-	/* Dirty hack to output
-	   In the future the Cfg gets directly fed to the assembly generator */
-
-	/* Write the addresses of the pointers to give them unique names */
-
-	/* Write symbol table
-	   skip the first 2 as that is argc, argv */
-	if (hvec_size(&il2->stab->symbol) < 2) goto exit;
-	Symbol* argc = &hvec_at(&il2->stab->symbol, 0);
-	Symbol* argv = &hvec_at(&il2->stab->symbol, 1);
-
-	for (int i = 2; i < hvec_size(&il2->stab->symbol); ++i) {
-		Symbol* sym = &hvec_at(&il2->stab->symbol, i);
-		Type* type = symbol_type(sym);
-
-		if (!type_is_standard(type)) continue;
-
-		const char* type_str;
-		switch (type_typespec(type)) {
-		case ts_void:
-			type_str = "void";
-			break;
-		case ts_char:
-		case ts_schar:
-			type_str = "i8";
-			break;
-		case ts_uchar:
-			type_str = "u8";
-			break;
-		case ts_short:
-			type_str = "i16";
-			break;
-		case ts_ushort:
-			type_str = "u16";
-			break;
-		case ts_int:
-		case ts_long:
-			type_str = "i32";
-			break;
-		case ts_uint:
-		case ts_ulong:
-			type_str = "u32";
-			break;
-		case ts_longlong:
-			type_str = "i64";
-			break;
-		case ts_ulonglong:
-			type_str = "u64";
-			break;
-		case ts_float:
-			type_str = "f32";
-			break;
-		case ts_double:
-		case ts_ldouble:
-			type_str = "f64_";
-			break;
-		default:
-			type_str = "???";
-			break;
-		}
+/* Writes type with its pointers, e.g., i8** */
+static ErrorCode il2_write_type(FILE* f, Type* type) {
+	if (fprintf(f, "%s", il2_type_str(type_typespec(type))) < 0) return ec_writefailed;
+	for (int i = 0; i < type_pointer(type); ++i) {
+		if (fprintf(f, "*") < 0) return ec_writefailed;
+	}
+	return ec_noerr;
+}
 
-		if (fprintf(f, "def %s _Z%p\n", type_str, (void*)sym) < 0) goto exit;
+/* Writes constant in decimal regardless of how it was spelled in the
+   source, negative if its type is signed and its sign bit is set */
+static ErrorCode il2_write_constant(FILE* f, Symbol* sym) {
+	uint64_t value = symbol_constant_value(sym);
+	Type* type = symbol_type(sym);
+	int bits = type_bytes(type) * 8;
+	if (type_signed(type_typespec(type)) && ((value >> (bits - 1)) & 1)) {
+		/* Magnitude of the value as the bits of its type */
+		uint64_t magnitude = (~value + 1) & (~(uint64_t)0 >> (64 - bits));
+		if (fprintf(f, "-%" PRIu64, magnitude) < 0) return ec_writefailed;
+		return ec_noerr;
 	}
+	if (fprintf(f, "%" PRIu64, value) < 0) return ec_writefailed;
+	return ec_noerr;
+}
 
-	/* Write start of function */
-	if (fprintf(f, "func main,i32,i32 _Z%p,i8** _Z%p\n", (void*)argc, (void*)argv) < 0) goto exit;
+/* Writes the labels of the block as lab statements, then its statements */
+static ErrorCode il2_write_block(FILE* f, Block* blk) {
+	ErrorCode ecode;
+	for (int i = 0; i < block_lab_count(blk); ++i) {
+		if (fprintf(f, "%s _Z%p\n", il2_str(il2_lab), (void*)block_lab(blk, i)) < 0) return ec_writefailed;
+	}
 
-	/* Write IL2 */
-	Block* blk = &vec_at(&il2->cfg->blocks, 0);
 	for (int i = 0; i < block_ilstat_count(blk); ++i) {
 		IL2Statement* stat = block_ilstat(blk, i);
 
 		/* Instruction */
-		if (fprintf(f, "%s ", il2_str(il2stat_ins(stat))) < 0) goto exit;
+		if (fprintf(f, "%s ", il2_str(il2stat_ins(stat))) < 0) return ec_writefailed;
 
 		for (int j = 0; j < il2stat_argc(stat); ++j) {
 			/* Argument */
 			if (j != 0) {
-				if (fprintf(f, ",") < 0) goto exit;
+				if (fprintf(f, ",") < 0) return ec_writefailed;
 			}
 
 			Symbol* arg = il2stat_arg(stat, j);
-			const char* token = symbol_token(arg);
-
-			if ('0' <= token[0] && token[0] <= '9') {
-				/* Is constant */
-				if (fprintf(f, "%s", symbol_token(arg)) < 0) goto exit;
+			if (symbol_is_constant(arg)) {
+				if ((ecode = il2_write_constant(f, arg)) != ec_noerr) return ecode;
 			}
 			else {
-				if (fprintf(f, "_Z%p", (void*)arg) < 0) goto exit;
+				if (fprintf(f, "_Z%p", (void*)arg) < 0) return ec_writefailed;
 			}
 		}
-		if (fprintf(f, "\n") < 0) goto exit;
+		if (fprintf(f, "\n") < 0) return ec_writefailed;
 	}
+	return ec_noerr;
+}
 
-exit:
+/* Sets the aux of the symbols the IL2 of the cfg references, the
+   labels of the blocks and the arguments of their statements, to mark */
+static void il2_mark_referenced(IL2Gen* il2, uint32_t mark) {
+	for (int i = 0; i < vec_size(&il2->cfg->blocks); ++i) {
+		Block* blk = &vec_at(&il2->cfg->blocks, i);
+		for (int j = 0; j < block_lab_count(blk); ++j) {
+			symbol_set_aux(block_lab(blk, j), mark);
+		}
+		for (int j = 0; j < block_ilstat_count(blk); ++j) {
+			IL2Statement* stat = block_ilstat(blk, j);
+			for (int k = 0; k < il2stat_argc(stat); ++k) {
+				symbol_set_aux(il2stat_arg(stat, k), mark);
+			}
+		}
+	}
+}
+
+ErrorCode il2_write(IL2Gen* il2, const char* filepath) {
+	FILE* f = fopen(filepath, "w");
+	if (f == NULL) {
+		ERRMSG("Failed to open output file\n");
+		return ec_writefailed;
+	}
+
+	ErrorCode ecode = il2_write_function(il2, f, 0);
 	fclose(f);
+	return ecode;
+}
+
+ErrorCode il2_write_function(IL2Gen* il2, FILE* f, int first_symbol) {
+	ErrorCode ecode = ec_noerr;
+
+	/* Dirty hack to output
+	   In the future the Cfg gets directly fed to the assembly generator */
+
+	/* Write the addresses of the pointers to give them unique names */
+
+	/* The parameters are added before the function */
+	int i_func = first_symbol;
+	for (; i_func < svec_size(&il2->stab->symbol); ++i_func) {
+		if (type_is_function(symbol_type(&svec_at(&il2->stab->symbol, i_func)))) break;
+	}
+	/* No function defined */
+	if (i_func == svec_size(&il2->stab->symbol)) return ec_noerr;
+
+	/* Write start of function */
+	Symbol* func = &svec_at(&il2->stab->symbol, i_func);
+	if (fprintf(f, "func %s,", symbol_token(func)) < 0) return ec_writefailed;
+	if ((ecode = il2_write_type(f, type_return(symbol_type(func)))) != ec_noerr) return ecode;
+	for (int i = first_symbol; i < i_func; ++i) {
+		Symbol* param = &svec_at(&il2->stab->symbol, i);
+		if (fprintf(f, ",") < 0) return ec_writefailed;
+		if ((ecode = il2_write_type(f, symbol_type(param))) != ec_noerr) return ecode;
+		if (fprintf(f, " _Z%p", (void*)param) < 0) return ec_writefailed;
+	}
+	if (fprintf(f, "\n") < 0) return ec_writefailed;
+
+	/* Write symbol table, only the symbols the IL2 references are
+	   defined as optimizing may remove every statement of a temporary */
+	il2_mark_referenced(il2, 1);
+	for (int i = i_func + 1; i < svec_size(&il2->stab->symbol); ++i) {
+		Symbol* sym = &svec_at(&il2->stab->symbol, i);
+		Type* type = symbol_type(sym);
+
+		if (!type_is_standard(type) || symbol_aux(sym) == 0) continue;
+
+		if (fprintf(f, "def %s _Z%p\n", il2_type_str(type_typespec(type)), (void*)sym) < 0) {
+			ecode = ec_writefailed;
+			break;
+		}
+	}
+	il2_mark_referenced(il2, 0);
+	if (ecode != ec_noerr) return ecode;
+
+	/* Write IL2 */
+	for (int i = 0; i < vec_size(&il2->cfg->blocks); ++i) {
+		if ((ecode = il2_write_block(f, &vec_at(&il2->cfg->blocks, i))) != ec_noerr) return ecode;
+	}
 	return ec_noerr;
 }
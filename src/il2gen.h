@@ -1,25 +1,53 @@
-/* Converts Tree nodes from parser to Intermediate language 2 (IL2) nodes */
+/* Converts the flat tree of the program to Intermediate language 2 (IL2) nodes */
 #ifndef IL2GEN_H
 #define IL2GEN_H
 
+#include <stdio.h>
+
 #include "cfg.h"
+#include "flattree.h"
 #include "symtab.h"
-#include "tree.h"
+
+/* Expression whose code is being generated, with the index of the next
+   operand to generate code for */
+typedef struct
+{
+	FNodeId node;
+	int operand;
+	/* Labels of logical expressions, jumped to when the result is known
+	   before all operands are evaluated, and at the end */
+	Symbol* label_short;
+	Symbol* label_end;
+} IL2GenFrame;
 
 typedef struct
 {
 	Cfg* cfg;
 	Symtab* stab;
-	Tree* tree;
+	FlatTree* ftree;
+
+	/* Expressions are generated with these stacks instead of recursion,
+	   so deeply nested expressions do not overflow the call stack.
+	   Results of generated operands wait on the operand stack until
+	   their expression is generated */
+	vec_t(IL2GenFrame) frame;
+	vec_t(Symbol*) operand;
 } IL2Gen;
 
-ErrorCode il2_construct(IL2Gen* il2, Cfg* cfg, Symtab* stab, Tree* tree);
+ErrorCode il2_construct(IL2Gen* il2, Cfg* cfg, Symtab* stab, FlatTree* ftree);
+
+void il2_destruct(IL2Gen* il2);
 
-/* Converts Tree nodes from parser to IL2 nodes
-   The nodes are stored in the tree */
+/* Converts nodes of the flat tree to IL2 nodes
+   The nodes are stored in the cfg */
 ErrorCode il2_gen(IL2Gen* il2);
 
 /* Writes il2 to provided file */
 ErrorCode il2_write(IL2Gen* il2, const char* filepath);
 
+/* Writes il2 of the function defined with the symbols from index
+   first_symbol of the symbol table onwards to the open file f
+   The parameters of the function are the symbols before the function */
+ErrorCode il2_write_function(IL2Gen* il2, FILE* f, int first_symbol);
+
 #endif
@@ -26,6 +26,29 @@ int il2_isjump(IL2Ins ins) {
 	}
 }
 
+int il2_isdef(IL2Ins ins) {
+	switch (ins) {
+	case il2_add:
+	case il2_call:
+	case il2_ce:
+	case il2_cl:
+	case il2_cle:
+	case il2_cne:
+	case il2_div:
+	case il2_mad:
+	case il2_mfi:
+	case il2_mod:
+	case il2_mov:
+	case il2_mtc:
+	case il2_mul:
+	case il2_not:
+	case il2_sub:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
 int il2_incfg(IL2Ins ins) {
 	switch (ins) {
 	case il2_def:
@@ -87,3 +110,11 @@ int il2stat_argc(const IL2Statement* stat) {
 	ASSERT(stat != NULL, "IL2Statement is null");
 	return stat->argc;
 }
+
+int il2stat_isuse(const IL2Statement* stat, int i) {
+	ASSERT(stat != NULL, "IL2Statement is null");
+	ASSERT(i >= 0, "Index out of range");
+	ASSERT(i < stat->argc, "Index out of range");
+	if (i == 0 && (il2_isdef(stat->ins) || il2_isjump(stat->ins))) return 0;
+	return 1;
+}
@@ -50,6 +50,10 @@ IL2Ins il2_from_str(const char* str);
    0 otherwise */
 int il2_isjump(IL2Ins ins);
 
+/* Returns 1 if the instruction assigns to its first argument
+   0 otherwise */
+int il2_isdef(IL2Ins ins);
+
 /* Returns 1 if the instruction should be included
    as part of the control flow graph,
    0 otherwise */
@@ -83,4 +87,8 @@ Symbol* il2stat_arg(const IL2Statement* stat, int i);
 /* Returns the number of arguments in IL statement */
 int il2stat_argc(const IL2Statement* stat);
 
+/* Returns 1 if arg at index i is read by the IL statement, i.e., it is
+   not the symbol assigned to or the label jumped to, 0 otherwise */
+int il2stat_isuse(const IL2Statement* stat, int i);
+
 #endif
@@ -1,66 +1,172 @@
 /* Lexer / token handling */
 
+#include <pthread.h>
+#include <unistd.h>
+
 #include "lexer.h"
 #include "globals.h"
 
+#include "charscan.h"
 #include "common.h"
 
 /* Returns 1 is considered whitespace */
 static int iswhitespace(char c) {
-	switch (c) {
-	case ' ':
-	case '\t':
-	case '\n':
-		return 1;
-	default:
-		return 0;
-	}
+	return (charscan_class[(uint8_t)c] & CHARSCAN_WHITESPACE) != 0;
 }
 
 /* If character is part of a punctuator */
 int isofpunctuator(char c) {
-	switch (c) {
-	case '[':
-	case ']':
-	case '(':
-	case ')':
-	case '{':
-	case '}':
-	case '.':
-	case '-':
-	case '+':
-	case '&':
-	case '*':
-	case '~':
-	case '!':
-	case '/':
-	case '%':
-	case '<':
-	case '>':
-	case '=':
-	case '^':
-	case '|':
-	case '?':
-	case ':':
-	case ';':
-	case ',':
-	case '#':
-		return 1;
-	default:
-		return 0;
-	}
+	return (charscan_class[(uint8_t)c] & CHARSCAN_PUNCTUATOR) != 0;
+}
+
+/* Spelling of each token kind */
+#define TOKEN_KIND(name__, str__, class__) str__,
+static const char* token_kind_str[] = {TOKEN_KINDS};
+#undef TOKEN_KIND
+
+#define TOKEN_KIND(name__, str__, class__) tc_##class__,
+static const TokenClass token_kind_class[] = {TOKEN_KINDS};
+#undef TOKEN_KIND
+
+const char* tk_str(TokenKind kind) {
+	ASSERT(kind >= 0 && kind < tk_count, "Invalid token kind");
+	return token_kind_str[kind];
+}
+
+TokenClass tk_class(TokenKind kind) {
+	ASSERT(kind >= 0 && kind < tk_count, "Invalid token kind");
+	return token_kind_class[kind];
 }
 
 /* C keyword handling */
 
+/* Returns kind if the len chars at token are the spelling of kind,
+   tk_identifier otherwise. The spelling of kind must have len chars */
+static inline TokenKind tok_match(const char* token, int len, TokenKind kind) {
+	const char* str = token_kind_str[kind];
+	for (int i = 0; i < len; ++i) {
+		if (token[i] != str[i]) return tk_identifier;
+	}
+	return kind;
+}
+
+/* Keywords are selected by length, then by the first (and where
+   necessary, following) characters, leaving at most one keyword to
+   compare against */
+TokenKind tok_classify(const char* token, int len) {
+	switch (len) {
+	case 2:
+		switch (token[0]) {
+		case 'd':
+			return tok_match(token, len, tk_do);
+		case 'i':
+			return tok_match(token, len, tk_if);
+		default:
+			return tk_identifier;
+		}
+	case 3:
+		switch (token[0]) {
+		case 'f':
+			return tok_match(token, len, tk_for);
+		case 'i':
+			return tok_match(token, len, tk_int);
+		default:
+			return tk_identifier;
+		}
+	case 4:
+		switch (token[0]) {
+		case 'a':
+			return tok_match(token, len, tk_auto);
+		case 'c':
+			return tok_match(token, len, token[1] == 'a' ? tk_case : tk_char);
+		case 'e':
+			return tok_match(token, len, token[1] == 'l' ? tk_else : tk_enum);
+		case 'g':
+			return tok_match(token, len, tk_goto);
+		case 'l':
+			return tok_match(token, len, tk_long);
+		case 'v':
+			return tok_match(token, len, tk_void);
+		default:
+			return tk_identifier;
+		}
+	case 5:
+		switch (token[0]) {
+		case '_':
+			return tok_match(token, len, tk_bool);
+		case 'b':
+			return tok_match(token, len, tk_break);
+		case 'c':
+			return tok_match(token, len, tk_const);
+		case 'f':
+			return tok_match(token, len, tk_float);
+		case 's':
+			return tok_match(token, len, tk_short);
+		case 'u':
+			return tok_match(token, len, tk_union);
+		case 'w':
+			return tok_match(token, len, tk_while);
+		default:
+			return tk_identifier;
+		}
+	case 6:
+		switch (token[0]) {
+		case 'd':
+			return tok_match(token, len, tk_double);
+		case 'e':
+			return tok_match(token, len, tk_extern);
+		case 'i':
+			return tok_match(token, len, tk_inline);
+		case 'r':
+			return tok_match(token, len, tk_return);
+		case 's':
+			switch (token[1]) {
+			case 'i':
+				return tok_match(token, len, token[2] == 'g' ? tk_signed : tk_sizeof);
+			case 't':
+				return tok_match(token, len, token[2] == 'a' ? tk_static : tk_struct);
+			case 'w':
+				return tok_match(token, len, tk_switch);
+			default:
+				return tk_identifier;
+			}
+		default:
+			return tk_identifier;
+		}
+	case 7:
+		switch (token[0]) {
+		case 'd':
+			return tok_match(token, len, tk_default);
+		case 't':
+			return tok_match(token, len, tk_typedef);
+		default:
+			return tk_identifier;
+		}
+	case 8:
+		switch (token[0]) {
+		case '_':
+			return tok_match(token, len, tk_complex);
+		case 'c':
+			return tok_match(token, len, tk_continue);
+		case 'r':
+			return tok_match(token, len, token[2] == 'g' ? tk_register : tk_restrict);
+		case 'u':
+			return tok_match(token, len, tk_unsigned);
+		case 'v':
+			return tok_match(token, len, tk_volatile);
+		default:
+			return tk_identifier;
+		}
+	case 10:
+		return tok_match(token, len, tk_imaginary);
+	default:
+		return tk_identifier;
+	}
+}
+
 /* Returns 1 if string is considered as a keyword, 0 otherwise */
 int tok_iskeyword(const char* token) {
-	const char* token_keyword[] = {
-		"_Bool",  "_Complex", "_Imaginary", "auto",		"break",  "case",	  "char",	"const",  "continue", "default",
-		"do",	  "double",	  "else",		"enum",		"extern", "float",	  "for",	"goto",	  "if",		  "inline",
-		"int",	  "long",	  "register",	"restrict", "return", "short",	  "signed", "sizeof", "static",	  "struct",
-		"switch", "typedef",  "union",		"unsigned", "void",	  "volatile", "while"};
-	return strbinfind(token, strlength(token), token_keyword, ARRAY_SIZE(token_keyword)) >= 0;
+	return tok_classify(token, strlength(token)) != tk_identifier;
 }
 
 /* Returns 1 if string is considered a unary operator */
@@ -82,59 +188,34 @@ int tok_isunaryop(const char* str) {
 	}
 }
 
-/* Returns 1 if token is considered an assignment operator */
-int tok_isassignmentop(const char* token) {
-	const char* token_assignment_operator[] = {/* See strbinfind for ordering requirements */
-											   "%=",
-											   "&=",
-											   "*=",
-											   "+=",
-											   "-=",
-											   "/=",
-											   "<<=",
-											   "=",
-											   ">>=",
-											   "^=",
-											   "|="};
-	return strbinfind(token, strlength(token), token_assignment_operator, ARRAY_SIZE(token_assignment_operator)) >= 0;
-}
-
-int tok_isstoreclass(const char* str) {
-	const char* token_storage_class_keyword[] = {/* See strbinfind for ordering requirements */
-												 "auto",
-												 "extern",
-												 "register",
-												 "static",
-												 "typedef"};
-	return strbinfind(str, strlength(str), token_storage_class_keyword, ARRAY_SIZE(token_storage_class_keyword)) >= 0;
-}
-
-int tok_istypespec(const char* str) {
-	const char* token_type_keyword[] = {
-		/* See strbinfind for ordering requirements */
-		"char",
-		"double",
-		"float",
-		"int",
-		"long",
-		"short",
-		"signed",
-		"unsigned",
-		"void",
-	};
-	return strbinfind(str, strlength(str), token_type_keyword, ARRAY_SIZE(token_type_keyword)) >= 0;
-}
-
-int tok_istypequal(const char* str) {
-	const char* token_type_qualifier_keyword[] = {/* See strbinfind for ordering requirements */
-												  "const",
-												  "restrict",
-												  "volatile"};
-	return strbinfind(str, strlength(str), token_type_qualifier_keyword, ARRAY_SIZE(token_type_qualifier_keyword)) >= 0;
-}
-
-int tok_isfuncspec(const char* str) {
-	return strequ(str, "inline");
+int tk_iskeyword(TokenKind kind) {
+	TokenClass class = tk_class(kind);
+	return class != tc_none && class != tc_punctuator && class != tc_assignop;
+}
+
+int tk_isstoreclass(TokenKind kind) {
+	return tk_class(kind) == tc_storeclass;
+}
+
+int tk_istypespec(TokenKind kind) {
+	return tk_class(kind) == tc_typespec;
+}
+
+int tk_istypequal(TokenKind kind) {
+	return tk_class(kind) == tc_typequal;
+}
+
+int tk_isfuncspec(TokenKind kind) {
+	return tk_class(kind) == tc_funcspec;
+}
+
+int tk_isdeclspec(TokenKind kind) {
+	TokenClass class = tk_class(kind);
+	return class == tc_storeclass || class == tc_typespec || class == tc_typequal || class == tc_funcspec;
+}
+
+int tk_isassignmentop(TokenKind kind) {
+	return tk_class(kind) == tc_assignop;
 }
 
 int tok_isidentifier(const char* str) {
@@ -184,122 +265,425 @@ int tok_isidentifier(const char* str) {
 }
 
 /* Reads in a character from input
-   Does not advance read position */
+   Does not advance read position
+   Returns EOF if at the end of the input */
 static char read_char(Lexer* lex) {
-	/* Perhaps this can be a buffer in the future to reduce system calls */
-	char c = (char)getc(lex->rf);
-
-	/* Handle line marker from preprocessor*/
-	if (lex->char_num == 1) {
-		while (c == '#') {
-			getc(lex->rf); /* Consume space */
-
-			/* Line number */
-			int line_num = 0;
-			while ((c = (char)getc(lex->rf)) != ' ') {
-				line_num *= 10;
-				line_num += c - '0';
-			}
-			lex->line_num = line_num;
-
-			/* Consume linemarker */
-			while ((c = (char)getc(lex->rf)) != '\n')
-				;
-			c = (char)getc(lex->rf); /* First char of next line */
-		}
+	if (lex->buf_pos >= lex->buf_len) {
+		return (char)EOF;
 	}
-
-	fseek(lex->rf, -1, SEEK_CUR);
-	return c;
+	return lex->buf[lex->buf_pos];
 }
 
 /* Reads in a character from input 1 ahead
    of character from read_char
    Does not advance read position */
 static char read_char_next(Lexer* lex) {
-	getc(lex->rf);
-	char c = (char)getc(lex->rf);
-	fseek(lex->rf, -2, SEEK_CUR);
-	return c;
+	if (lex->buf_pos + 1 >= lex->buf_len) {
+		return (char)EOF;
+	}
+	return lex->buf[lex->buf_pos + 1];
 }
 
-
 /* Advances read position to next char */
 static void consume_char(Lexer* lex) {
-	/* Move the file position forwards */
-	char c = (char)getc(lex->rf);
+	if (lex->buf_pos < lex->buf_len) {
+		++lex->buf_pos;
+	}
+}
+
+/* Advances read position by n chars */
+static void consume_chars(Lexer* lex, int n) {
+	ASSERT(lex->buf_pos + n <= lex->buf_len, "Consumed past end of buffer");
+	lex->buf_pos += n;
+}
 
-	if (c == '\n') {
-		++lex->line_num;
-		lex->char_num = 1;
+/* Reads more of the input stream into the window, sliding the window
+   forward over characters which are no longer needed */
+static ErrorCode slide_window(Lexer* lex) {
+	ErrorCode ecode;
+
+	/* Keep the loaded tokens and the start of their line so they can be
+	   shown in error messages, unless the line is very long */
+	int keep = lex->buf_pos;
+	for (int i = 0; i < 2; ++i) {
+		const Token* tok = &lex->get_buf[i];
+		if (tok->str != NULL && tok->loc - lex->buf_loc < keep) keep = tok->loc - lex->buf_loc;
 	}
-	else {
-		++lex->char_num;
+	int line_start = keep;
+	while (line_start > 0 && lex->buf[line_start - 1] != '\n' && keep - line_start < LEXER_WINDOW_SIZE / 4) {
+		--line_start;
+	}
+	keep = lex->buf_keep ? 0 : line_start;
+
+	if (keep > 0) {
+		int line_num;
+		int char_num;
+		if ((ecode = lexer_location(lex, lex->buf_loc + keep, &line_num, &char_num)) != ec_noerr) return ecode;
+
+		memmove(lex->buf, lex->buf + keep, (size_t)(lex->buf_len - keep));
+		lex->buf_loc += keep;
+		lex->buf_len -= keep;
+		lex->buf_pos -= keep;
+		lex->buf_line_num = line_num;
+		lex->buf_char_num = char_num;
+		lex->lines_built = 0;
+	}
+
+	/* Window is full of characters which must be kept */
+	if (lex->buf_capacity - lex->buf_len < LEXER_WINDOW_LOOKAHEAD) {
+		if (lex->buf_capacity > INT32_MAX / 2) return ec_fileposfailed;
+		int capacity = lex->buf_capacity * 2;
+		char* buf = cmalloc((size_t)capacity + 1);
+		if (buf == NULL) return ec_badalloc;
+		memcpy(buf, lex->buf, (size_t)lex->buf_len);
+		cfree(lex->buf);
+		lex->buf = buf;
+		lex->buf_capacity = capacity;
 	}
 
-	/* Overwrite the front contents if buffer is full */
-	if ((lex->line_buf_end + 1) % LEXER_LINE_BUF_SIZE == lex->line_buf_front) {
-		lex->line_buf_front = (lex->line_buf_front + 1) % LEXER_LINE_BUF_SIZE;
+	size_t request = (size_t)(lex->buf_capacity - lex->buf_len);
+	if ((size_t)(INT32_MAX - lex->buf_loc - lex->buf_len) < request) return ec_fileposfailed;
+	size_t read = fread(lex->buf + lex->buf_len, 1, request, lex->rf);
+	lex->buf_len += (int)read;
+	lex->buf[lex->buf_len] = '\0';
+	if (read < request) {
+		if (ferror(lex->rf)) return ec_lexer_readfailed;
+		lex->rf_eof = 1;
 	}
-	lex->line_buf[lex->line_buf_end] = c;
-	lex->line_buf_end = (lex->line_buf_end + 1) % LEXER_LINE_BUF_SIZE;
+	return ec_noerr;
 }
 
-ErrorCode lexer_construct(Lexer* lex, const char* filepath) {
-	lex->line_num = 1;
-	lex->char_num = 1;
+/* Ensures LEXER_WINDOW_LOOKAHEAD characters after the read position are
+   in buf, unless the end of input is reached */
+static ErrorCode fill_window(Lexer* lex) {
+	if (lex->rf == NULL || lex->rf_eof || lex->buf_len - lex->buf_pos >= LEXER_WINDOW_LOOKAHEAD) {
+		return ec_noerr;
+	}
+	return slide_window(lex);
+}
+
+/* Returns 1 if the read position is at a line marker from the
+   preprocessor, e.g., # 1 "file.c" */
+static int at_line_marker(Lexer* lex) {
+	if (lex->buf[lex->buf_pos] != '#') return 0;
+	if (lex->buf_pos == 0) return lex->buf_char_num == 1;
+	return lex->buf[lex->buf_pos - 1] == '\n';
+}
+
+/* Advances read position past the next newline */
+static ErrorCode consume_line(Lexer* lex) {
+	ErrorCode ecode;
+	while (1) {
+		const char* newline = memchr(lex->buf + lex->buf_pos, '\n', (size_t)(lex->buf_len - lex->buf_pos));
+		if (newline != NULL) {
+			lex->buf_pos = (int)(newline - lex->buf) + 1;
+			return ec_noerr;
+		}
+
+		lex->buf_pos = lex->buf_len;
+		if (lex->rf == NULL || lex->rf_eof) return ec_noerr;
+		if ((ecode = slide_window(lex)) != ec_noerr) return ecode;
+	}
+}
 
-	lex->line_buf_front = 0;
-	lex->line_buf_end = 0;
+/* Reads the file at filepath into lexer buffer */
+static ErrorCode read_file(Lexer* lex, const char* filepath) {
+	ErrorCode ecode = ec_noerr;
 
-	lex->primary_line_num = 0;
-	lex->primary_char_num = 0;
-	lex->primary_length = 0;
+	FILE* rf = fopen(filepath, "rb");
+	if (rf == NULL) {
+		return ec_lexer_fopenfail;
+	}
 
-	lex->secondary_line_num = 0;
-	lex->secondary_char_num = 0;
-	lex->secondary_length = 0;
+	if (fseek(rf, 0, SEEK_END) != 0) {
+		ecode = ec_fileposfailed;
+		goto exit;
+	}
+	long len = ftell(rf);
+	if (len < 0 || len >= INT32_MAX) {
+		ecode = ec_fileposfailed;
+		goto exit;
+	}
+	if (fseek(rf, 0, SEEK_SET) != 0) {
+		ecode = ec_fileposfailed;
+		goto exit;
+	}
 
-	lex->get_buf[0][0] = '\0';
-	lex->get_buf[1][0] = '\0';
+	lex->buf = cmalloc((size_t)len + 1);
+	if (lex->buf == NULL) {
+		ecode = ec_badalloc;
+		goto exit;
+	}
+	lex->buf_capacity = (int)len;
+	lex->buf_len = (int)fread(lex->buf, 1, (size_t)len, rf);
+	lex->buf[lex->buf_len] = '\0';
+
+exit:
+	fclose(rf);
+	return ecode;
+}
+
+/* Initializes the members of lexer other than the input */
+static ErrorCode lexer_init(Lexer* lex) {
+	lex->buf = NULL;
+	lex->buf_len = 0;
+	lex->buf_capacity = 0;
+	lex->buf_pos = 0;
+
+	lex->rf = NULL;
+	lex->rf_eof = 0;
+	lex->buf_keep = 0;
+
+	lex->buf_loc = 0;
+	lex->buf_line_num = 1;
+	lex->buf_char_num = 1;
+
+	lex->lines_built = 0;
+	vec_construct(&lex->line_start);
+	vec_construct(&lex->line_num);
+
+	lex->get_buf[0].str = NULL;
+	lex->get_buf[1].str = NULL;
 	lex->primary = 0;
 	lex->secondary = 1;
 
-	lex->rf = fopen(filepath, "r");
-	if (lex->rf == NULL) {
-		return ec_lexer_fopenfail;
+	lex->pretokenized = 0;
+	vec_construct(&lex->table.kind);
+	vec_construct(&lex->table.id);
+	vec_construct(&lex->table.loc);
+	vec_construct(&lex->table.length);
+	lex->cursor = 0;
+
+	return strpool_construct(&lex->pool);
+}
+
+ErrorCode lexer_construct(Lexer* lex, const char* filepath) {
+	ErrorCode ecode;
+	if ((ecode = lexer_init(lex)) != ec_noerr) return ecode;
+	if ((ecode = read_file(lex, filepath)) != ec_noerr) {
+		lexer_destruct(lex);
+		return ecode;
+	}
+	return ec_noerr;
+}
+
+ErrorCode lexer_construct_stream(Lexer* lex, FILE* rf) {
+	ErrorCode ecode;
+	if ((ecode = lexer_init(lex)) != ec_noerr) return ecode;
+
+	lex->buf = cmalloc(LEXER_WINDOW_SIZE + 1);
+	if (lex->buf == NULL) {
+		lexer_destruct(lex);
+		return ec_badalloc;
+	}
+	lex->buf[0] = '\0';
+	lex->buf_capacity = LEXER_WINDOW_SIZE;
+	lex->rf = rf;
+
+	if ((ecode = slide_window(lex)) != ec_noerr) {
+		lexer_destruct(lex);
+		return ecode;
 	}
 	return ec_noerr;
 }
 
 void lexer_destruct(Lexer* lex) {
-	if (lex->rf != NULL) fclose(lex->rf);
+	vec_destruct(&lex->table.kind);
+	vec_destruct(&lex->table.id);
+	vec_destruct(&lex->table.loc);
+	vec_destruct(&lex->table.length);
+	vec_destruct(&lex->line_start);
+	vec_destruct(&lex->line_num);
+	strpool_destruct(&lex->pool);
+	if (lex->buf != NULL) cfree(lex->buf);
+}
+
+/* Returns kind of punctuator with given spelling of 1 or 2 chars,
+   tk_other if not a recognized punctuator */
+static TokenKind punctuator_kind(const char* str, int len) {
+	if (len == 1) {
+		switch (str[0]) {
+		case '[':
+			return tk_lbracket;
+		case ']':
+			return tk_rbracket;
+		case '(':
+			return tk_lparen;
+		case ')':
+			return tk_rparen;
+		case '{':
+			return tk_lbrace;
+		case '}':
+			return tk_rbrace;
+		case '.':
+			return tk_period;
+		case '-':
+			return tk_minus;
+		case '+':
+			return tk_plus;
+		case '&':
+			return tk_amp;
+		case '*':
+			return tk_star;
+		case '~':
+			return tk_tilde;
+		case '!':
+			return tk_exclaim;
+		case '/':
+			return tk_slash;
+		case '%':
+			return tk_percent;
+		case '<':
+			return tk_less;
+		case '>':
+			return tk_greater;
+		case '=':
+			return tk_equal;
+		case '^':
+			return tk_caret;
+		case '|':
+			return tk_pipe;
+		case '?':
+			return tk_question;
+		case ':':
+			return tk_colon;
+		case ';':
+			return tk_semicolon;
+		case ',':
+			return tk_comma;
+		case '#':
+			return tk_hash;
+		default:
+			return tk_other;
+		}
+	}
+
+	ASSERT(len == 2, "Unexpected punctuator length");
+	if (str[1] == '=') {
+		switch (str[0]) {
+		case '<':
+			return tk_lessequal;
+		case '>':
+			return tk_greaterequal;
+		case '=':
+			return tk_equalequal;
+		case '!':
+			return tk_exclaimequal;
+		case '*':
+			return tk_starequal;
+		case '/':
+			return tk_slashequal;
+		case '%':
+			return tk_percentequal;
+		case '+':
+			return tk_plusequal;
+		case '-':
+			return tk_minusequal;
+		case '&':
+			return tk_ampequal;
+		case '^':
+			return tk_caretequal;
+		case '|':
+			return tk_pipeequal;
+		default:
+			return tk_other;
+		}
+	}
+	switch (str[0]) {
+	case '+':
+		return tk_plusplus;
+	case '-':
+		return tk_minusminus;
+	case '&':
+		return tk_ampamp;
+	case '|':
+		return tk_pipepipe;
+	default:
+		return tk_other;
+	}
+}
+
+/* Returns kind for a token which is not a punctuator,
+   token does not need to be null terminated
+   identifier_chars is 1 if all characters of the token are known to be
+   identifier characters */
+static TokenKind token_kind(const char* token, int len, int identifier_chars) {
+	char c = token[0];
+	if ('0' <= c && c <= '9') {
+		return tk_constant;
+	}
+
+	TokenKind kind = tok_classify(token, len);
+	if (kind != tk_identifier || identifier_chars) {
+		return kind;
+	}
+
+	for (int i = 0; i < len; ++i) {
+		c = token[i];
+		if (('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || c == '_' || ('0' <= c && c <= '9')) {
+			continue;
+		}
+		return tk_other;
+	}
+	return tk_identifier;
+}
+
+/* Sets token to be of given kind with spelling of len chars at str
+   The spelling is interned if the kind has no fixed spelling */
+static ErrorCode set_token(Lexer* lex, Token* tok, TokenKind kind, const char* str, int len) {
+	ErrorCode ecode;
+	tok->kind = kind;
+	tok->id = -1;
+	tok->str = token_kind_str[kind];
+
+	if (kind == tk_identifier || kind == tk_constant || kind == tk_other) {
+		if ((ecode = strpool_intern(&lex->pool, str, len, &tok->id)) != ec_noerr) return ecode;
+		tok->str = strpool_str(&lex->pool, tok->id);
+	}
+	return ec_noerr;
 }
 
-/* Fetches token into specified buffer index */
-static ErrorCode load_buf(Lexer* lex, int idx) {
+/* Lexes the next token in buf into tok
+   Number of characters in the token is stored at the provided pointer,
+   the token ends at buf_pos */
+static ErrorCode read_token(Lexer* lex, Token* tok, int* tok_len) {
 	ErrorCode ecode = ec_noerr;
 
-	char* buf = lex->get_buf[idx];
+	/* Skip leading whitespace and line markers, runs of blanks are
+	   skipped together */
+	char c;
+	while (1) {
+		if ((ecode = fill_window(lex)) != ec_noerr) goto exit;
 
-	char c = read_char(lex);
-	/* Skip leading whitespace */
-	while (iswhitespace(c = read_char(lex))) {
-		consume_char(lex);
+		c = read_char(lex);
+		if (c == '\n') {
+			consume_char(lex);
+		}
+		else if (iswhitespace(c)) {
+			consume_chars(lex, charscan_blank(lex->buf + lex->buf_pos, lex->buf_len - lex->buf_pos));
+		}
+		else if (c == '#' && at_line_marker(lex)) {
+			if ((ecode = consume_line(lex)) != ec_noerr) goto exit;
+		}
+		else {
+			break;
+		}
 	}
 
-	/* Handle punctuators
-	   sufficient space guaranteed to hold all punctuators*/
-	ASSERT(MAX_TOKEN_LEN >= 4, "Max token length must be at least 4 to hold C operators");
+	/* Token is read directly out of the input buffer, the window
+	   always holds an entire token */
+	const char* start = lex->buf + lex->buf_pos;
+	tok->loc = lex->buf_loc + lex->buf_pos;
+
+	/* Handle punctuators */
 	if (isofpunctuator(c)) {
 		char cn = read_char_next(lex);
 		/* <= >= == != *= /= %= += -= &= ^= |= */
 		if (cn == '=') {
-			buf[0] = c;
-			buf[1] = '=';
-			buf[2] = '\0';
 			consume_char(lex);
 			consume_char(lex);
+			*tok_len = 2;
+			ecode = set_token(lex, tok, punctuator_kind(start, 2), start, 2);
 			goto exit;
 		}
 
@@ -309,28 +693,27 @@ static ErrorCode load_buf(Lexer* lex, int idx) {
 		for (int i = 0; i < ARRAY_SIZE(chars); ++i) {
 			if (c == chars[i]) {
 				consume_char(lex);
-				buf[0] = chars[i];
+				int len = 1;
 				if (cn == chars[i]) {
 					consume_char(lex);
-					buf[1] = chars[i];
-					buf[2] = '\0';
-				}
-				else {
-					buf[1] = '\0';
+					len = 2;
 				}
+				*tok_len = len;
+				ecode = set_token(lex, tok, punctuator_kind(start, len), start, len);
 				goto exit;
 			}
 		}
 
 		/* TODO For now, treat everything else as token */
-		buf[0] = c;
-		buf[1] = '\0';
 		consume_char(lex);
+		*tok_len = 1;
+		ecode = set_token(lex, tok, punctuator_kind(start, 1), start, 1);
 		goto exit;
 	}
 
-	/* Handle others */
+	/* Handle others, runs of identifier characters are consumed together */
 	int i = 0;
+	int identifier_chars = 1;
 	while (c != EOF) {
 		if (iswhitespace(c) || isofpunctuator(c)) {
 			break;
@@ -338,14 +721,31 @@ static ErrorCode load_buf(Lexer* lex, int idx) {
 
 		if (i >= MAX_TOKEN_LEN) {
 			ecode = ec_lexer_tokbufexceed;
-			break; /* Since MAX_TOKEN_LEN excludes null terminator, we can break and add null terminator */
+			break;
 		}
-		buf[i] = c;
-		consume_char(lex);
+		int max_len = lex->buf_len - lex->buf_pos;
+		if (max_len > MAX_TOKEN_LEN - i) max_len = MAX_TOKEN_LEN - i;
+		int len = charscan_identifier(lex->buf + lex->buf_pos, max_len);
+		if (len == 0) {
+			/* Not an identifier character, e.g., " */
+			len = 1;
+			identifier_chars = 0;
+		}
+		consume_chars(lex, len);
 		c = read_char(lex);
-		++i;
+		i += len;
+	}
+
+	*tok_len = i;
+	if (i == 0) {
+		tok->kind = tk_eof;
+		tok->id = -1;
+		tok->str = token_kind_str[tk_eof];
+	}
+	else {
+		ErrorCode ec = set_token(lex, tok, token_kind(start, i, identifier_chars), start, i);
+		if (ecode == ec_noerr) ecode = ec;
 	}
-	buf[i] = '\0';
 
 exit:
 	return ecode;
@@ -354,50 +754,89 @@ exit:
 /* Loads buffers if their tokens have been consumed */
 static ErrorCode load_all_buf(Lexer* lex) {
 	ErrorCode ecode;
-	if (lex->get_buf[lex->primary][0] == '\0') {
-		if ((ecode = load_buf(lex, lex->primary)) != ec_noerr) return ecode;
-		lex->primary_length = strlength(lex->get_buf[lex->primary]);
-		lex->primary_line_num = lex->line_num;
-		lex->primary_char_num = lex->char_num - lex->primary_length;
-	}
-	if (lex->get_buf[lex->secondary][0] == '\0') {
-		if ((ecode = load_buf(lex, lex->secondary)) != ec_noerr) return ecode;
-		lex->secondary_length = strlength(lex->get_buf[lex->secondary]);
-		lex->secondary_line_num = lex->line_num;
-		lex->secondary_char_num = lex->char_num - lex->secondary_length;
+	int len;
+	if (lex->get_buf[lex->primary].str == NULL) {
+		if ((ecode = read_token(lex, &lex->get_buf[lex->primary], &len)) != ec_noerr) return ecode;
+	}
+	if (lex->get_buf[lex->secondary].str == NULL) {
+		if ((ecode = read_token(lex, &lex->get_buf[lex->secondary], &len)) != ec_noerr) return ecode;
 	}
 	return ec_noerr;
 }
 
-ErrorCode lexer_getc(Lexer* lex, const char** tok_ptr) {
+/* Fills tok with the token n tokens after the cursor in table,
+   positions past the end give the last token (tk_eof) */
+static void table_getc(const Lexer* lex, int n, Token* tok) {
+	int index = lex->cursor + n;
+	int last = vec_size(&lex->table.kind) - 1;
+	if (index > last) index = last;
+
+	tok->kind = vec_at(&lex->table.kind, index);
+	tok->id = vec_at(&lex->table.id, index);
+	tok->str = tok->id >= 0 ? strpool_str(&lex->pool, tok->id) : token_kind_str[tok->kind];
+	tok->loc = vec_at(&lex->table.loc, index);
+}
+
+ErrorCode lexer_getc(Lexer* lex, const Token** tok_ptr) {
 	ErrorCode ecode;
 
-	if ((ecode = load_all_buf(lex)) != ec_noerr) return ecode;
+	if (lex->pretokenized) {
+		table_getc(lex, 0, &lex->get_buf[lex->primary]);
+	}
+	else if ((ecode = load_all_buf(lex)) != ec_noerr) {
+		return ecode;
+	}
 
 	if (g_debug_print_parse_recursion) {
-		LOGF("%s\n", lex->get_buf[lex->primary]);
+		LOGF("%s\n", lex->get_buf[lex->primary].str);
 	}
 
-	*tok_ptr = lex->get_buf[lex->primary];
+	*tok_ptr = &lex->get_buf[lex->primary];
 	return ec_noerr;
 }
 
-ErrorCode lexer_getc2(Lexer* lex, const char** tok_ptr) {
+ErrorCode lexer_getc2(Lexer* lex, const Token** tok_ptr) {
 	ErrorCode ecode;
 
-	if ((ecode = load_all_buf(lex)) != ec_noerr) return ecode;
+	if (lex->pretokenized) {
+		table_getc(lex, 1, &lex->get_buf[lex->secondary]);
+	}
+	else if ((ecode = load_all_buf(lex)) != ec_noerr) {
+		return ecode;
+	}
 
 	if (g_debug_print_parse_recursion) {
-		LOGF("%s (Lookahead)\n", lex->get_buf[lex->secondary]);
+		LOGF("%s (Lookahead)\n", lex->get_buf[lex->secondary].str);
 	}
 
-	*tok_ptr = lex->get_buf[lex->secondary];
+	*tok_ptr = &lex->get_buf[lex->secondary];
+	return ec_noerr;
+}
+
+ErrorCode lexer_peek(Lexer* lex, int n, const Token** tok_ptr) {
+	ASSERT(n >= 0, "Cannot peek at consumed tokens");
+	if (!lex->pretokenized) {
+		ASSERT(n < 2, "Lexer without pretokenization only has 2 token lookahead");
+		return n == 0 ? lexer_getc(lex, tok_ptr) : lexer_getc2(lex, tok_ptr);
+	}
+
+	table_getc(lex, n, &lex->peek_buf);
+	*tok_ptr = &lex->peek_buf;
 	return ec_noerr;
 }
 
 /* Indicates the pointed to token is no longer in use */
 void lexer_consume(Lexer* lex) {
-	lex->get_buf[lex->primary][0] = '\0';
+	if (lex->pretokenized) {
+		/* Stay on tk_eof at the end */
+		if (lex->cursor < vec_size(&lex->table.kind) - 1) ++lex->cursor;
+		if (g_debug_print_parse_recursion) {
+			LOG("^Consumed\n");
+		}
+		return;
+	}
+
+	lex->get_buf[lex->primary].str = NULL;
 
 	/* Secondary buffer now primary
 	   as its token is the next one */
@@ -405,69 +844,382 @@ void lexer_consume(Lexer* lex) {
 	lex->secondary = lex->primary;
 	lex->primary = tmp;
 
-	lex->primary_line_num = lex->secondary_line_num;
-	lex->primary_char_num = lex->secondary_char_num;
-	lex->primary_length = lex->secondary_length;
-
 	if (g_debug_print_parse_recursion) {
 		LOG("^Consumed\n");
 	}
 }
 
-void lexer_print_location(Lexer* lex) {
-	char line_num_buf[10];
-	itostr(lex->primary_line_num, line_num_buf);
-	int line_num_len = strlength(line_num_buf);
+/* Appends token to the token table */
+static ErrorCode table_push(Lexer* lex, const Token* tok, int length) {
+	TokenTable* table = &lex->table;
+	if (!vec_push_back(&table->kind, tok->kind)) return ec_badalloc;
+	if (!vec_push_back(&table->id, tok->id)) return ec_badalloc;
+	if (!vec_push_back(&table->loc, tok->loc)) return ec_badalloc;
+	if (!vec_push_back(&table->length, length)) return ec_badalloc;
+	return ec_noerr;
+}
 
-	char char_num_buf[10];
-	itostr(lex->primary_char_num, char_num_buf);
-	int char_num_len = strlength(char_num_buf);
+/* Reserves space in the token table for n tokens */
+static ErrorCode table_reserve(TokenTable* table, int n) {
+	if (!vec_reserve(&table->kind, n)) return ec_badalloc;
+	if (!vec_reserve(&table->id, n)) return ec_badalloc;
+	if (!vec_reserve(&table->loc, n)) return ec_badalloc;
+	if (!vec_reserve(&table->length, n)) return ec_badalloc;
+	return ec_noerr;
+}
 
-	LOGF(" %s:%s | ", line_num_buf, char_num_buf);
+/* Lexes tokens from buf into the token table until tk_eof is added
+   Error from reading a token is stored at read_ecode, the token of the
+   error is the last token added */
+static ErrorCode table_fill(Lexer* lex, ErrorCode* read_ecode) {
+	ErrorCode ecode;
+	while (1) {
+		Token tok;
+		int len;
+		*read_ecode = read_token(lex, &tok, &len);
+		if ((ecode = table_push(lex, &tok, len)) != ec_noerr) return ecode;
 
-	/* Find start, end of line with primary token in line buffer */
-	int line_start = lex->line_buf_end;
-	int line_end = lex->line_buf_end; /* One past last character */
-	{
-		int line_num = lex->line_num;
-		while (1) {
-			if (line_start == lex->line_buf_front) {
-				LOG("Line too long to be displayed\n");
-				return;
-			}
+		if (*read_ecode != ec_noerr || tok.kind == tk_eof) return ec_noerr;
+	}
+}
 
-			--line_start;
-			if (line_start < 0) line_start = LEXER_LINE_BUF_SIZE - 1;
+/* Switches the lexer to read from the filled token table
+   Returns read_ecode, if an error, the location of the error is reported
+   at the bad token */
+static ErrorCode table_finish(Lexer* lex, ErrorCode read_ecode) {
+	lex->pretokenized = 1;
+	lex->cursor = read_ecode != ec_noerr ? vec_size(&lex->table.kind) - 1 : 0;
+	return read_ecode;
+}
 
-			if (lex->line_buf[line_start] == '\n') {
-				if (line_num == lex->primary_line_num) break;
-				--line_num;
-				line_end = line_start;
-			}
+ErrorCode lexer_tokenize(Lexer* lex) {
+	ASSERT(!lex->pretokenized, "Lexer already pretokenized");
+	ASSERT(lex->buf_loc + lex->buf_pos == 0, "Tokens already read from lexer");
+	ErrorCode ecode;
+
+	/* Tokens refer to the input for error messages */
+	lex->buf_keep = 1;
+
+	/* Estimate from average token length to avoid repeated resizing */
+	if ((ecode = table_reserve(&lex->table, lex->buf_len / 4 + 1)) != ec_noerr) return ecode;
+
+	ErrorCode read_ecode;
+	if ((ecode = table_fill(lex, &read_ecode)) != ec_noerr) return ecode;
+	return table_finish(lex, read_ecode);
+}
+
+/* Part of the input lexed by one thread in lexer_tokenize_parallel() */
+typedef struct
+{
+	/* Lexes the chunk out of the buf of the lexer being tokenized,
+	   has its own string pool and token table */
+	Lexer lex;
+	ErrorCode ecode;      /* Error building token table */
+	ErrorCode read_ecode; /* Error reading a token, e.g., token too long */
+} LexChunk;
+
+typedef struct
+{
+	LexChunk* chunks;
+	int chunk_count;
+	int next_chunk; /* Index of next chunk to lex, taken atomically */
+} LexChunkQueue;
+
+/* Lexes chunks from the queue until all chunks are taken */
+static void* lex_chunk_worker(void* arg) {
+	LexChunkQueue* queue = arg;
+	while (1) {
+		int i = __atomic_fetch_add(&queue->next_chunk, 1, __ATOMIC_RELAXED);
+		if (i >= queue->chunk_count) break;
+
+		LexChunk* chunk = &queue->chunks[i];
+		chunk->ecode = table_reserve(&chunk->lex.table, (chunk->lex.buf_len - chunk->lex.buf_pos) / 4 + 1);
+		if (chunk->ecode == ec_noerr) chunk->ecode = table_fill(&chunk->lex, &chunk->read_ecode);
+	}
+	return NULL;
+}
+
+/* Returns number of threads to lex count chunks with */
+static int lex_thread_count(int count) {
+	long threads = sysconf(_SC_NPROCESSORS_ONLN);
+	if (threads < 1) threads = 1;
+	if (threads > LEXER_MAX_THREADS) threads = LEXER_MAX_THREADS;
+	if (threads > count) threads = count;
+	return (int)threads;
+}
+
+/* Appends tokens of chunk to the token table, spellings are interned
+   into the lexer's string pool and their ids are remapped
+   keep_eof is 1 to append the tk_eof ending the chunk */
+static ErrorCode table_append_chunk(Lexer* lex, LexChunk* chunk, int keep_eof) {
+	ErrorCode ecode = ec_noerr;
+
+	/* Indexed by id in the chunk's string pool */
+	StrPool* pool = &chunk->lex.pool;
+	vec_t(StrId) remap;
+	vec_construct(&remap);
+	for (StrId id = 0; id < strpool_size(pool); ++id) {
+		StrId new_id;
+		if ((ecode = strpool_intern(&lex->pool, strpool_str(pool, id), strpool_len(pool, id), &new_id)) != ec_noerr) {
+			goto exit;
+		}
+		if (!vec_push_back(&remap, new_id)) {
+			ecode = ec_badalloc;
+			goto exit;
 		}
-		/* Loop finishes on newline, move it to next char */
-		line_start = (line_start + 1) % LEXER_LINE_BUF_SIZE;
 	}
 
-	/* Print out line */
-	for (int i = line_start; i != line_end; i = (i + 1) % LEXER_LINE_BUF_SIZE) {
-		LOGF("%c", lex->line_buf[i]);
+	TokenTable* table = &chunk->lex.table;
+	int count = vec_size(&table->kind);
+	if (!keep_eof && chunk->read_ecode == ec_noerr) --count;
+	for (int i = 0; i < count; ++i) {
+		Token tok;
+		tok.kind = vec_at(&table->kind, i);
+		tok.id = vec_at(&table->id, i);
+		if (tok.id >= 0) tok.id = vec_at(&remap, tok.id);
+		tok.loc = vec_at(&table->loc, i);
+		if ((ecode = table_push(lex, &tok, vec_at(&table->length, i))) != ec_noerr) goto exit;
 	}
-	LOG("\n");
 
-	/* Underline the token */
+exit:
+	vec_destruct(&remap);
+	return ecode;
+}
+
+ErrorCode lexer_tokenize_parallel(Lexer* lex, int chunk_size) {
+	ASSERT(!lex->pretokenized, "Lexer already pretokenized");
+	ASSERT(lex->buf_loc + lex->buf_pos == 0, "Tokens already read from lexer");
+	ASSERT(chunk_size > 0, "Invalid chunk size");
+	ErrorCode ecode = ec_noerr;
+
+	LexChunkQueue queue = {NULL, 0, 0};
+
+	/* The chunks are split from the entire input */
+	lex->buf_keep = 1;
+	while (lex->rf != NULL && !lex->rf_eof) {
+		if ((ecode = slide_window(lex)) != ec_noerr) goto exit;
+	}
+
+	queue.chunks = cmalloc(sizeof(LexChunk) * (size_t)(lex->buf_len / chunk_size + 1));
+	if (queue.chunks == NULL) {
+		ecode = ec_badalloc;
+		goto exit;
+	}
+
+	/* Chunks end after a newline, tokens do not contain newlines and a
+	   line marker always starts after a newline, so lexing a chunk gives
+	   the same tokens as lexing it as part of the entire input */
+	int begin = 0;
+	do {
+		int end = lex->buf_len;
+		if (lex->buf_len - begin > chunk_size) {
+			const char* newline =
+				memchr(lex->buf + begin + chunk_size, '\n', (size_t)(lex->buf_len - begin - chunk_size));
+			if (newline != NULL) end = (int)(newline - lex->buf) + 1;
+		}
+
+		LexChunk* chunk = &queue.chunks[queue.chunk_count];
+		if ((ecode = lexer_init(&chunk->lex)) != ec_noerr) goto exit;
+		++queue.chunk_count;
+		chunk->lex.buf = lex->buf;
+		chunk->lex.buf_len = end;
+		chunk->lex.buf_capacity = end;
+		chunk->lex.buf_pos = begin;
+		chunk->ecode = ec_noerr;
+		chunk->read_ecode = ec_noerr;
+
+		begin = end;
+	} while (begin < lex->buf_len);
+
+	/* The scanning level is chosen on first use, choose it before the
+	   threads read it */
+	(void)charscan_level();
+
+	/* Calling thread also lexes chunks, if a thread cannot be created
+	   the remaining threads lex its chunks */
+	pthread_t threads[LEXER_MAX_THREADS];
+	int thread_count = 0;
+	for (int i = 1; i < lex_thread_count(queue.chunk_count); ++i) {
+		if (pthread_create(&threads[thread_count], NULL, lex_chunk_worker, &queue) != 0) break;
+		++thread_count;
+	}
+	lex_chunk_worker(&queue);
+	for (int i = 0; i < thread_count; ++i) {
+		pthread_join(threads[i], NULL);
+	}
+
+	/* Ids are given to spellings in order of first appearance, interning
+	   the spellings of each chunk in order gives the same ids as lexing
+	   the entire input at once */
+	int estimate = 0;
+	for (int i = 0; i < queue.chunk_count; ++i) {
+		estimate += vec_size(&queue.chunks[i].lex.table.kind);
+	}
+	if ((ecode = table_reserve(&lex->table, estimate)) != ec_noerr) goto exit;
 
+	ErrorCode read_ecode = ec_noerr;
+	for (int i = 0; i < queue.chunk_count; ++i) {
+		LexChunk* chunk = &queue.chunks[i];
+		if ((ecode = chunk->ecode) != ec_noerr) goto exit;
+		if ((ecode = table_append_chunk(lex, chunk, i == queue.chunk_count - 1)) != ec_noerr) goto exit;
+
+		/* Tokens after the error are not lexed */
+		read_ecode = chunk->read_ecode;
+		if (read_ecode != ec_noerr) break;
+	}
+	ecode = table_finish(lex, read_ecode);
+
+exit:
+	for (int i = 0; i < queue.chunk_count; ++i) {
+		/* buf belongs to lex */
+		queue.chunks[i].lex.buf = NULL;
+		lexer_destruct(&queue.chunks[i].lex);
+	}
+	if (queue.chunks != NULL) cfree(queue.chunks);
+	return ecode;
+}
+
+int lexer_mark(const Lexer* lex) {
+	ASSERT(lex->pretokenized, "Lexer must be pretokenized to mark");
+	return lex->cursor;
+}
+
+void lexer_rewind(Lexer* lex, int mark) {
+	ASSERT(lex->pretokenized, "Lexer must be pretokenized to rewind");
+	ASSERT(0 <= mark && mark < vec_size(&lex->table.kind), "Invalid mark");
+	lex->cursor = mark;
+}
+
+/* Prints the line number and char number for lexer_print_location()
+   Returns number of characters printed before the '|' */
+static int print_location_prefix(int line_num, int char_num) {
+	char line_num_buf[10];
+	itostr(line_num, line_num_buf);
+	int line_num_len = strlength(line_num_buf);
+
+	char char_num_buf[10];
+	itostr(char_num, char_num_buf);
+	int char_num_len = strlength(char_num_buf);
+
+	LOGF(" %s:%s | ", line_num_buf, char_num_buf);
+	return line_num_len + char_num_len + 3;
+}
+
+/* Underlines the token for lexer_print_location(), column is the
+   position of the token in the printed line starting at 1 */
+static void print_location_underline(int prefix_len, int column, int length) {
 	/* Align the '|' to the previous one */
-	for (int i = 0; i < line_num_len + char_num_len + 3; ++i) {
+	for (int i = 0; i < prefix_len; ++i) {
 		LOGF(" ");
 	}
 	LOG("| ");
-	/* -1 as char_num starts at 1, not zero */
-	for (int i = 0; i < lex->primary_char_num - 1; ++i) {
+	/* -1 as column starts at 1, not zero */
+	for (int i = 0; i < column - 1; ++i) {
 		LOG(" ");
 	}
-	for (int i = 0; i < lex->primary_length; ++i) {
+	for (int i = 0; i < length; ++i) {
 		LOG("~");
 	}
 	LOG("\n");
 }
+
+/* Builds the line start table of the window for lexer_location() */
+static ErrorCode build_lines(Lexer* lex) {
+	vec_clear(&lex->line_start);
+	vec_clear(&lex->line_num);
+
+	/* First line may begin before the window */
+	int line_num = lex->buf_line_num;
+	SrcLoc start = lex->buf_loc - (lex->buf_char_num - 1);
+	while (1) {
+		if (!vec_push_back(&lex->line_start, start)) return ec_badalloc;
+
+		/* Line marker gives line number of next line
+		   # 5 "file.c" */
+		int i = start - lex->buf_loc;
+		if (i >= 0 && i + 2 <= lex->buf_len && lex->buf[i] == '#') {
+			const char* c = lex->buf + i + 2;
+			line_num = 0;
+			while ('0' <= *c && *c <= '9') {
+				line_num = line_num * 10 + (*c - '0');
+				++c;
+			}
+			if (!vec_push_back(&lex->line_num, line_num)) return ec_badalloc;
+		}
+		else {
+			if (!vec_push_back(&lex->line_num, line_num)) return ec_badalloc;
+			++line_num;
+		}
+
+		if (i < 0) i = 0;
+		const char* newline = memchr(lex->buf + i, '\n', (size_t)(lex->buf_len - i));
+		if (newline == NULL) break;
+		start = lex->buf_loc + (SrcLoc)(newline - lex->buf) + 1;
+	}
+
+	lex->lines_built = 1;
+	return ec_noerr;
+}
+
+/* Returns index of line containing loc */
+static int find_line(Lexer* lex, SrcLoc loc) {
+	int low = 0;
+	int high = vec_size(&lex->line_start) - 1;
+	while (low < high) {
+		int mid = low + (high - low + 1) / 2;
+		if (vec_at(&lex->line_start, mid) <= loc) {
+			low = mid;
+		}
+		else {
+			high = mid - 1;
+		}
+	}
+	return low;
+}
+
+ErrorCode lexer_location(Lexer* lex, SrcLoc loc, int* line_num, int* char_num) {
+	ASSERT(loc <= lex->buf_loc + lex->buf_len, "Invalid source location");
+	ErrorCode ecode;
+	if (loc < lex->buf_loc) return ec_lexer_locunavailable;
+
+	if (!lex->lines_built) {
+		if ((ecode = build_lines(lex)) != ec_noerr) return ecode;
+	}
+
+	int line = find_line(lex, loc);
+	*line_num = vec_at(&lex->line_num, line);
+	*char_num = loc - vec_at(&lex->line_start, line) + 1;
+	return ec_noerr;
+}
+
+void lexer_print_location(Lexer* lex) {
+	/* Location of the next token */
+	SrcLoc loc = lex->buf_loc + lex->buf_pos;
+	int length = 0;
+	if (lex->pretokenized) {
+		loc = vec_at(&lex->table.loc, lex->cursor);
+		length = vec_at(&lex->table.length, lex->cursor);
+	}
+	else if (lex->get_buf[lex->primary].str != NULL) {
+		loc = lex->get_buf[lex->primary].loc;
+		length = strlength(lex->get_buf[lex->primary].str);
+	}
+
+	int line_num;
+	int char_num;
+	if (lexer_location(lex, loc, &line_num, &char_num) != ec_noerr) {
+		LOG("Failed to find location\n");
+		return;
+	}
+
+	/* Start of line may no longer be in the window */
+	int line_begin = loc - lex->buf_loc - (char_num - 1);
+	if (line_begin < 0) line_begin = 0;
+	const char* line = lex->buf + line_begin;
+	const char* line_end = memchr(line, '\n', (size_t)(lex->buf_len - line_begin));
+	if (line_end == NULL) line_end = lex->buf + lex->buf_len;
+
+	int prefix_len = print_location_prefix(line_num, char_num);
+	LOGF("%.*s\n", (int)(line_end - line), line);
+	print_location_underline(prefix_len, loc - lex->buf_loc - line_begin + 1, length);
+}
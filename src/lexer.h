@@ -5,12 +5,190 @@
 #ifndef LEXER_H
 #define LEXER_H
 
+#include <stdint.h>
 #include <stdio.h>
 
 #include "constant.h"
 #include "errorcode.h"
+#include "strpool.h"
+#include "vec.h"
 
-#define LEXER_LINE_BUF_SIZE 128 // Holds specified number-1 characters
+/* Size of window into input when streaming */
+#define LEXER_WINDOW_SIZE 65536
+/* Characters which must be in the window after the read position
+   before a token is read, a token always fits */
+#define LEXER_WINDOW_LOOKAHEAD (MAX_TOKEN_LEN + 2)
+
+/* Approximate size of the chunks lexed by each thread with
+   lexer_tokenize_parallel() */
+#define LEXER_CHUNK_SIZE (1 << 20)
+/* Most threads used by lexer_tokenize_parallel() */
+#define LEXER_MAX_THREADS 16
+
+/* Grouping of token kinds, a kind belongs to exactly one class */
+typedef enum
+{
+	/* Spelling comes from the source */
+	tc_none = 0,
+	/* Keyword which is not part of a class below */
+	tc_keyword,
+	tc_storeclass,
+	tc_typespec,
+	tc_typequal,
+	tc_funcspec,
+	/* Punctuator which is not part of a class below */
+	tc_punctuator,
+	tc_assignop
+} TokenClass;
+
+/* TOKEN_KIND(name, spelling, class)
+   Keywords and punctuators have a fixed spelling, the spelling of the
+   remaining kinds comes from the source
+   Keywords are ordered by spelling */
+#define TOKEN_KINDS                                  \
+	TOKEN_KIND(eof, "", none)                        \
+	TOKEN_KIND(identifier, "", none)                 \
+	TOKEN_KIND(constant, "", none)                   \
+	TOKEN_KIND(other, "", none)                      \
+                                                     \
+	TOKEN_KIND(bool, "_Bool", keyword)               \
+	TOKEN_KIND(complex, "_Complex", keyword)         \
+	TOKEN_KIND(imaginary, "_Imaginary", keyword)     \
+	TOKEN_KIND(auto, "auto", storeclass)             \
+	TOKEN_KIND(break, "break", keyword)              \
+	TOKEN_KIND(case, "case", keyword)                \
+	TOKEN_KIND(char, "char", typespec)               \
+	TOKEN_KIND(const, "const", typequal)             \
+	TOKEN_KIND(continue, "continue", keyword)        \
+	TOKEN_KIND(default, "default", keyword)          \
+	TOKEN_KIND(do, "do", keyword)                    \
+	TOKEN_KIND(double, "double", typespec)           \
+	TOKEN_KIND(else, "else", keyword)                \
+	TOKEN_KIND(enum, "enum", keyword)                \
+	TOKEN_KIND(extern, "extern", storeclass)         \
+	TOKEN_KIND(float, "float", typespec)             \
+	TOKEN_KIND(for, "for", keyword)                  \
+	TOKEN_KIND(goto, "goto", keyword)                \
+	TOKEN_KIND(if, "if", keyword)                    \
+	TOKEN_KIND(inline, "inline", funcspec)           \
+	TOKEN_KIND(int, "int", typespec)                 \
+	TOKEN_KIND(long, "long", typespec)               \
+	TOKEN_KIND(register, "register", storeclass)     \
+	TOKEN_KIND(restrict, "restrict", typequal)       \
+	TOKEN_KIND(return, "return", keyword)            \
+	TOKEN_KIND(short, "short", typespec)             \
+	TOKEN_KIND(signed, "signed", typespec)           \
+	TOKEN_KIND(sizeof, "sizeof", keyword)            \
+	TOKEN_KIND(static, "static", storeclass)         \
+	TOKEN_KIND(struct, "struct", keyword)            \
+	TOKEN_KIND(switch, "switch", keyword)            \
+	TOKEN_KIND(typedef, "typedef", storeclass)       \
+	TOKEN_KIND(union, "union", keyword)              \
+	TOKEN_KIND(unsigned, "unsigned", typespec)       \
+	TOKEN_KIND(void, "void", typespec)               \
+	TOKEN_KIND(volatile, "volatile", typequal)       \
+	TOKEN_KIND(while, "while", keyword)              \
+                                                     \
+	TOKEN_KIND(lbracket, "[", punctuator)            \
+	TOKEN_KIND(rbracket, "]", punctuator)            \
+	TOKEN_KIND(lparen, "(", punctuator)              \
+	TOKEN_KIND(rparen, ")", punctuator)              \
+	TOKEN_KIND(lbrace, "{", punctuator)              \
+	TOKEN_KIND(rbrace, "}", punctuator)              \
+	TOKEN_KIND(period, ".", punctuator)              \
+	TOKEN_KIND(plus, "+", punctuator)                \
+	TOKEN_KIND(plusplus, "++", punctuator)           \
+	TOKEN_KIND(minus, "-", punctuator)               \
+	TOKEN_KIND(minusminus, "--", punctuator)         \
+	TOKEN_KIND(amp, "&", punctuator)                 \
+	TOKEN_KIND(ampamp, "&&", punctuator)             \
+	TOKEN_KIND(pipe, "|", punctuator)                \
+	TOKEN_KIND(pipepipe, "||", punctuator)           \
+	TOKEN_KIND(star, "*", punctuator)                \
+	TOKEN_KIND(tilde, "~", punctuator)               \
+	TOKEN_KIND(exclaim, "!", punctuator)             \
+	TOKEN_KIND(slash, "/", punctuator)               \
+	TOKEN_KIND(percent, "%", punctuator)             \
+	TOKEN_KIND(less, "<", punctuator)                \
+	TOKEN_KIND(greater, ">", punctuator)             \
+	TOKEN_KIND(caret, "^", punctuator)               \
+	TOKEN_KIND(question, "?", punctuator)            \
+	TOKEN_KIND(colon, ":", punctuator)               \
+	TOKEN_KIND(semicolon, ";", punctuator)           \
+	TOKEN_KIND(comma, ",", punctuator)               \
+	TOKEN_KIND(hash, "#", punctuator)                \
+	TOKEN_KIND(lessequal, "<=", punctuator)          \
+	TOKEN_KIND(greaterequal, ">=", punctuator)       \
+	TOKEN_KIND(equalequal, "==", punctuator)         \
+	TOKEN_KIND(exclaimequal, "!=", punctuator)       \
+	TOKEN_KIND(equal, "=", assignop)                 \
+	TOKEN_KIND(starequal, "*=", assignop)            \
+	TOKEN_KIND(slashequal, "/=", assignop)           \
+	TOKEN_KIND(percentequal, "%=", assignop)         \
+	TOKEN_KIND(plusequal, "+=", assignop)            \
+	TOKEN_KIND(minusequal, "-=", assignop)           \
+	TOKEN_KIND(lesslessequal, "<<=", assignop)       \
+	TOKEN_KIND(greatergreaterequal, ">>=", assignop) \
+	TOKEN_KIND(ampequal, "&=", assignop)             \
+	TOKEN_KIND(caretequal, "^=", assignop)           \
+	TOKEN_KIND(pipeequal, "|=", assignop)
+
+#define TOKEN_KIND(name__, str__, class__) tk_##name__,
+typedef enum
+{
+	TOKEN_KINDS tk_count
+} TokenKind;
+#undef TOKEN_KIND
+
+/* Returns the fixed spelling of a token kind, empty string if the
+   kind does not have a fixed spelling */
+const char* tk_str(TokenKind kind);
+
+/* Returns the class of a token kind */
+TokenClass tk_class(TokenKind kind);
+
+/* Classifies an identifier-like token of len chars, token does not need
+   to be null terminated
+   Returns the keyword's kind if token is a keyword, tk_identifier otherwise */
+TokenKind tok_classify(const char* token, int len);
+
+/* Returns 1 if token kind is a keyword, 0 otherwise */
+int tk_iskeyword(TokenKind kind);
+
+/* Returns 1 if token kind is a storage class keyword, 0 otherwise */
+int tk_isstoreclass(TokenKind kind);
+
+/* Returns 1 if token kind is a type specifier keyword, 0 otherwise */
+int tk_istypespec(TokenKind kind);
+
+/* Returns 1 if token kind is a type qualifier keyword, 0 otherwise */
+int tk_istypequal(TokenKind kind);
+
+/* Returns 1 if token kind is a function specifier keyword, 0 otherwise */
+int tk_isfuncspec(TokenKind kind);
+
+/* Returns 1 if token kind is a keyword which begins declaration-specifiers,
+   i.e., a storage class, type specifier, type qualifier or function
+   specifier, 0 otherwise */
+int tk_isdeclspec(TokenKind kind);
+
+/* Returns 1 if token kind is an assignment operator, 0 otherwise */
+int tk_isassignmentop(TokenKind kind);
+
+/* Location in source file, index of character in the lexer's buffer
+   Converted to a line and character number with lexer_location() */
+typedef int32_t SrcLoc;
+
+typedef struct
+{
+	TokenKind kind;
+	/* Id of spelling in the lexer's string pool, only for identifier,
+	   constant and other. -1 otherwise */
+	StrId id;
+	/* Null terminated spelling, valid until lexer is destructed */
+	const char* str;
+	SrcLoc loc; /* First character of token */
+} Token;
 
 /* Returns 1 if character is part of a punctuator */
 int isofpunctuator(char c);
@@ -21,80 +199,133 @@ int tok_iskeyword(const char* token);
 /* Returns 1 if string is considered a unary operator */
 int tok_isunaryop(const char* str);
 
-/* Returns if token is considered an assignment operator */
-int tok_isassignmentop(const char* token);
-
-/* Returns 1 if token c string is a storage class keyword, 0 otherwise */
-int tok_isstoreclass(const char* str);
-
-/* Returns 1 if token c string is a type specifier keyword, 0 otherwise */
-int tok_istypespec(const char* str);
-
-/* Returns 1 if token c string is a type qualifier keyword, 0 otherwise */
-int tok_istypequal(const char* str);
-
-/* Returns 1 if token c string is a function specifier keyword, 0 otherwise */
-int tok_isfuncspec(const char* str);
-
 /* Returns 1 if token c string is an identifier */
 int tok_isidentifier(const char* str);
 
+/* Tokens of the entire input file, structure of arrays indexed by
+   the position of the token within the file
+   Last token is always tk_eof */
 typedef struct
 {
-	/* Input file */
-	FILE* rf;
+	vec_t(TokenKind) kind;
+	vec_t(StrId) id;   /* -1 if kind has fixed spelling */
+	vec_t(SrcLoc) loc; /* First character of token */
+	vec_t(int) length; /* Characters in spelling */
+} TokenTable;
 
-	/* Tracks position within input file for error messages */
-	int line_num;
-	int char_num;
+typedef struct
+{
+	/* Input is read into memory, tokens are lexed from here
+	   buf is null terminated, buf[buf_len] == '\0'
+	   For an input file, buf holds the entire file
+	   For an input stream, buf is a window into the input which slides
+	   forward as tokens are read */
+	char* buf;
+	int buf_len;
+	int buf_capacity; /* Excluding null terminator */
+	int buf_pos;      /* Index of next character to read in buf */
+
+	/* Stream the window is read from, NULL if buf holds entire input */
+	FILE* rf;
+	int rf_eof;
+	/* If 1, the window grows instead of sliding */
+	int buf_keep;
 
-	/* Circular buffer for current line */
-	char line_buf[LEXER_LINE_BUF_SIZE];
-	int line_buf_front;
-	int line_buf_end;
+	/* Location, line number and character number of buf[0] */
+	SrcLoc buf_loc;
+	int buf_line_num;
+	int buf_char_num;
 
-	/* Location of primary and secondary tokens */
-	int primary_line_num;
-	int primary_char_num;
-	int primary_length;
+	/* Lines of buf, only built when a location is requested by
+	   lexer_location() as it is only needed for error messages
+	   Rebuilt after the window slides */
+	int lines_built;
+	vec_t(SrcLoc) line_start; /* First character of each line */
+	vec_t(int) line_num;      /* Line number set by line markers */
 
-	int secondary_line_num;
-	int secondary_char_num;
-	int secondary_length;
+	/* Spellings of identifiers, constants and others */
+	StrPool pool;
 
 	/* The read token is kept here, subsequent calls to lexer_getc()
 	   will return this.
 	   When lexer_consume() is called, the next call to lexer_getc()
 	   will fill this buffer with a new token
-	   2 buffers for 2 token lookahead */
-	char get_buf[2][MAX_TOKEN_LEN + 1];
+	   2 buffers for 2 token lookahead
+	   The str of a token is null if it has not been loaded */
+	Token get_buf[2];
 	/* Index in get_buf for primary buffer (next token) */
 	int primary;
 	int secondary;
+
+	/* Set by lexer_tokenize(), tokens are read from table instead
+	   of being lexed from buf on demand */
+	int pretokenized;
+	TokenTable table;
+	int cursor; /* Index in table of next token */
+	Token peek_buf;
 } Lexer;
 
 /* Initializes lexer lexer object at memory
+   The input file at filepath is read into memory in its entirety
    Returns zero if success, non-zero if error */
 ErrorCode lexer_construct(Lexer* lex, const char* filepath);
 
+/* Initializes lexer lexer object at memory
+   Input is read from the stream rf as tokens are needed, through a
+   window of bounded size. rf is not closed by the lexer
+   Returns zero if success, non-zero if error */
+ErrorCode lexer_construct_stream(Lexer* lex, FILE* rf);
+
 /* Destructs lexer object at memory */
 void lexer_destruct(Lexer* lex);
 
-/* Reads a token (c = char*)
+/* Reads a token
    The pointer to token is stored the the provided pointer
-   The token is blank (just a null terminator)
+   The token is of kind tk_eof with a blank spelling
    if end of file is reached or error happened */
-ErrorCode lexer_getc(Lexer* lex, const char** tok_ptr);
+ErrorCode lexer_getc(Lexer* lex, const Token** tok_ptr);
 
-/* Reads token after next (c = char*)
+/* Reads token after next
    The pointer to token is stored the the provided pointer
-   The token is blank (just a null terminator)
+   The token is of kind tk_eof with a blank spelling
    if end of file is reached or error happened */
-ErrorCode lexer_getc2(Lexer* lex, const char** tok_ptr);
+ErrorCode lexer_getc2(Lexer* lex, const Token** tok_ptr);
+
+/* Reads token n tokens ahead, n = 0 is the next token
+   The pointer to token is stored the the provided pointer and is valid
+   until the next call to lexer_peek()
+   If not pretokenized, only n = 0 and n = 1 are supported */
+ErrorCode lexer_peek(Lexer* lex, int n, const Token** tok_ptr);
 
 /* Discard the last read token, next token will be next token in stream */
 void lexer_consume(Lexer* lex);
 
+/* Lexes the entire input file into the token table, must be called
+   before any tokens are read
+   For an input stream, the entire input is kept in memory */
+ErrorCode lexer_tokenize(Lexer* lex);
+
+/* Same as lexer_tokenize(), gives the same token table
+   The input is split into chunks of about chunk_size characters at
+   newlines, which are lexed on multiple threads */
+ErrorCode lexer_tokenize_parallel(Lexer* lex, int chunk_size);
+
+/* Returns a mark for the current position in the token stream, the lexer
+   can be rewound to it with lexer_rewind()
+   Lexer must be pretokenized */
+int lexer_mark(const Lexer* lex);
+
+/* Moves the lexer to position at mark, the next token read is the token
+   which was next when the mark was made
+   Lexer must be pretokenized */
+void lexer_rewind(Lexer* lex, int mark);
+
+/* Computes the line number and character number of loc, stored at
+   the provided pointers
+   Line numbers follow the line markers from the preprocessor
+   For an input stream, loc must still be in the window */
+ErrorCode lexer_location(Lexer* lex, SrcLoc loc, int* line_num, int* char_num);
+
 /* Prints out the current location of the Lexer within the source file
    Example:
    73 | void lexer_consume(Lexer* lex);
@@ -1,10 +1,15 @@
 /* Entry point of compiler */
 
+#include <time.h>
+
 #include "common.h"
 
+#include "copyprop.h"
 #include "globals.h"
 #include "il2gen.h"
 #include "parser.h"
+#include "sccp.h"
+#include "ssa.h"
 
 typedef struct
 {
@@ -31,9 +36,19 @@ static ErrorCode flags_destruct(Flags* f) {
    Order by option string, see strbinfind for ordering requirements */
 #define SWITCH_OPTIONS                                                    \
 	SWITCH_OPTION(-dprint-cfg, g_debug_print_cfg)                         \
+	SWITCH_OPTION(-dprint-dom, g_debug_print_dom)                         \
+	SWITCH_OPTION(-dprint-lex-throughput, g_debug_print_lex_throughput)   \
 	SWITCH_OPTION(-dprint-parse-recursion, g_debug_print_parse_recursion) \
+	SWITCH_OPTION(-dprint-parse-stats, g_debug_print_parse_stats)         \
+	SWITCH_OPTION(-dprint-ssa, g_debug_print_ssa)                         \
 	SWITCH_OPTION(-dprint-symtab, g_debug_print_symtab)                   \
-	SWITCH_OPTION(-dprint-tree, g_debug_print_tree)
+	SWITCH_OPTION(-dprint-tree, g_debug_print_tree)                       \
+	SWITCH_OPTION(-dprint-tree-stats, g_debug_print_tree_stats)           \
+	SWITCH_OPTION(-dprofile-parse, g_debug_profile_parse)                 \
+	SWITCH_OPTION(-fno-optimize, g_no_optimize)                           \
+	SWITCH_OPTION(-fparallel-lex, g_parallel_lex)                         \
+	SWITCH_OPTION(-fper-function, g_per_function)                         \
+	SWITCH_OPTION(-fpretokenize, g_pretokenize)
 
 #define SWITCH_OPTION(str__, var__) #str__,
 const char* option_switch_str[] = {SWITCH_OPTIONS};
@@ -96,6 +111,176 @@ static ErrorCode handle_cli_arg(Flags* f, int argc, char** argv) {
 	return ecode;
 }
 
+/* Lexes the entire input file into the token table, on multiple
+   threads if enabled */
+static ErrorCode tokenize(Lexer* lex) {
+	if (g_parallel_lex) return lexer_tokenize_parallel(lex, LEXER_CHUNK_SIZE);
+	return lexer_tokenize(lex);
+}
+
+/* Returns seconds of wall time since an unspecified point, lexing may
+   use multiple threads so processor time is not used */
+static double wall_seconds(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (double)ts.tv_sec + (double)ts.tv_nsec / 1e9;
+}
+
+/* Lexes the entire input file in a separate pass and prints the
+   throughput of the lexer */
+static ErrorCode print_lex_throughput(const char* path) {
+	ErrorCode ecode;
+
+	Lexer lex;
+	if ((ecode = lexer_construct(&lex, path)) != ec_noerr) return ecode;
+
+	int tokens = 0;
+	double start = wall_seconds();
+	if (g_pretokenize || g_parallel_lex) {
+		if ((ecode = tokenize(&lex)) != ec_noerr) goto exit;
+		tokens = vec_size(&lex.table.kind) - 1; /* Excludes tk_eof */
+	}
+	else {
+		while (1) {
+			const Token* token;
+			if ((ecode = lexer_getc(&lex, &token)) != ec_noerr) goto exit;
+			if (token->kind == tk_eof) break;
+			lexer_consume(&lex);
+			++tokens;
+		}
+	}
+	double seconds = wall_seconds() - start;
+	double mb = (double)lex.buf_len / (1024.0 * 1024.0);
+	LOGF("Lexer: %d bytes, %d tokens, %.6f s", lex.buf_len, tokens, seconds);
+	if (seconds > 0) {
+		LOGF(", %.2f MB/s", mb / seconds);
+	}
+	LOG("\n");
+
+exit:
+	lexer_destruct(&lex);
+	return ecode;
+}
+
+/* Converts the IL2 of the cfg into SSA form, runs the passes over it,
+   then converts it back so it can be written
+   The IL2 is left as generated with -fno-optimize */
+static ErrorCode optimize(Cfg* cfg, Symtab* stab) {
+	ErrorCode ecode;
+	if (g_no_optimize) return ec_noerr;
+
+	Ssa ssa;
+	if ((ecode = ssa_construct(&ssa)) != ec_noerr) return ecode;
+	Sccp sccp;
+	if ((ecode = sccp_construct(&sccp)) != ec_noerr) goto exit1;
+	CopyProp cp;
+	if ((ecode = copyprop_construct(&cp)) != ec_noerr) goto exit2;
+
+	if ((ecode = ssa_convert(&ssa, cfg)) != ec_noerr) goto exit3;
+
+	if (g_debug_print_dom) {
+		debug_print_dom(&ssa);
+	}
+	if (g_debug_print_ssa) {
+		debug_print_ssa(&ssa);
+	}
+
+	ecode = sccp_run(&sccp, &ssa, stab);
+	ssa_revert(&ssa);
+	if (ecode != ec_noerr) goto exit3;
+
+	/* Folding leaves the phis of sccp's ssa behind, the ssa is rebuilt
+	   for the blocks and copies remaining */
+	if ((ecode = ssa_convert(&ssa, cfg)) != ec_noerr) goto exit3;
+	ecode = copyprop_run(&cp, &ssa);
+	ssa_revert(&ssa);
+
+exit3:
+	copyprop_destruct(&cp);
+exit2:
+	sccp_destruct(&sccp);
+exit1:
+	ssa_destruct(&ssa);
+	return ecode;
+}
+
+/* Generates and writes IL2 for the external declaration in the tree
+   Symbols of the external declaration are from index first_symbol of
+   the symbol table onwards */
+static ErrorCode compile_function(Parser* p, Cfg* cfg, FILE* f, int first_symbol) {
+	ErrorCode ecode;
+
+	FlatTree ftree;
+	if ((ecode = flat_tree_construct(&ftree, p->tree)) != ec_noerr) return ecode;
+
+	IL2Gen il2;
+	if ((ecode = il2_construct(&il2, cfg, p->symtab, &ftree)) != ec_noerr) goto exit1;
+
+	if ((ecode = il2_gen(&il2)) != ec_noerr) {
+		ERRMSG("Failed to generate IL2\n");
+		goto exit2;
+	}
+
+	if (g_debug_print_cfg) {
+		debug_print_cfg(cfg);
+	}
+
+	if ((ecode = optimize(cfg, p->symtab)) != ec_noerr) goto exit2;
+
+	ecode = il2_write_function(&il2, f, first_symbol);
+
+exit2:
+	il2_destruct(&il2);
+exit1:
+	flat_tree_destruct(&ftree);
+	return ecode;
+}
+
+/* Parses, generates and writes IL2 for one external declaration at a
+   time, its nodes, blocks and symbols are released once its IL2 is
+   written so memory used is bounded by the largest function */
+static ErrorCode compile_per_function(Parser* p, const char* output_path) {
+	ErrorCode ecode;
+
+	FILE* f = fopen(output_path, "w");
+	if (f == NULL) {
+		ERRMSG("Failed to open output file\n");
+		return ec_writefailed;
+	}
+
+	Cfg cfg;
+	if ((ecode = cfg_construct(&cfg)) != ec_noerr) goto exit;
+
+	/* File scope */
+	if ((ecode = symtab_push_scope(p->symtab)) != ec_noerr) goto exit1;
+
+	while (1) {
+		SymtabMark mark = symtab_mark(p->symtab);
+
+		int parsed;
+		if ((ecode = parse_next_external_declaration(p, &parsed)) != ec_noerr) {
+			lexer_print_location(p->lex);
+			ERRMSG("Failed to build Tree\n");
+			goto exit1;
+		}
+		if (!parsed) break;
+
+		if ((ecode = compile_function(p, &cfg, f, mark.symbol)) != ec_noerr) goto exit1;
+
+		tree_clear(p->tree);
+		cfg_clear(&cfg);
+		symtab_release(p->symtab, mark);
+	}
+
+	symtab_pop_scope(p->symtab);
+
+exit1:
+	cfg_destruct(&cfg);
+exit:
+	fclose(f);
+	return ecode;
+}
+
 int main(int argc, char** argv) {
 	ErrorCode ecode;
 
@@ -122,13 +307,39 @@ int main(int argc, char** argv) {
 		strcopy(path, flags.output_path);
 	}
 
+	/* Input path of - reads from stdin, which can only be read once */
+	int input_stdin = strequ(flags.input_path, "-");
+
+	if (g_debug_print_lex_throughput && input_stdin) {
+		ERRMSG("Lexer throughput cannot be measured for standard input\n");
+	}
+	else if (g_debug_print_lex_throughput) {
+		if ((ecode = print_lex_throughput(flags.input_path)) != ec_noerr) {
+			ERRMSGF("Failed to lex input file" TOKEN_COLOR " %s\n", flags.input_path);
+			goto exit1;
+		}
+	}
+
 	/* Parse source code */
 
 	Lexer lex;
-	if ((ecode = lexer_construct(&lex, flags.input_path)) != ec_noerr) {
+	if (input_stdin) {
+		ecode = lexer_construct_stream(&lex, stdin);
+	}
+	else {
+		ecode = lexer_construct(&lex, flags.input_path);
+	}
+	if (ecode != ec_noerr) {
 		ERRMSGF("Failed to open input file" TOKEN_COLOR " %s\n", flags.input_path);
 		goto exit1;
 	}
+	if (g_pretokenize || g_parallel_lex) {
+		if ((ecode = tokenize(&lex)) != ec_noerr) {
+			lexer_print_location(&lex);
+			ERRMSG("Failed to lex input file\n");
+			goto exit2;
+		}
+	}
 
 	Symtab symtab;
 	if ((ecode = symtab_construct(&symtab)) != ec_noerr) goto exit2;
@@ -139,9 +350,25 @@ int main(int argc, char** argv) {
 	Parser p;
 	if ((ecode = parser_construct(&p, &lex, &symtab, &tree)) != ec_noerr) goto exit4;
 
+	if (g_per_function) {
+		ecode = compile_per_function(&p, flags.output_path);
+		goto exit4;
+	}
+
 	if ((ecode = symtab_push_scope(&symtab)) != ec_noerr) goto exit4;
 
 	ecode = parse_translation_unit(&p);
+
+	/* Written out also when parsing failed, to show where time was spent */
+	if (g_debug_profile_parse) {
+		AAPPENDA(json_path, flags.output_path, ".parse-profile.json");
+		ErrorCode profile_ecode = debug_print_parse_profile(json_path);
+		if (ecode == ec_noerr && profile_ecode != ec_noerr) {
+			ecode = profile_ecode;
+			goto exit4;
+		}
+	}
+
 	if (ecode != ec_noerr) {
 		lexer_print_location(&lex);
 		ERRMSG("Failed to build Tree\n");
@@ -151,25 +378,37 @@ int main(int argc, char** argv) {
 	symtab_pop_scope(&symtab);
 	ASSERT(symtab.scopes_size == 0, "Scopes not empty on parse end");
 
+	if (g_debug_print_parse_stats) {
+		debug_print_parse_stats(&p);
+	}
+
 	if (g_debug_print_tree) {
 		LOG("Remaining ");
 		debug_print_tree(&tree);
 	}
 
+	FlatTree ftree;
+	if ((ecode = flat_tree_construct(&ftree, &tree)) != ec_noerr) goto exit4;
+
+	if (g_debug_print_tree_stats) {
+		debug_print_tree_stats(&tree);
+		debug_print_flat_tree_stats(&ftree);
+	}
+
 	/* Generate IL2 */
 
 	Cfg cfg;
-	if ((ecode = cfg_construct(&cfg)) != ec_noerr) goto exit4;
+	if ((ecode = cfg_construct(&cfg)) != ec_noerr) goto exit5;
 
 	IL2Gen il2;
-	if ((ecode = il2_construct(&il2, &cfg, &symtab, &tree)) != ec_noerr) goto exit5;
+	if ((ecode = il2_construct(&il2, &cfg, &symtab, &ftree)) != ec_noerr) goto exit6;
 
-	if ((ecode = symtab_push_scope(&symtab)) != ec_noerr) goto exit5;
+	if ((ecode = symtab_push_scope(&symtab)) != ec_noerr) goto exit7;
 
 	ecode = il2_gen(&il2);
 	if (ecode != ec_noerr) {
 		ERRMSG("Failed to generate IL2\n");
-		goto exit5;
+		goto exit7;
 	}
 
 	symtab_pop_scope(&symtab);
@@ -181,10 +420,16 @@ int main(int argc, char** argv) {
 		debug_print_cfg(&cfg);
 	}
 
-	if ((ecode = il2_write(&il2, flags.output_path)) != ec_noerr) goto exit5;
+	if ((ecode = optimize(&cfg, &symtab)) != ec_noerr) goto exit7;
 
-exit5:
+	if ((ecode = il2_write(&il2, flags.output_path)) != ec_noerr) goto exit7;
+
+exit7:
+	il2_destruct(&il2);
+exit6:
 	cfg_destruct(&cfg);
+exit5:
+	flat_tree_destruct(&ftree);
 exit4:
 	tree_destruct(&tree);
 exit3:
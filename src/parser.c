@@ -1,31 +1,130 @@
 #include "parser.h"
 
+#include <time.h>
+
 #include "common.h"
 #include "globals.h"
 
-/* Function used to determine if TNode should be removed
-   Used in tnode_remove_if */
-static int cmp_remove_tnode(TNode* node) {
-	/* Do not remove unary expressions with an operator */
-	if (tnode_type(node) == tt_unary_expression) {
-		TNodeUnaryExpression* n = (TNodeUnaryExpression*)tnode_data(node);
-		return n->type == TNodeUnaryExpression_none;
-	}
-	/* Do not remove postfix expressions with an operator */
-	if (tnode_type(node) == tt_postfix_expression) {
-		TNodePostfixExpression* n = (TNodePostfixExpression*)tnode_data(node);
-		return n->type == TNodePostfixExpression_none;
-	}
-	if (tnode_type(node) == tt_argument_expression_list) {
-		return 0;
-	}
-	return tnode_count_child(node) == 1;
+#if CC_PARSE_PROFILE
+/* Parse functions profiled by -dprofile-parse, named as given to
+   PARSE_FUNC_START */
+#define PARSE_FUNCS                      \
+	PARSE_FUNC(identifier)               \
+	PARSE_FUNC(new_identifier)           \
+	PARSE_FUNC(constant)                 \
+	PARSE_FUNC(integer_constant)         \
+	PARSE_FUNC(decimal_constant)         \
+	PARSE_FUNC(octal_constant)           \
+	PARSE_FUNC(hexadecimal_constant)     \
+	PARSE_FUNC(primary_expression)       \
+	PARSE_FUNC(postfix_expression)       \
+	PARSE_FUNC(argument_expression_list) \
+	PARSE_FUNC(unary_expression)         \
+	PARSE_FUNC(cast_expression)          \
+	PARSE_FUNC(binary_expression)        \
+	PARSE_FUNC(assignment_expression)    \
+	PARSE_FUNC(expression)               \
+	PARSE_FUNC(declaration)              \
+	PARSE_FUNC(declaration_specifiers)   \
+	PARSE_FUNC(init_declarator_list)     \
+	PARSE_FUNC(init_declarator)          \
+	PARSE_FUNC(declarator)               \
+	PARSE_FUNC(direct_declarator)        \
+	PARSE_FUNC(pointer)                  \
+	PARSE_FUNC(parameter_type_list)      \
+	PARSE_FUNC(parameter_list)           \
+	PARSE_FUNC(parameter_declaration)    \
+	PARSE_FUNC(type_name)                \
+	PARSE_FUNC(initializer)              \
+	PARSE_FUNC(statement)                \
+	PARSE_FUNC(compound_statement)       \
+	PARSE_FUNC(block_item)               \
+	PARSE_FUNC(expression_statement)     \
+	PARSE_FUNC(selection_statement)      \
+	PARSE_FUNC(iteration_statement)      \
+	PARSE_FUNC(jump_statement)           \
+	PARSE_FUNC(external_declaration)
+
+#define PARSE_FUNC(name__) pf_##name__,
+typedef enum
+{
+	PARSE_FUNCS pf_count
+} ParseFuncId;
+#undef PARSE_FUNC
+
+#define PARSE_FUNC(name__) #name__,
+static const char* parse_func_str[] = {PARSE_FUNCS};
+#undef PARSE_FUNC
+
+typedef struct
+{
+	int calls;
+	int matches;
+	/* Nodes allocated and discarded, time taken in nanoseconds
+	   Includes the parse functions called, a function which recurses
+	   into itself is counted once for the outermost call */
+	int nodes_allocated;
+	int nodes_discarded;
+	int64_t time;
+
+	int active; /* Calls which have not returned */
+} ParseProfile;
+
+/* Indexed by ParseFuncId */
+static ParseProfile parse_profile[pf_count];
+
+/* State when a parse function was called */
+typedef struct
+{
+	ParseFuncId id;
+	int nodes_allocated;
+	int nodes_discarded;
+	int64_t time;
+} ParseProfileFrame;
+
+static int64_t parse_profile_now(void) {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return (int64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+static void parse_profile_start(Parser* p, ParseProfileFrame* frame, ParseFuncId id) {
+	++parse_profile[id].calls;
+	++parse_profile[id].active;
+	frame->id = id;
+	frame->nodes_allocated = p->tree->node_count;
+	frame->nodes_discarded = p->stats.discarded_nodes;
+	frame->time = parse_profile_now();
 }
 
+static void parse_profile_end(Parser* p, const ParseProfileFrame* frame, int matched) {
+	ParseProfile* profile = &parse_profile[frame->id];
+	if (matched) ++profile->matches;
+	if (--profile->active > 0) return;
+
+	profile->time += parse_profile_now() - frame->time;
+	profile->nodes_allocated += p->tree->node_count - frame->nodes_allocated;
+	profile->nodes_discarded += p->stats.discarded_nodes - frame->nodes_discarded;
+}
+
+#define PARSE_PROFILE_START(symbol_type__)  \
+	ParseProfileFrame profile_frame__;      \
+	if (g_debug_profile_parse) parse_profile_start(p, &profile_frame__, pf_##symbol_type__);
+#define PARSE_PROFILE_END() \
+	if (g_debug_profile_parse) parse_profile_end(p, &profile_frame__, *matched);
+#else
+#define PARSE_PROFILE_START(symbol_type__)
+#define PARSE_PROFILE_END()
+#endif
+
 ErrorCode parser_construct(Parser* p, Lexer* lex, Symtab* symtab, Tree* tree) {
 	p->lex = lex;
 	p->symtab = symtab;
 	p->tree = tree;
+	cmemzero(&p->stats, sizeof(p->stats));
+#if CC_PARSE_PROFILE
+	cmemzero(parse_profile, sizeof(parse_profile));
+#endif
 	return ec_noerr;
 }
 
@@ -45,10 +144,14 @@ int debug_parse_func_recursion_depth = 0;
 		LOGF(">%d " #symbol_type__ "\n", debug_parse_func_recursion_depth); \
 		debug_parse_func_recursion_depth++;                                 \
 	}                                                                       \
+	PARSE_PROFILE_START(symbol_type__)                                      \
 	ASSERT(parent != NULL, "Parent node is null");
 
 /* Call at end on function */
 #define PARSE_FUNC_END()                                                   \
+	++p->stats.productions;                                                \
+	if (!*matched) ++p->stats.failed_productions;                          \
+	PARSE_PROFILE_END()                                                    \
 	if (g_debug_print_parse_recursion) {                                   \
 		debug_parse_func_recursion_depth--;                                \
 		for (int i__ = 0; i__ < debug_parse_func_recursion_depth; ++i__) { \
@@ -85,17 +188,8 @@ static ErrorCode parse_postfix_expression(Parser* p, TNode* parent, int* matched
 static ErrorCode parse_argument_expression_list(Parser*, TNode* parent, int* matched);
 static ErrorCode parse_unary_expression(Parser* p, TNode* parent, int* matched);
 static ErrorCode parse_cast_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_multiplicative_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_additive_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_shift_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_relational_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_equality_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_and_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_exclusive_or_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_inclusive_or_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_logical_and_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_logical_or_expression(Parser* p, TNode* parent, int* matched);
-static ErrorCode parse_conditional_expression(Parser* p, TNode* parent, int* matched);
+/* multiplicative-expression to conditional-expression */
+static ErrorCode parse_binary_expression(Parser* p, TNode* parent, int min_precedence, int* matched);
 static ErrorCode parse_assignment_expression(Parser* p, TNode* parent, int* matched);
 static ErrorCode parse_expression(Parser* p, TNode* parent, int* matched);
 /* 6.7 Declarators */
@@ -122,7 +216,8 @@ static ErrorCode parse_jump_statement(Parser* p, TNode* parent, int* matched);
 /* 6.9 External definitions */
 static ErrorCode parse_external_declaration(Parser* p, TNode* parent, int* matched);
 /* Helpers */
-static ErrorCode parse_expect(Parser* p, const char* match_token, int* matched);
+static ErrorCode parse_expect(Parser* p, TokenKind kind, int* matched);
+static void parse_discard(Parser* p, TNode* node);
 
 /* identifier that was already added to symbol table */
 static ErrorCode parse_identifier(Parser* p, TNode* parent, int* matched) {
@@ -130,16 +225,16 @@ static ErrorCode parse_identifier(Parser* p, TNode* parent, int* matched) {
 	ErrorCode ecode = ec_noerr;
 	*matched = 0;
 
-	const char* token;
+	const Token* token;
 	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-	if (tok_isidentifier(token)) {
+	if (token->kind == tk_identifier) {
 		TNode* node;
-		if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+		if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 
-		Symbol* sym = symtab_find(p->symtab, token);
+		Symbol* sym = symtab_find(p->symtab, token->str);
 		if (sym == NULL) {
-			ERRMSGF("Unknown identifier '%s'\n", token);
+			ERRMSGF("Unknown identifier '%s'\n", token->str);
 			ecode = ec_syntaxerr;
 			goto exit;
 		}
@@ -160,19 +255,19 @@ exit:
 
 /* New identifier not yet added to symbol table */
 static ErrorCode parse_new_identifier(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(identifier);
+	PARSE_FUNC_START(new_identifier);
 	ErrorCode ecode = ec_noerr;
 	*matched = 0;
 
-	const char* token;
+	const Token* token;
 	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-	if (tok_isidentifier(token)) {
+	if (token->kind == tk_identifier) {
 		TNode* node;
-		if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+		if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 
 		TNodeNewIdentifier data;
-		strcopy(token, data.token);
+		data.token = token->str;
 		tnode_set(node, tt_new_identifier, &data);
 
 		lexer_consume(p->lex);
@@ -233,43 +328,130 @@ exit:
 	return ecode;
 }
 
-static ErrorCode parse_decimal_constant(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(decimal_constant);
-	ErrorCode ecode;
-	*matched = 0;
+/* Adds digit to value in given base, returns 1 if the value no longer
+   fits in 64 bits */
+static int integer_accumulate(uint64_t* value, int base, int digit) {
+	if (*value > (UINT64_MAX - (uint64_t)digit) / (uint64_t)base) return 1;
+	*value = *value * (uint64_t)base + (uint64_t)digit;
+	return 0;
+}
 
-	const char* token;
-	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
+/* Returns value of hexadecimal digit, -1 if not a hexadecimal digit */
+static int hexadecimal_digit(char c) {
+	if ('0' <= c && c <= '9') return c - '0';
+	if ('a' <= c && c <= 'f') return c - 'a' + 10;
+	if ('A' <= c && c <= 'F') return c - 'A' + 10;
+	return -1;
+}
 
-	/* First character is nonzero-digit */
-	char c = token[0];
-	if (c <= '0' || c > '9') {
-		goto exit;
-	}
+/* Reads integer-suffix(opt) in str, u and l in either case, ll and LL
+   Stores 1 at is_unsigned if suffix has u, number of l at longs
+   Returns 1 if str is exactly a suffix or empty, 0 otherwise */
+static int integer_suffix(const char* str, int* is_unsigned, int* longs) {
+	*is_unsigned = 0;
+	*longs = 0;
 
-	/* Remaining characters is digit */
 	int i = 0;
-	while (c != '\0') {
-		if (c < '0' || c > '9') {
-			goto exit;
+	if (str[i] == 'u' || str[i] == 'U') {
+		*is_unsigned = 1;
+		++i;
+	}
+	if (str[i] == 'l' || str[i] == 'L') {
+		*longs = 1;
+		if (str[i + 1] == str[i]) {
+			*longs = 2;
+			++i;
 		}
-
 		++i;
-		c = token[i];
+	}
+	if (!*is_unsigned && (str[i] == 'u' || str[i] == 'U')) {
+		*is_unsigned = 1;
+		++i;
+	}
+	return str[i] == '\0';
+}
+
+/* Returns the type of an integer constant, the first type of the list in
+   6.4.4.1 which can represent value. ts_none if no type can
+   Decimal constants without a u suffix only have signed types
+   The limits are those of the types as written, long is 32 bits */
+static TypeSpecifiers integer_constant_type(uint64_t value, int decimal, int is_unsigned, int longs) {
+	/* Ordered by rank, rank is the number of l in the suffix */
+	const TypeSpecifiers types[] = {ts_int, ts_uint, ts_long, ts_ulong, ts_longlong, ts_ulonglong};
+
+	for (int i = longs * 2; i < ARRAY_SIZE(types); ++i) {
+		int type_unsigned = i % 2 == 1;
+		if (is_unsigned && !type_unsigned) continue;
+		if (!is_unsigned && decimal && type_unsigned) continue;
+		if (value <= type_max(types[i])) return types[i];
+	}
+	return ts_none;
+}
+
+/* Adds integer constant token with value computed from its digits to
+   the tree, suffix is the characters in the token after the digits
+   Does not match if the suffix is invalid */
+static ErrorCode match_integer_constant(Parser* p, TNode* parent, const Token* token, const char* suffix,
+									   uint64_t value, int overflow, int decimal, int* matched) {
+	ErrorCode ecode;
+	*matched = 0;
+
+	int is_unsigned;
+	int longs;
+	if (!integer_suffix(suffix, &is_unsigned, &longs)) return ec_noerr;
+
+	TypeSpecifiers ts = overflow ? ts_none : integer_constant_type(value, decimal, is_unsigned, longs);
+	if (ts == ts_none) {
+		ERRMSGF("Integer constant too large for its type" TOKEN_COLOR " %s\n", token->str);
+		return ec_syntaxerr;
 	}
 
+	Type type;
+	if ((ecode = type_construct(&type, ts, 0)) != ec_noerr) return ecode;
 	Symbol* sym;
-	if ((ecode = symtab_add_constant(p->symtab, &sym, token, symtab_type_int(p->symtab))) != ec_noerr) goto exit;
+	ecode = symtab_add_constant(p->symtab, &sym, token->str, value, &type);
+	type_destruct(&type);
+	if (ecode != ec_noerr) return ecode;
 
 	TNodeConstant data;
 	data.symbol = sym;
 
 	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+	if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) return ecode;
 	tnode_set(node, tt_constant, &data);
 
 	lexer_consume(p->lex);
 	*matched = 1;
+	return ec_noerr;
+}
+
+static ErrorCode parse_decimal_constant(Parser* p, TNode* parent, int* matched) {
+	PARSE_FUNC_START(decimal_constant);
+	ErrorCode ecode;
+	*matched = 0;
+
+	const Token* token;
+	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
+
+	if (token->kind != tk_constant) goto exit;
+
+	/* First character is nonzero-digit */
+	const char* str = token->str;
+	if (str[0] <= '0' || str[0] > '9') {
+		goto exit;
+	}
+
+	/* Remaining characters is digit, the value is computed as the
+	   digits are read */
+	uint64_t value = 0;
+	int overflow = 0;
+	int i = 0;
+	while ('0' <= str[i] && str[i] <= '9') {
+		overflow |= integer_accumulate(&value, 10, str[i] - '0');
+		++i;
+	}
+
+	ecode = match_integer_constant(p, parent, token, str + i, value, overflow, 1, matched);
 
 exit:
 	PARSE_FUNC_END();
@@ -287,36 +469,26 @@ static ErrorCode parse_octal_constant(Parser* p, TNode* parent, int* matched) {
 	/* octal-constant-2
 	   -> octal-digit octal-constant-2(opt) */
 
-	const char* token;
+	const Token* token;
 	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-	char c = token[0];
-	if (c != '0') {
+	if (token->kind != tk_constant) goto exit;
+
+	const char* str = token->str;
+	if (str[0] != '0') {
 		goto exit;
 	}
 
-	/* Remaining characters is digit */
-	int i = 0;
-	while (c != '\0') {
-		if (c < '0' || c > '7') {
-			goto exit;
-		}
+	/* Remaining characters is octal digit */
+	uint64_t value = 0;
+	int overflow = 0;
+	int i = 1;
+	while ('0' <= str[i] && str[i] <= '7') {
+		overflow |= integer_accumulate(&value, 8, str[i] - '0');
 		++i;
-		c = token[i];
 	}
 
-	Symbol* sym;
-	if ((ecode = symtab_add_constant(p->symtab, &sym, token, symtab_type_int(p->symtab))) != ec_noerr) goto exit;
-
-	TNodeConstant data;
-	data.symbol = sym;
-
-	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
-	tnode_set(node, tt_constant, &data);
-
-	lexer_consume(p->lex);
-	*matched = 1;
+	ecode = match_integer_constant(p, parent, token, str + i, value, overflow, 0, matched);
 
 exit:
 	PARSE_FUNC_END();
@@ -328,41 +500,30 @@ static ErrorCode parse_hexadecimal_constant(Parser* p, TNode* parent, int* match
 	ErrorCode ecode;
 	*matched = 0;
 
-	const char* token;
+	const Token* token;
 	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-	if (token[0] != '0') goto exit;
-	if (token[1] != 'x' && token[1] != 'X') goto exit;
+	if (token->kind != tk_constant) goto exit;
+	const char* str = token->str;
+	if (str[0] != '0') goto exit;
+	if (str[1] != 'x' && str[1] != 'X') goto exit;
 
 	/* Need at least 1 digit */
-	char c = token[2];
-	if ((c < '0' || c > '9') && (c < 'a' || c > 'f') && (c < 'A' || c > 'F')) {
+	if (hexadecimal_digit(str[2]) < 0) {
 		goto exit;
 	}
 
 	/* Remaining characters is hex digit */
-	int i = 3;
-	c = token[i];
-	while (c != '\0') {
-		if ((c < '0' || c > '9') && (c < 'a' || c > 'f') && (c < 'A' || c > 'F')) {
-			goto exit;
-		}
+	uint64_t value = 0;
+	int overflow = 0;
+	int i = 2;
+	int digit;
+	while ((digit = hexadecimal_digit(str[i])) >= 0) {
+		overflow |= integer_accumulate(&value, 16, digit);
 		++i;
-		c = token[i];
 	}
 
-	Symbol* sym;
-	if ((ecode = symtab_add_constant(p->symtab, &sym, token, symtab_type_int(p->symtab))) != ec_noerr) goto exit;
-
-	TNodeConstant data;
-	data.symbol = sym;
-
-	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
-	tnode_set(node, tt_constant, &data);
-
-	lexer_consume(p->lex);
-	*matched = 1;
+	ecode = match_integer_constant(p, parent, token, str + i, value, overflow, 0, matched);
 
 exit:
 	PARSE_FUNC_END();
@@ -381,7 +542,7 @@ static ErrorCode parse_primary_expression(Parser* p, TNode* parent, int* matched
 	if ((ecode = parse_constant(p, parent, &has_match)) != ec_noerr) goto exit;
 	if (has_match) goto matched;
 
-	if ((ecode = parse_expect(p, "(", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_lparen, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		if ((ecode = parse_expression(p, parent, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
@@ -390,7 +551,7 @@ static ErrorCode parse_primary_expression(Parser* p, TNode* parent, int* matched
 			goto exit;
 		}
 
-		if ((ecode = parse_expect(p, ")", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_rparen, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected ')'\n");
 			ecode = ec_syntaxerr;
@@ -409,533 +570,173 @@ exit:
 	return ecode;
 }
 
-static ErrorCode parse_postfix_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(postfix_expression);
-	ErrorCode ecode;
-	*matched = 0;
-
-	TNodePostfixExpression data;
-	data.type = TNodePostfixExpression_none;
-
-	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
-
-	int has_match;
-	if ((ecode = parse_primary_expression(p, node, &has_match)) != ec_noerr) goto exit;
-	if (!has_match) goto exit;
-	*matched = 1;
-
-	const char* token;
-	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
-
-	///* Array subscript */
-	// if (parse_expect(p, "[")) {
-	//     if (!parse_expression(p, parent)) goto exit;
-	//     if (!parse_expect(p, "]")) goto exit;
-	//     PARSE_MATCHED();
-
-	//    parse_postfix_expression_2(p, parent);
-	//}
-	/* Function call */
-	if (strequ(token, "(")) {
-		data.type = TNodePostfixExpression_call;
-		lexer_consume(p->lex);
-
-		if ((ecode = parse_argument_expression_list(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) {
-			ERRMSG("Expected argument-expression-list\n");
-			ecode = ec_syntaxerr;
-			goto exit;
-		}
-
-		if ((ecode = parse_expect(p, ")", &has_match)) != ec_noerr) goto exit;
-		if (!has_match) {
-			ERRMSG("Expected ')'\n");
-			ecode = ec_syntaxerr;
-			goto exit;
-		}
-	}
-
-	/* Postfix increment, decrement */
-	if (strequ(token, "++")) {
-		data.type = TNodePostfixExpression_inc;
-		lexer_consume(p->lex);
-	}
-	else if (strequ(token, "--")) {
-		data.type = TNodePostfixExpression_dec;
-		lexer_consume(p->lex);
-	}
-
-	tnode_set(node, tt_postfix_expression, &data);
-
-	/* Incomplete */
-
-exit:
-	PARSE_FUNC_END();
-	return ecode;
-}
-
-static ErrorCode parse_argument_expression_list(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(argument_expression_list);
-	ErrorCode ecode;
-	*matched = 0;
-
-	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
-	tnode_set(node, tt_argument_expression_list, NULL);
-
-	int has_match;
-	if ((ecode = parse_assignment_expression(p, node, &has_match)) != ec_noerr) goto exit;
-	if (!has_match) goto exit;
-	*matched = 1;
-
-	if ((ecode = parse_expect(p, ",", &has_match)) != ec_noerr) goto exit;
-	while (has_match) {
-		if ((ecode = parse_assignment_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) {
-			ERRMSG("Expected assignment-expression\n");
-			ecode = ec_syntaxerr;
-			goto exit;
-		}
-
-		if ((ecode = parse_expect(p, ",", &has_match)) != ec_noerr) goto exit;
-	}
-
-exit:
-	PARSE_FUNC_END();
-	return ecode;
-}
-
-static ErrorCode parse_unary_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(unary_expression);
-	ErrorCode ecode;
-	*matched = 0;
-
-	int attached_node = 0;
-	TNode* node;
-	if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
-
-	TNodeUnaryExpression data;
-	data.type = TNodeUnaryExpression_none;
-
-	const char* token;
-	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
-
-	int expect_cast_expr = 0;
-	int has_match;
-	/* Prefix increment, decrement */
-	if (strequ(token, "++")) {
-		data.type = TNodeUnaryExpression_inc;
-		lexer_consume(p->lex);
-
-		if ((ecode = parse_unary_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) {
-			ERRMSG("Expected unary-expression\n");
-			goto exit;
-		}
-		*matched = 1;
-	}
-	else if (strequ(token, "--")) {
-		data.type = TNodeUnaryExpression_dec;
-		lexer_consume(p->lex);
-
-		if ((ecode = parse_unary_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) {
-			ERRMSG("Expected unary-expression\n");
-			goto exit;
-		}
-		*matched = 1;
-	}
-	else if (strequ(token, "&")) {
-		data.type = TNodeUnaryExpression_ref;
-		lexer_consume(p->lex);
-		if ((ecode = parse_cast_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) {
-			ERRMSG("Expected cast-expression\n");
-			goto exit;
-		}
-		*matched = 1;
-	}
-	else if (strequ(token, "*")) {
-		data.type = TNodeUnaryExpression_deref;
-		lexer_consume(p->lex);
-		expect_cast_expr = 1;
-	}
-	else if (strequ(token, "+")) {
-		data.type = TNodeUnaryExpression_pos;
-		lexer_consume(p->lex);
-		expect_cast_expr = 1;
-	}
-	else if (strequ(token, "-")) {
-		data.type = TNodeUnaryExpression_neg;
-		lexer_consume(p->lex);
-		expect_cast_expr = 1;
-	}
-	else if (strequ(token, "!")) {
-		data.type = TNodeUnaryExpression_negate;
-		lexer_consume(p->lex);
-		expect_cast_expr = 1;
-	}
-	else {
-		if ((ecode = parse_postfix_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (has_match) *matched = 1;
-	}
-
-	if (expect_cast_expr) {
-		if ((ecode = parse_cast_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) {
-			ERRMSG("Expected cast-expression\n");
-			goto exit;
-		}
-		*matched = 1;
-	}
-
-	/* Incomplete */
-
-	if (*matched) {
-		if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
-		tnode_set(node, tt_unary_expression, &data);
-		attached_node = 1;
-	}
-
-exit:
-	if (!attached_node) tnode_destruct(node);
-	PARSE_FUNC_END();
-	return ecode;
-}
-
-static ErrorCode parse_cast_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(cast_expression);
-	ErrorCode ecode;
-	*matched = 0;
-
-	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
-	tnode_set(node, tt_cast_expression, NULL);
-
-	int has_match;
-	const char* token;
-	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
-	if (strequ(token, "(")) {
-		if ((ecode = lexer_getc2(p->lex, &token)) != ec_noerr) goto exit;
-		if (tok_istypespec(token)) {
-			lexer_consume(p->lex); /* Consume ( */
-
-			if ((ecode = parse_type_name(p, node, &has_match)) != ec_noerr) goto exit;
-			if (!has_match) {
-				ERRMSG("Expected type-name\n");
-				ecode = ec_syntaxerr;
-				goto exit;
-			}
-
-			if ((ecode = parse_expect(p, ")", &has_match)) != ec_noerr) goto exit;
-			if (!has_match) {
-				ERRMSG("Expected ')'\n");
-				ecode = ec_syntaxerr;
-				goto exit;
-			}
-		}
-	}
-
-	if ((ecode = parse_unary_expression(p, node, matched)) != ec_noerr) goto exit;
-
-exit:
-	PARSE_FUNC_END();
-	return ecode;
-}
-
-static ErrorCode parse_multiplicative_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(multiplicative_expression);
-	ErrorCode ecode;
-	*matched = 0;
-
-	int attached_node = 0;
-	TNode* node;
-	if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
-
-	TNodeBinaryExpression data;
-	data.type = TNodeBinaryExpression_none;
-
-	/* Parse LHS */
-	int has_match;
-	if ((ecode = parse_cast_expression(p, node, &has_match)) != ec_noerr) goto exit;
-	if (!has_match) goto exit;
-
-	while (1) {
-		/* Parse operator */
-		const char* token;
-		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
-
-		if (strequ(token, "*")) {
-			data.type = TNodeBinaryExpression_mul;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "/")) {
-			data.type = TNodeBinaryExpression_div;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "%")) {
-			data.type = TNodeBinaryExpression_mod;
-			lexer_consume(p->lex);
-		}
-		else break;
-
-		/* Parse RHS */
-		if ((ecode = parse_cast_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) goto exit;
-
-		/* LHS <- RHS */
-		tnode_set(node, tt_binary_expression, &data);
-
-		TNode* new_node;
-		if ((ecode = tnode_alloc(&new_node)) != ec_noerr) goto exit;
-		if ((ecode = tnode_attach(new_node, node)) != ec_noerr) goto exit;
-		node = new_node;
-		data.type = TNodeBinaryExpression_none;
-	}
-
-	if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
-	tnode_set(node, tt_binary_expression, &data);
-	attached_node = 1;
-
-	*matched = 1;
-
-exit:
-	if (!attached_node) tnode_destruct(node);
-	PARSE_FUNC_END();
-	return ecode;
-}
-
-static ErrorCode parse_additive_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(additive_expression);
-	ErrorCode ecode;
-	*matched = 0;
-
-	int attached_node = 0;
-	TNode* node;
-	if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
-
-	TNodeBinaryExpression data;
-	data.type = TNodeBinaryExpression_none;
-
-	/* Parse LHS */
-	int has_match;
-	if ((ecode = parse_multiplicative_expression(p, node, &has_match)) != ec_noerr) goto exit;
-	if (!has_match) goto exit;
-
-	while (1) {
-		/* Parse operator */
-		const char* token;
-		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
-
-		if (strequ(token, "+")) {
-			data.type = TNodeBinaryExpression_add;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "-")) {
-			data.type = TNodeBinaryExpression_sub;
-			lexer_consume(p->lex);
-		}
-		else break;
-
-		/* Parse RHS */
-		if ((ecode = parse_multiplicative_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) goto exit;
-
-		/* LHS <- RHS */
-		tnode_set(node, tt_binary_expression, &data);
-
-		TNode* new_node;
-		if ((ecode = tnode_alloc(&new_node)) != ec_noerr) goto exit;
-		if ((ecode = tnode_attach(new_node, node)) != ec_noerr) goto exit;
-		node = new_node;
-		data.type = TNodeBinaryExpression_none;
-	}
-
-	if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
-	tnode_set(node, tt_binary_expression, &data);
-	attached_node = 1;
-
-	*matched = 1;
-
-exit:
-	if (!attached_node) tnode_destruct(node);
-	PARSE_FUNC_END();
-	return ecode;
-}
-
-static ErrorCode parse_shift_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(shift_expression);
-	ErrorCode ecode;
-	*matched = 0;
-
-	if ((ecode = parse_additive_expression(p, parent, matched)) != ec_noerr) goto exit;
-
-	/* Incomplete */
-
-exit:
-	PARSE_FUNC_END();
-	return ecode;
-}
-
-static ErrorCode parse_relational_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(relational_expression);
-	ErrorCode ecode;
-	*matched = 0;
-
-	int attached_node = 0;
-	TNode* node;
-	if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
-
-	TNodeBinaryExpression data;
-	data.type = TNodeBinaryExpression_none;
-
-	/* Parse LHS */
-	int has_match;
-	if ((ecode = parse_shift_expression(p, node, &has_match)) != ec_noerr) goto exit;
-	if (!has_match) goto exit;
-
-	while (1) {
-		/* Parse operator */
-		const char* token;
-		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
-
-		if (strequ(token, "<")) {
-			data.type = TNodeBinaryExpression_l;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, ">")) {
-			data.type = TNodeBinaryExpression_g;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "<=")) {
-			data.type = TNodeBinaryExpression_le;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, ">=")) {
-			data.type = TNodeBinaryExpression_ge;
-			lexer_consume(p->lex);
-		}
-		else break;
-
-		/* Parse RHS */
-		if ((ecode = parse_shift_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) goto exit;
-
-		/* LHS <- RHS */
-		tnode_set(node, tt_binary_expression, &data);
-
-		TNode* new_node;
-		if ((ecode = tnode_alloc(&new_node)) != ec_noerr) goto exit;
-		if ((ecode = tnode_attach(new_node, node)) != ec_noerr) goto exit;
-		node = new_node;
-		data.type = TNodeBinaryExpression_none;
-	}
-
-	if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
-	tnode_set(node, tt_binary_expression, &data);
-	attached_node = 1;
-
-	*matched = 1;
-
-exit:
-	if (!attached_node) tnode_destruct(node);
-	PARSE_FUNC_END();
-	return ecode;
-}
-
-static ErrorCode parse_equality_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(equality_expression);
+static ErrorCode parse_postfix_expression(Parser* p, TNode* parent, int* matched) {
+	PARSE_FUNC_START(postfix_expression);
 	ErrorCode ecode;
 	*matched = 0;
 
-	int attached_node = 0;
-	TNode* node;
-	if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
-
-	TNodeBinaryExpression data;
-	data.type = TNodeBinaryExpression_none;
-
-	/* Parse LHS */
+	/* The operand is attached to parent, it is moved under a node for the
+	   operator if there is one */
 	int has_match;
-	if ((ecode = parse_relational_expression(p, node, &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_primary_expression(p, parent, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) goto exit;
+	*matched = 1;
 
+	/* Each operator applies to the result of the previous one */
 	while (1) {
-		/* Parse operator */
-		const char* token;
+		const Token* token;
 		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-		if (strequ(token, "==")) {
-			data.type = TNodeBinaryExpression_e;
-			lexer_consume(p->lex);
+		TNodePostfixExpression data;
+
+		///* Array subscript */
+		// if (parse_expect(p, "[")) {
+		//     if (!parse_expression(p, parent)) goto exit;
+		//     if (!parse_expect(p, "]")) goto exit;
+		//     PARSE_MATCHED();
+
+		//    parse_postfix_expression_2(p, parent);
+		//}
+		/* Function call */
+		if (token->kind == tk_lparen) {
+			data.type = TNodePostfixExpression_call;
 		}
-		else if (strequ(token, "!=")) {
-			data.type = TNodeBinaryExpression_ne;
-			lexer_consume(p->lex);
+		/* Postfix increment, decrement */
+		else if (token->kind == tk_plusplus) {
+			data.type = TNodePostfixExpression_inc;
+		}
+		else if (token->kind == tk_minusminus) {
+			data.type = TNodePostfixExpression_dec;
 		}
 		else break;
+		lexer_consume(p->lex);
 
-		/* Parse RHS */
-		if ((ecode = parse_relational_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) goto exit;
+		TNode* node;
+		if ((ecode = tnode_wrap_child(p->tree, parent, &node, -1)) != ec_noerr) goto exit;
+		tnode_set(node, tt_postfix_expression, &data);
 
-		/* LHS <- RHS */
-		tnode_set(node, tt_binary_expression, &data);
+		if (data.type == TNodePostfixExpression_call) {
+			if ((ecode = parse_argument_expression_list(p, node, &has_match)) != ec_noerr) goto exit;
+			if (!has_match) {
+				ERRMSG("Expected argument-expression-list\n");
+				ecode = ec_syntaxerr;
+				goto exit;
+			}
 
-		TNode* new_node;
-		if ((ecode = tnode_alloc(&new_node)) != ec_noerr) goto exit;
-		if ((ecode = tnode_attach(new_node, node)) != ec_noerr) goto exit;
-		node = new_node;
-		data.type = TNodeBinaryExpression_none;
+			if ((ecode = parse_expect(p, tk_rparen, &has_match)) != ec_noerr) goto exit;
+			if (!has_match) {
+				ERRMSG("Expected ')'\n");
+				ecode = ec_syntaxerr;
+				goto exit;
+			}
+		}
 	}
 
-	if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
-	tnode_set(node, tt_binary_expression, &data);
-	attached_node = 1;
-
-	*matched = 1;
+	/* Incomplete */
 
 exit:
-	if (!attached_node) tnode_destruct(node);
 	PARSE_FUNC_END();
 	return ecode;
 }
 
-static ErrorCode parse_and_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(and_expression);
+static ErrorCode parse_argument_expression_list(Parser* p, TNode* parent, int* matched) {
+	PARSE_FUNC_START(argument_expression_list);
 	ErrorCode ecode;
 	*matched = 0;
 
-	if ((ecode = parse_equality_expression(p, parent, matched)) != ec_noerr) goto exit;
+	TNode* node;
+	if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
+	tnode_set(node, tt_argument_expression_list, NULL);
 
-	/* Incomplete */
+	int has_match;
+	if ((ecode = parse_assignment_expression(p, node, &has_match)) != ec_noerr) goto exit;
+	if (!has_match) goto exit;
+	*matched = 1;
+
+	if ((ecode = parse_expect(p, tk_comma, &has_match)) != ec_noerr) goto exit;
+	while (has_match) {
+		if ((ecode = parse_assignment_expression(p, node, &has_match)) != ec_noerr) goto exit;
+		if (!has_match) {
+			ERRMSG("Expected assignment-expression\n");
+			ecode = ec_syntaxerr;
+			goto exit;
+		}
+
+		if ((ecode = parse_expect(p, tk_comma, &has_match)) != ec_noerr) goto exit;
+	}
 
 exit:
 	PARSE_FUNC_END();
 	return ecode;
 }
 
-static ErrorCode parse_exclusive_or_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(exclusive_or_expression);
+static ErrorCode parse_unary_expression(Parser* p, TNode* parent, int* matched) {
+	PARSE_FUNC_START(unary_expression);
 	ErrorCode ecode;
 	*matched = 0;
 
-	if ((ecode = parse_and_expression(p, parent, matched)) != ec_noerr) goto exit;
-
-	/* Incomplete */
+	const Token* token;
+	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-exit:
-	PARSE_FUNC_END();
-	return ecode;
-}
+	TNodeUnaryExpression data;
+	/* Increment and decrement apply to a unary-expression, the other
+	   operators to a cast-expression */
+	int unary_operand = 0;
+	switch (token->kind) {
+	/* Prefix increment, decrement */
+	case tk_plusplus:
+		data.type = TNodeUnaryExpression_inc;
+		unary_operand = 1;
+		break;
+	case tk_minusminus:
+		data.type = TNodeUnaryExpression_dec;
+		unary_operand = 1;
+		break;
+	case tk_amp:
+		data.type = TNodeUnaryExpression_ref;
+		break;
+	case tk_star:
+		data.type = TNodeUnaryExpression_deref;
+		break;
+	case tk_plus:
+		data.type = TNodeUnaryExpression_pos;
+		break;
+	case tk_minus:
+		data.type = TNodeUnaryExpression_neg;
+		break;
+	case tk_exclaim:
+		data.type = TNodeUnaryExpression_negate;
+		break;
+	default:
+		ecode = parse_postfix_expression(p, parent, matched);
+		goto exit;
+	}
+	lexer_consume(p->lex);
 
-static ErrorCode parse_inclusive_or_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(inclusive_or_expression);
-	ErrorCode ecode;
-	*matched = 0;
+	/* The operand is attached to parent, then moved under a node for the
+	   operator */
+	int has_match;
+	if (unary_operand) {
+		if ((ecode = parse_unary_expression(p, parent, &has_match)) != ec_noerr) goto exit;
+		if (!has_match) {
+			ERRMSG("Expected unary-expression\n");
+			ecode = ec_syntaxerr;
+			goto exit;
+		}
+	}
+	else {
+		if ((ecode = parse_cast_expression(p, parent, &has_match)) != ec_noerr) goto exit;
+		if (!has_match) {
+			ERRMSG("Expected cast-expression\n");
+			ecode = ec_syntaxerr;
+			goto exit;
+		}
+	}
 
-	if ((ecode = parse_exclusive_or_expression(p, parent, matched)) != ec_noerr) goto exit;
+	TNode* node;
+	if ((ecode = tnode_wrap_child(p->tree, parent, &node, -1)) != ec_noerr) goto exit;
+	tnode_set(node, tt_unary_expression, &data);
+	*matched = 1;
 
 	/* Incomplete */
 
@@ -944,74 +745,173 @@ exit:
 	return ecode;
 }
 
-static ErrorCode parse_logical_and_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(logical_and_expression);
+static ErrorCode parse_cast_expression(Parser* p, TNode* parent, int* matched) {
+	PARSE_FUNC_START(cast_expression);
 	ErrorCode ecode;
 	*matched = 0;
 
-	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
-	tnode_set(node, tt_logical_and_expression, NULL);
+	const Token* token;
+	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
+	if (token->kind == tk_lparen) {
+		if ((ecode = lexer_getc2(p->lex, &token)) != ec_noerr) goto exit;
+		if (tk_istypespec(token->kind)) {
+			lexer_consume(p->lex); /* Consume ( */
 
-	while (1) {
-		int has_match;
-		if ((ecode = parse_inclusive_or_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) goto exit;
+			TNode* node;
+			if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
+			tnode_set(node, tt_cast_expression, NULL);
 
-		const char* token;
-		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
+			int has_match;
+			if ((ecode = parse_type_name(p, node, &has_match)) != ec_noerr) goto exit;
+			if (!has_match) {
+				ERRMSG("Expected type-name\n");
+				ecode = ec_syntaxerr;
+				goto exit;
+			}
 
-		if (strequ(token, "&&")) {
-			lexer_consume(p->lex);
+			if ((ecode = parse_expect(p, tk_rparen, &has_match)) != ec_noerr) goto exit;
+			if (!has_match) {
+				ERRMSG("Expected ')'\n");
+				ecode = ec_syntaxerr;
+				goto exit;
+			}
+
+			if ((ecode = parse_cast_expression(p, node, &has_match)) != ec_noerr) goto exit;
+			if (!has_match) {
+				ERRMSG("Expected cast-expression\n");
+				ecode = ec_syntaxerr;
+				goto exit;
+			}
+			*matched = 1;
+			goto exit;
 		}
-		else break;
 	}
 
-	*matched = 1;
+	if ((ecode = parse_unary_expression(p, parent, matched)) != ec_noerr) goto exit;
 
 exit:
 	PARSE_FUNC_END();
 	return ecode;
 }
 
-static ErrorCode parse_logical_or_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(logical_or_expression);
+/* Binary operators from multiplicative-expression to assignment-expression
+   are parsed by precedence climbing, using the table below instead of a
+   function for each production. Operators with a higher precedence bind
+   tighter. Shift and bitwise operators are not supported yet */
+#define PREC_NONE           0 /* Not a binary operator */
+#define PREC_ASSIGNMENT     1
+#define PREC_LOGICAL_OR     2
+#define PREC_LOGICAL_AND    3
+#define PREC_EQUALITY       4
+#define PREC_RELATIONAL     5
+#define PREC_ADDITIVE       6
+#define PREC_MULTIPLICATIVE 7
+
+typedef struct
+{
+	int precedence;
+	/* The node created for the operator, and the type set in the node's
+	   data. Logical operators do not have data */
+	TNodeType type;
+	int op;
+} BinaryOperator;
+
+/* Indexed by TokenKind */
+static const BinaryOperator binary_operator[tk_count] = {
+	[tk_equal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_assign},
+	[tk_starequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_mul},
+	[tk_slashequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_div},
+	[tk_percentequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_mod},
+	[tk_plusequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_add},
+	[tk_minusequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_sub},
+	[tk_lesslessequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_shl},
+	[tk_greatergreaterequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_shr},
+	[tk_ampequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_and},
+	[tk_caretequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_xor},
+	[tk_pipeequal] = {PREC_ASSIGNMENT, tt_assignment_expression, TNodeAssignmentExpression_or},
+
+	[tk_pipepipe] = {PREC_LOGICAL_OR, tt_logical_or_expression, 0},
+	[tk_ampamp] = {PREC_LOGICAL_AND, tt_logical_and_expression, 0},
+
+	[tk_equalequal] = {PREC_EQUALITY, tt_binary_expression, TNodeBinaryExpression_e},
+	[tk_exclaimequal] = {PREC_EQUALITY, tt_binary_expression, TNodeBinaryExpression_ne},
+
+	[tk_less] = {PREC_RELATIONAL, tt_binary_expression, TNodeBinaryExpression_l},
+	[tk_greater] = {PREC_RELATIONAL, tt_binary_expression, TNodeBinaryExpression_g},
+	[tk_lessequal] = {PREC_RELATIONAL, tt_binary_expression, TNodeBinaryExpression_le},
+	[tk_greaterequal] = {PREC_RELATIONAL, tt_binary_expression, TNodeBinaryExpression_ge},
+
+	[tk_plus] = {PREC_ADDITIVE, tt_binary_expression, TNodeBinaryExpression_add},
+	[tk_minus] = {PREC_ADDITIVE, tt_binary_expression, TNodeBinaryExpression_sub},
+
+	[tk_star] = {PREC_MULTIPLICATIVE, tt_binary_expression, TNodeBinaryExpression_mul},
+	[tk_slash] = {PREC_MULTIPLICATIVE, tt_binary_expression, TNodeBinaryExpression_div},
+	[tk_percent] = {PREC_MULTIPLICATIVE, tt_binary_expression, TNodeBinaryExpression_mod},
+};
+
+/* Parses cast-expression operands joined by binary operators with at
+   least min_precedence, the result is attached to parent
+   Operators of the same precedence group left to right, except
+   assignment operators which group right to left. Operands of a
+   logical operator applied repeatedly, e.g., a && b && c, are children
+   of a single node */
+static ErrorCode parse_binary_expression(Parser* p, TNode* parent, int min_precedence, int* matched) {
+	PARSE_FUNC_START(binary_expression);
 	ErrorCode ecode;
 	*matched = 0;
 
-	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
-	tnode_set(node, tt_logical_or_expression, NULL);
+	/* LHS, the last child of parent, moved under the node of each
+	   operator applied to it */
+	int has_match;
+	if ((ecode = parse_cast_expression(p, parent, &has_match)) != ec_noerr) goto exit;
+	if (!has_match) goto exit;
+	*matched = 1;
 
+	/* Node of the last operator if it was a logical operator */
+	TNode* logical_node = NULL;
 	while (1) {
-		int has_match;
-		if ((ecode = parse_logical_and_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) goto exit;
-
-		const char* token;
+		/* Parse operator */
+		const Token* token;
 		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-		if (strequ(token, "||")) {
-			lexer_consume(p->lex);
-		}
-		else break;
-	}
-
-	*matched = 1;
-
-exit:
-	PARSE_FUNC_END();
-	return ecode;
-}
+		const BinaryOperator* op = &binary_operator[token->kind];
+		if (op->precedence == PREC_NONE || op->precedence < min_precedence) break;
+		lexer_consume(p->lex);
 
-static ErrorCode parse_conditional_expression(Parser* p, TNode* parent, int* matched) {
-	PARSE_FUNC_START(conditional_expression);
-	ErrorCode ecode;
-	*matched = 0;
+		TNode* node;
+		if (logical_node != NULL && tnode_type(logical_node) == op->type) {
+			node = logical_node;
+		}
+		else {
+			/* LHS <- operator */
+			if ((ecode = tnode_wrap_child(p->tree, parent, &node, -1)) != ec_noerr) goto exit;
 
-	if ((ecode = parse_logical_or_expression(p, parent, matched)) != ec_noerr) goto exit;
+			if (op->type == tt_binary_expression) {
+				TNodeBinaryExpression data;
+				data.type = op->op;
+				tnode_set(node, tt_binary_expression, &data);
+			}
+			else if (op->type == tt_assignment_expression) {
+				TNodeAssignmentExpression data;
+				data.type = op->op;
+				tnode_set(node, tt_assignment_expression, &data);
+			}
+			else {
+				tnode_set(node, op->type, NULL);
+			}
+			logical_node = op->type == tt_binary_expression || op->type == tt_assignment_expression ? NULL : node;
+		}
 
-	/* Incomplete */
+		/* Parse RHS, it takes the operators which bind tighter, and for
+		   assignment, other assignment operators */
+		int rhs_precedence = op->precedence == PREC_ASSIGNMENT ? PREC_ASSIGNMENT : op->precedence + 1;
+		if ((ecode = parse_binary_expression(p, node, rhs_precedence, &has_match)) != ec_noerr) goto exit;
+		if (!has_match) {
+			ERRMSG("Expected expression\n");
+			ecode = ec_syntaxerr;
+			goto exit;
+		}
+	}
 
 exit:
 	PARSE_FUNC_END();
@@ -1023,88 +923,15 @@ static ErrorCode parse_assignment_expression(Parser* p, TNode* parent, int* matc
 	ErrorCode ecode;
 	*matched = 0;
 
-	/* TODO address concern below */
-	/* For certain tokens, unary-expression can match but fail the
-	   remaining production, it must backtrack to undo the unary-expression
-	   to attempt another rule */
-	/* Cannot check conditional-expression first, assignment-expression may
-	   match, but parent productions fail to match */
-
-	int attached_node = 0;
-	TNode* node;
-	while (1) {
-		if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
-		attached_node = 0;
-
-		TNodeAssignmentExpression data;
-		data.type = TNodeAssignmentExpression_none;
-
-		/* To resolve whether to treat as conditional-expression or unary-expression
-		   | conditional-expression
-		   | unary-expression assignment-operator assignment-expression
-		   always parse for a conditional-expression, then check assumption was valid */
+	/* Assignment operators are parsed with the other binary operators,
+	   the LHS is not checked to be a unary-expression
+	   | conditional-expression
+	   | unary-expression assignment-operator assignment-expression */
+	if ((ecode = parse_binary_expression(p, parent, PREC_ASSIGNMENT, matched)) != ec_noerr) goto exit;
 
-		int has_match;
-		if ((ecode = parse_conditional_expression(p, node, &has_match)) != ec_noerr) goto exit;
-		if (!has_match) break;
-
-		const char* token;
-		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
-
-		if (strequ(token, "=")) {
-			data.type = TNodeAssignmentExpression_assign;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "*=")) {
-			data.type = TNodeAssignmentExpression_mul;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "/=")) {
-			data.type = TNodeAssignmentExpression_div;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "%=")) {
-			data.type = TNodeAssignmentExpression_mod;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "+=")) {
-			data.type = TNodeAssignmentExpression_add;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "-=")) {
-			data.type = TNodeAssignmentExpression_sub;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "<<=")) {
-			data.type = TNodeAssignmentExpression_shl;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, ">>=")) {
-			data.type = TNodeAssignmentExpression_shr;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "&=")) {
-			data.type = TNodeAssignmentExpression_and;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "^=")) {
-			data.type = TNodeAssignmentExpression_xor;
-			lexer_consume(p->lex);
-		}
-		else if (strequ(token, "|=")) {
-			data.type = TNodeAssignmentExpression_or;
-			lexer_consume(p->lex);
-		}
-
-		if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
-		tnode_set(node, tt_assignment_expression, &data);
-		parent = node;
-		*matched = 1;
-		attached_node = 1;
-	}
+	/* Incomplete */
 
 exit:
-	if (!attached_node) tnode_destruct(node);
 	PARSE_FUNC_END();
 	return ecode;
 }
@@ -1122,11 +949,6 @@ static ErrorCode parse_expression(Parser* p, TNode* parent, int* matched) {
 
 	/* Incomplete */
 
-	/* Cleanup the tree by removing unecessary nodes
-	   We cannot know ahead of time if there will be an operator applied,
-	   thus it sometimes creates a node, to realize it is not necessary */
-	if ((ecode = tnode_remove_ifi(parent, -1, cmp_remove_tnode)) != ec_noerr) goto exit;
-
 exit:
 	PARSE_FUNC_END();
 	return ecode;
@@ -1139,7 +961,7 @@ static ErrorCode parse_declaration(Parser* p, TNode* parent, int* matched) {
 
 	int attached_node = 0;
 	TNode* node;
-	if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
+	if ((ecode = tnode_alloc(p->tree, &node)) != ec_noerr) goto exit;
 	tnode_set(node, tt_declaration, NULL);
 
 	int has_match;
@@ -1148,7 +970,7 @@ static ErrorCode parse_declaration(Parser* p, TNode* parent, int* matched) {
 
 	if ((ecode = parse_init_declarator_list(p, node, &has_match)) != ec_noerr) goto exit;
 
-	if ((ecode = parse_expect(p, ";", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_semicolon, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) {
 		ERRMSG("Expected ';'\n");
 		ecode = ec_syntaxerr;
@@ -1170,19 +992,19 @@ static ErrorCode parse_declaration(Parser* p, TNode* parent, int* matched) {
 
 	/* Replace the new-identifier with identifier as now added to symtab */
 	TNode* identifier_node;
-	tnode_replace_child(node, &identifier_node, 2);
+	tnode_replace_child(p->tree, node, &identifier_node, 2);
 
 	TNodeIdentifier data;
 	data.symbol = sym;
 	tnode_set(identifier_node, tt_identifier, &data);
 
 	/* Add to tree */
-	if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
+	if ((ecode = tnode_attach(p->tree, parent, node)) != ec_noerr) goto exit;
 	attached_node = 1;
 	*matched = 1;
 
 exit:
-	if (!attached_node) tnode_destruct(node);
+	if (!attached_node) parse_discard(p, node);
 	PARSE_FUNC_END();
 	return ecode;
 }
@@ -1200,16 +1022,16 @@ static ErrorCode parse_declaration_specifiers(Parser* p, TNode* parent, int* mat
 	do {
 		has_match = 0;
 
-		const char* token;
+		const Token* token;
 		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-		if (tok_isstoreclass(token)) {
+		if (tk_isstoreclass(token->kind)) {
 			// FIXME
 			lexer_consume(p->lex);
 			has_match = 1;
 			*matched = 1;
 		}
-		else if (tok_istypespec(token)) {
+		else if (tk_istypespec(token->kind)) {
 			/* Insert a space after the previous token */
 			if (i_tsbuf > 0) {
 				if (i_tsbuf >= TS_STR_MAX_LEN) break;
@@ -1218,7 +1040,7 @@ static ErrorCode parse_declaration_specifiers(Parser* p, TNode* parent, int* mat
 
 			int i = 0;
 			char c;
-			while ((c = token[i]) != '\0') {
+			while ((c = token->str[i]) != '\0') {
 				if (i_tsbuf >= TS_STR_MAX_LEN) break;
 				tsbuf[i_tsbuf++] = c;
 				++i;
@@ -1229,13 +1051,13 @@ static ErrorCode parse_declaration_specifiers(Parser* p, TNode* parent, int* mat
 			has_match = 1;
 			*matched = 1;
 		}
-		else if (tok_istypequal(token)) {
+		else if (tk_istypequal(token->kind)) {
 			// FIXME
 			lexer_consume(p->lex);
 			has_match = 1;
 			*matched = 1;
 		}
-		else if (tok_isfuncspec(token)) {
+		else if (tk_isfuncspec(token->kind)) {
 			// FIXME
 			lexer_consume(p->lex);
 			has_match = 1;
@@ -1254,7 +1076,7 @@ static ErrorCode parse_declaration_specifiers(Parser* p, TNode* parent, int* mat
 		}
 
 		TNode* node;
-		if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+		if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 		tnode_set(node, tt_declaration_specifiers, &data);
 	}
 
@@ -1273,7 +1095,7 @@ static ErrorCode parse_init_declarator_list(Parser* p, TNode* parent, int* match
 	if (!has_match) goto exit;
 
 	/* FIXME
-	if ((ecode = parse_expect(p, ",", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_comma, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		if (!parse_init_declarator(p, PARSE_CURRENT_NODE)) goto exit;
 	}
@@ -1295,7 +1117,7 @@ static ErrorCode parse_init_declarator(Parser* p, TNode* parent, int* matched) {
 	if ((ecode = parse_declarator(p, parent, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) goto exit;
 
-	if ((ecode = parse_expect(p, "=", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_equal, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		if ((ecode = parse_initializer(p, parent, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
@@ -1353,16 +1175,16 @@ static ErrorCode parse_direct_declarator(Parser* p, TNode* parent, int* matched)
 
 	/* Incomplete */
 	/*
-	if ((ecode = parse_expect(p, "[", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_lbracket, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		if (!parse_assignment_expression(p, PARSE_CURRENT_NODE)) goto exit;
 
-		if ((ecode = parse_expect(p, "]", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_rbracket, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) goto exit;
 	}
 	*/
 
-	if ((ecode = parse_expect(p, "(", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_lparen, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		if ((ecode = parse_parameter_type_list(p, parent, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
@@ -1371,7 +1193,7 @@ static ErrorCode parse_direct_declarator(Parser* p, TNode* parent, int* matched)
 			goto exit;
 		}
 
-		if ((ecode = parse_expect(p, ")", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_rparen, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected ')'\n");
 			ecode = ec_syntaxerr;
@@ -1392,7 +1214,7 @@ static ErrorCode parse_pointer(Parser* p, TNode* parent, int* matched) {
 	int has_match;
 	int pointers = 0;
 	while (1) {
-		if ((ecode = parse_expect(p, "*", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_star, &has_match)) != ec_noerr) goto exit;
 		if (has_match) ++pointers;
 		else break;
 	}
@@ -1400,7 +1222,7 @@ static ErrorCode parse_pointer(Parser* p, TNode* parent, int* matched) {
 	/* It is more convenient to always attach a pointer node and have
 	   pointers=0, than having to decide if a pointer exists */
 	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+	if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 
 	TNodePointer data;
 	data.pointers = pointers;
@@ -1420,19 +1242,19 @@ static ErrorCode parse_parameter_type_list(Parser* p, TNode* parent, int* matche
 
 	int attached_node = 0;
 	TNode* node;
-	if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
+	if ((ecode = tnode_alloc(p->tree, &node)) != ec_noerr) goto exit;
 	tnode_set(node, tt_parameter_type_list, NULL);
 
 	int has_match;
 	if ((ecode = parse_parameter_list(p, node, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		*matched = 1;
-		if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
+		if ((ecode = tnode_attach(p->tree, parent, node)) != ec_noerr) goto exit;
 		attached_node = 1;
 	}
 
 exit:
-	if (!attached_node) tnode_destruct(node);
+	if (!attached_node) parse_discard(p, node);
 	PARSE_FUNC_END();
 	return ecode;
 }
@@ -1446,16 +1268,21 @@ static ErrorCode parse_parameter_list(Parser* p, TNode* parent, int* matched) {
 	/* parameter-list -> parameter-declaration
 					   | parameter-declaration , parameter-list */
 
-	TNode* node;
+	TNode* node = NULL;
 	while (1) {
-		if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
+		/* Allocate only once a parameter-declaration is certain */
+		const Token* token;
+		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
+		if (!tk_isdeclspec(token->kind)) break;
+
+		if ((ecode = tnode_alloc(p->tree, &node)) != ec_noerr) goto exit;
 
 		int has_match;
 		if ((ecode = parse_parameter_declaration(p, node, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) break;
 
 		/* If comma, must have another parameter-list */
-		if ((ecode = parse_expect(p, ",", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_comma, &has_match)) != ec_noerr) goto exit;
 
 
 		/* Add symbol (parameter) to symtab */
@@ -1472,14 +1299,15 @@ static ErrorCode parse_parameter_list(Parser* p, TNode* parent, int* matched) {
 		if (ecode != ec_noerr) goto exit;
 
 		/* Add to tree */
-		if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
+		if ((ecode = tnode_attach(p->tree, parent, node)) != ec_noerr) goto exit;
 		tnode_set(node, tt_parameter_list, NULL);
+		node = NULL;
 		*matched = 1;
 	}
 
 exit:
-	/* Upon exiting, it always has an unattached node */
-	tnode_destruct(node);
+	/* Node which was not attached, if any */
+	parse_discard(p, node);
 	PARSE_FUNC_END();
 	return ecode;
 }
@@ -1542,42 +1370,41 @@ static ErrorCode parse_initializer(Parser* p, TNode* parent, int* matched) {
 matched:
 	*matched = 1;
 
-	/* Cleanup the tree by removing unecessary nodes
-	   We cannot know ahead of time if there will be an operator applied,
-	   thus it sometimes creates a node, to realize it is not necessary */
-	if ((ecode = tnode_remove_if(parent, cmp_remove_tnode)) != ec_noerr) goto exit;
-
 exit:
 	PARSE_FUNC_END();
 	return ecode;
 }
 
+typedef ErrorCode (*ParseFunc)(Parser* p, TNode* parent, int* matched);
+
+/* Statement production chosen by the first token of the statement,
+   indexed by TokenKind. The first tokens of the productions do not
+   overlap, so only the chosen production is tried. Tokens not listed
+   begin an expression-statement */
+static const ParseFunc statement_production[tk_count] = {
+	[tk_lbrace] = parse_compound_statement,
+	[tk_if] = parse_selection_statement,
+	[tk_while] = parse_iteration_statement,
+	[tk_do] = parse_iteration_statement,
+	[tk_for] = parse_iteration_statement,
+	[tk_continue] = parse_jump_statement,
+	[tk_break] = parse_jump_statement,
+	[tk_return] = parse_jump_statement,
+};
+
 static ErrorCode parse_statement(Parser* p, TNode* parent, int* matched) {
 	PARSE_FUNC_START(statement);
 	ErrorCode ecode;
 	*matched = 0;
 
-	int has_match;
-	if ((ecode = parse_compound_statement(p, parent, &has_match)) != ec_noerr) goto exit;
-	if (has_match) goto matched;
-
-	if ((ecode = parse_expression_statement(p, parent, &has_match)) != ec_noerr) goto exit;
-	if (has_match) goto matched;
-
-	if ((ecode = parse_selection_statement(p, parent, &has_match)) != ec_noerr) goto exit;
-	if (has_match) goto matched;
-
-	if ((ecode = parse_iteration_statement(p, parent, &has_match)) != ec_noerr) goto exit;
-	if (has_match) goto matched;
+	const Token* token;
+	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-	if ((ecode = parse_jump_statement(p, parent, &has_match)) != ec_noerr) goto exit;
-	if (has_match) goto matched;
+	ParseFunc production = statement_production[token->kind];
+	if (production == NULL) production = parse_expression_statement;
+	if ((ecode = production(p, parent, matched)) != ec_noerr) goto exit;
 
 	/* Incomplete */
-	goto exit;
-
-matched:
-	*matched = 1;
 
 exit:
 	PARSE_FUNC_END();
@@ -1590,11 +1417,11 @@ static ErrorCode parse_compound_statement(Parser* p, TNode* parent, int* matched
 	*matched = 0;
 
 	int has_match;
-	if ((ecode = parse_expect(p, "{", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_lbrace, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) goto exit;
 
 	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+	if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 	tnode_set(node, tt_compound_statement, NULL);
 
 	if ((ecode = symtab_push_scope(p->symtab)) != ec_noerr) goto exit;
@@ -1603,7 +1430,7 @@ static ErrorCode parse_compound_statement(Parser* p, TNode* parent, int* matched
 		if ((ecode = parse_block_item(p, node, &has_match)) != ec_noerr) goto exit;
 	} while (has_match);
 
-	if ((ecode = parse_expect(p, "}", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_rbrace, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) {
 		ERRMSG("Expected '}' to end compound statement\n");
 		ecode = ec_syntaxerr;
@@ -1622,17 +1449,17 @@ static ErrorCode parse_block_item(Parser* p, TNode* parent, int* matched) {
 	ErrorCode ecode;
 	*matched = 0;
 
-	int has_match;
-	if ((ecode = parse_declaration(p, parent, &has_match)) != ec_noerr) goto exit;
-	if (has_match) {
-		*matched = 1;
-		goto exit;
-	}
+	const Token* token;
+	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-	if ((ecode = parse_statement(p, parent, &has_match)) != ec_noerr) goto exit;
-	if (has_match) {
-		*matched = 1;
-		goto exit;
+	/* } ends the block-item-list */
+	if (token->kind == tk_rbrace) goto exit;
+
+	if (tk_isdeclspec(token->kind)) {
+		if ((ecode = parse_declaration(p, parent, matched)) != ec_noerr) goto exit;
+	}
+	else {
+		if ((ecode = parse_statement(p, parent, matched)) != ec_noerr) goto exit;
 	}
 
 exit:
@@ -1649,7 +1476,7 @@ static ErrorCode parse_expression_statement(Parser* p, TNode* parent, int* match
 	if ((ecode = parse_expression(p, parent, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) goto exit;
 
-	if ((ecode = parse_expect(p, ";", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_semicolon, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) {
 		ERRMSG("Expected ';'\n");
 		ecode = ec_syntaxerr;
@@ -1669,15 +1496,15 @@ static ErrorCode parse_selection_statement(Parser* p, TNode* parent, int* matche
 	*matched = 0;
 
 	int has_match;
-	if ((ecode = parse_expect(p, "if", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_if, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) goto exit;
 
 	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+	if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 	tnode_set(node, tt_selection_statement, NULL);
 
 	/* ( must follow if */
-	if ((ecode = parse_expect(p, "(", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_lparen, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) {
 		ERRMSG("Expected '('\n");
 		ecode = ec_syntaxerr;
@@ -1692,7 +1519,7 @@ static ErrorCode parse_selection_statement(Parser* p, TNode* parent, int* matche
 	}
 
 	/* ) must follow if */
-	if ((ecode = parse_expect(p, ")", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_rparen, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) {
 		ERRMSG("Expected ')'\n");
 		ecode = ec_syntaxerr;
@@ -1710,7 +1537,7 @@ static ErrorCode parse_selection_statement(Parser* p, TNode* parent, int* matche
 	*matched = 1;
 
 	/* else optional */
-	if ((ecode = parse_expect(p, "else", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_else, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) goto exit;
 
 	/* statement must follow else */
@@ -1734,18 +1561,18 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 	*matched = 0;
 
 	int has_match;
-	const char* token;
+	const Token* token;
 	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
 
-	if (strequ(token, "while")) {
+	if (token->kind == tk_while) {
 		lexer_consume(p->lex);
 
 		TNode* node;
-		if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+		if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 		tnode_set(node, tt_while_statement, NULL);
 
 		/* ( must follow while */
-		if ((ecode = parse_expect(p, "(", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_lparen, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected '(' after while\n");
 			ecode = ec_syntaxerr;
@@ -1760,7 +1587,7 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 		}
 
 		/* ) must follow */
-		if ((ecode = parse_expect(p, ")", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_rparen, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected ')' after expression\n");
 			ecode = ec_syntaxerr;
@@ -1777,11 +1604,11 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 
 		*matched = 1;
 	}
-	else if (strequ(token, "do")) {
+	else if (token->kind == tk_do) {
 		lexer_consume(p->lex);
 
 		TNode* node;
-		if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+		if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 		tnode_set(node, tt_do_statement, NULL);
 
 		/* statement must follow */
@@ -1793,7 +1620,7 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 		}
 
 		/* while must follow */
-		if ((ecode = parse_expect(p, "while", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_while, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected 'while' after statement\n");
 			ecode = ec_syntaxerr;
@@ -1801,7 +1628,7 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 		}
 
 		/* ( must follow while */
-		if ((ecode = parse_expect(p, "(", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_lparen, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected '(' after while\n");
 			ecode = ec_syntaxerr;
@@ -1816,7 +1643,7 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 		}
 
 		/* ) must follow */
-		if ((ecode = parse_expect(p, ")", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_rparen, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected ')' after expression\n");
 			ecode = ec_syntaxerr;
@@ -1824,7 +1651,7 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 		}
 
 		/* ; must follow */
-		if ((ecode = parse_expect(p, ";", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_semicolon, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected ';' after ')'\n");
 			ecode = ec_syntaxerr;
@@ -1833,14 +1660,14 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 
 		*matched = 1;
 	}
-	else if (strequ(token, "for")) {
+	else if (token->kind == tk_for) {
 		lexer_consume(p->lex);
 
 		/* New scope for the declaration */
 		if ((ecode = symtab_push_scope(p->symtab)) != ec_noerr) goto exit;
 
 		/* ( must follow for */
-		if ((ecode = parse_expect(p, "(", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_lparen, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected '(' after for\n");
 			ecode = ec_syntaxerr;
@@ -1848,25 +1675,29 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 		}
 
 		TNode* node;
-		if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+		if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 		tnode_set(node, tt_for_statement, NULL);
 
 		/* Can either be one of following forms
 		   | declaration
 		   | expression(opt) ; */
 
-		if ((ecode = parse_declaration(p, node, &has_match)) != ec_noerr) goto exit;
+		has_match = 0;
+		if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
+		if (tk_isdeclspec(token->kind)) {
+			if ((ecode = parse_declaration(p, node, &has_match)) != ec_noerr) goto exit;
+		}
 		if (!has_match) {
 			/* Not a declaration then must be -> expression(opt) ; */
 			if ((ecode = parse_expression(p, node, &has_match)) != ec_noerr) goto exit;
 			if (!has_match) {
 				TNode* n;
-				if ((ecode = tnode_alloca(&n, node)) != ec_noerr) goto exit;
+				if ((ecode = tnode_alloca(p->tree, &n, node)) != ec_noerr) goto exit;
 				tnode_set(n, tt_dummy, NULL);
 			}
 
 			/* ; must follow */
-			if ((ecode = parse_expect(p, ";", &has_match)) != ec_noerr) goto exit;
+			if ((ecode = parse_expect(p, tk_semicolon, &has_match)) != ec_noerr) goto exit;
 			if (!has_match) {
 				ERRMSG("Expected ';' after expression\n");
 				ecode = ec_syntaxerr;
@@ -1879,12 +1710,12 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 		if (!has_match) {
 			/* Put a dummy node so IL gen can tell this expression omitted */
 			TNode* n;
-			if ((ecode = tnode_alloca(&n, node)) != ec_noerr) goto exit;
+			if ((ecode = tnode_alloca(p->tree, &n, node)) != ec_noerr) goto exit;
 			tnode_set(n, tt_dummy, NULL);
 		}
 
 		/* ; must follow */
-		if ((ecode = parse_expect(p, ";", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_semicolon, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected ';' after controlling expression\n");
 			ecode = ec_syntaxerr;
@@ -1895,12 +1726,12 @@ static ErrorCode parse_iteration_statement(Parser* p, TNode* parent, int* matche
 		if ((ecode = parse_expression(p, node, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			TNode* n;
-			if ((ecode = tnode_alloca(&n, node)) != ec_noerr) goto exit;
+			if ((ecode = tnode_alloca(p->tree, &n, node)) != ec_noerr) goto exit;
 			tnode_set(n, tt_dummy, NULL);
 		}
 
 		/* ) must follow */
-		if ((ecode = parse_expect(p, ")", &has_match)) != ec_noerr) goto exit;
+		if ((ecode = parse_expect(p, tk_rparen, &has_match)) != ec_noerr) goto exit;
 		if (!has_match) {
 			ERRMSG("Expected ')' after expression\n");
 			ecode = ec_syntaxerr;
@@ -1932,19 +1763,19 @@ static ErrorCode parse_jump_statement(Parser* p, TNode* parent, int* matched) {
 
 	TNodeJumpStatement data;
 	int has_match;
-	if ((ecode = parse_expect(p, "continue", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_continue, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		data.type = TNodeJumpStatement_continue;
 		goto matched;
 	}
 
-	if ((ecode = parse_expect(p, "break", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_break, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		data.type = TNodeJumpStatement_break;
 		goto matched;
 	}
 
-	if ((ecode = parse_expect(p, "return", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_return, &has_match)) != ec_noerr) goto exit;
 	if (has_match) {
 		data.type = TNodeJumpStatement_return;
 		goto matched;
@@ -1954,13 +1785,13 @@ static ErrorCode parse_jump_statement(Parser* p, TNode* parent, int* matched) {
 
 matched:;
 	TNode* node;
-	if ((ecode = tnode_alloca(&node, parent)) != ec_noerr) goto exit;
+	if ((ecode = tnode_alloca(p->tree, &node, parent)) != ec_noerr) goto exit;
 	tnode_set(node, tt_jump_statement, &data);
 
 	if ((ecode = parse_expression(p, node, &has_match)) != ec_noerr) goto exit;
 	;
 
-	if ((ecode = parse_expect(p, ";", &has_match)) != ec_noerr) goto exit;
+	if ((ecode = parse_expect(p, tk_semicolon, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) {
 		ERRMSG("Expected ';'\n");
 		ecode = ec_syntaxerr;
@@ -1990,33 +1821,56 @@ exit:
 	return ecode;
 }
 
+ErrorCode parse_next_external_declaration(Parser* p, int* parsed) {
+	ErrorCode ecode;
+	*parsed = 0;
+
+	const Token* token;
+	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) return ecode;
+	if (token->kind == tk_eof) return ec_noerr;
+
+	int matched;
+	if ((ecode = parse_external_declaration(p, tree_root(p->tree), &matched)) != ec_noerr) return ecode;
+	*parsed = 1;
+	return ec_noerr;
+}
+
 static ErrorCode parse_external_declaration(Parser* p, TNode* parent, int* matched) {
 	PARSE_FUNC_START(external_declaration);
 	ErrorCode ecode = ec_noerr;
 	*matched = 0;
 
 	int attached_node = 0;
-	TNode* node;
-	if ((ecode = tnode_alloc(&node)) != ec_noerr) goto exit;
+	int pushed_scope = 0;
+	TNode* node = NULL;
 
-	/* Must be a declaration-specifiers */
-	int has_match;
-	if ((ecode = parse_declaration_specifiers(p, node, &has_match)) != ec_noerr) goto exit;
-	if (!has_match) {
+	/* Must be a declaration-specifiers, checked before allocating */
+	const Token* token;
+	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
+	if (!tk_isdeclspec(token->kind)) {
 		ERRMSG("Expected declaration-specifiers\n");
 		ecode = ec_syntaxerr;
 		goto exit;
 	}
 
+	if ((ecode = tnode_alloc(p->tree, &node)) != ec_noerr) goto exit;
+
+	int has_match;
+	if ((ecode = parse_declaration_specifiers(p, node, &has_match)) != ec_noerr) goto exit;
+	ASSERT(has_match, "Expected declaration-specifiers");
+
 	/* declaration -> declaration-specifiers ; */
 	/* Useless declaration */
-	const char* token;
 	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) goto exit;
-	if (strequ(token, ";")) {
+	if (token->kind == tk_semicolon) {
 		lexer_consume(p->lex);
 		goto exit;
 	}
 
+	/* Parameters are visible only within the function */
+	if ((ecode = symtab_push_scope(p->symtab)) != ec_noerr) goto exit;
+	pushed_scope = 1;
+
 	/* Must be a declarator */
 	if ((ecode = parse_declarator(p, node, &has_match)) != ec_noerr) goto exit;
 	if (!has_match) {
@@ -2047,7 +1901,7 @@ static ErrorCode parse_external_declaration(Parser* p, TNode* parent, int* match
 			goto exit;
 		}
 
-		/* Save function symbol */
+		/* Save function symbol, visible within its own body */
 		Symbol* sym;
 		ecode = symtab_add(p->symtab, &sym, identifier->token, &function_type);
 		type_destruct(&function_type);
@@ -2062,30 +1916,90 @@ static ErrorCode parse_external_declaration(Parser* p, TNode* parent, int* match
 			goto exit;
 		}
 
-		if ((ecode = tnode_attach(parent, node)) != ec_noerr) goto exit;
+		/* Function is visible to the rest of the file */
+		symtab_pop_scope(p->symtab);
+		pushed_scope = 0;
+		if ((ecode = symtab_bind(p->symtab, sym)) != ec_noerr) goto exit;
+
+		if ((ecode = tnode_attach(p->tree, parent, node)) != ec_noerr) goto exit;
 		tnode_set(node, tt_function_definition, NULL);
 		attached_node = 1;
 		*matched = 1;
 	}
 
 exit:
-	if (!attached_node) tnode_destruct(node);
+	if (pushed_scope) symtab_pop_scope(p->symtab);
+	if (!attached_node) parse_discard(p, node);
 	PARSE_FUNC_END();
 	return ecode;
 }
 
-/* Return 1 if next token read matches provided token, 0 otherwise */
-/* The token is consumed if it matches the provided token */
-static ErrorCode parse_expect(Parser* p, const char* match_token, int* matched) {
+/* Return 1 if next token read is of provided kind, 0 otherwise */
+/* The token is consumed if it is of the provided kind */
+static ErrorCode parse_expect(Parser* p, TokenKind kind, int* matched) {
 	ErrorCode ecode;
 	*matched = 0;
 
-	const char* token;
+	const Token* token;
 	if ((ecode = lexer_getc(p->lex, &token)) != ec_noerr) return ecode;
 
-	if (strequ(token, match_token)) {
+	if (token->kind == kind) {
 		lexer_consume(p->lex);
 		*matched = 1;
 	}
 	return ecode;
 }
+
+/* Destructs node allocated for a production which did not match */
+static void parse_discard(Parser* p, TNode* node) {
+	int destructed = p->tree->node_destructed;
+	tnode_destruct(p->tree, node);
+	p->stats.discarded_nodes += p->tree->node_destructed - destructed;
+}
+
+void debug_print_parse_stats(Parser* p) {
+	ASSERT(p != NULL, "Parser is null");
+	LOG("Parse stats:\n");
+	LOGF("  Productions: %d (%d failed)\n", p->stats.productions, p->stats.failed_productions);
+	LOGF("  Discarded nodes: %d\n", p->stats.discarded_nodes);
+}
+
+ErrorCode debug_print_parse_profile(const char* json_path) {
+#if CC_PARSE_PROFILE
+	LOG("Parse profile:\n");
+	LOGF("  %-26s %10s %10s %10s %10s %10s %12s\n", "Function", "Calls", "Matched", "Failed", "Nodes", "Discarded",
+		 "Time (ms)");
+	for (int i = 0; i < pf_count; ++i) {
+		const ParseProfile* profile = &parse_profile[i];
+		if (profile->calls == 0) continue;
+		LOGF("  %-26s %10d %10d %10d %10d %10d %12.3f\n", parse_func_str[i], profile->calls, profile->matches,
+			 profile->calls - profile->matches, profile->nodes_allocated, profile->nodes_discarded,
+			 (double)profile->time / 1e6);
+	}
+
+	FILE* f = fopen(json_path, "w");
+	if (f == NULL) {
+		ERRMSG("Failed to open parse profile file\n");
+		return ec_writefailed;
+	}
+	fprintf(f, "{\"functions\": [");
+	int first = 1;
+	for (int i = 0; i < pf_count; ++i) {
+		const ParseProfile* profile = &parse_profile[i];
+		if (profile->calls == 0) continue;
+		fprintf(f,
+				"%s\n  {\"name\": \"%s\", \"calls\": %d, \"matched\": %d, \"failed\": %d, "
+				"\"nodes_allocated\": %d, \"nodes_discarded\": %d, \"time_ns\": %lld}",
+				first ? "" : ",", parse_func_str[i], profile->calls, profile->matches, profile->calls - profile->matches,
+				profile->nodes_allocated, profile->nodes_discarded, (long long)profile->time);
+		first = 0;
+	}
+	fprintf(f, "\n]}\n");
+	fclose(f);
+	return ec_noerr;
+#else
+	(void)json_path;
+	ERRMSG("Parser profile not available, built with CC_PARSE_PROFILE=0\n");
+	return ec_noerr;
+#endif
+}
@@ -6,11 +6,29 @@
 #include "symtab.h"
 #include "tree.h"
 
+/* Set to 0 to compile out the profiler for -dprofile-parse */
+#ifndef CC_PARSE_PROFILE
+#define CC_PARSE_PROFILE 1
+#endif
+
+/* Counts of the work done while parsing */
+typedef struct
+{
+	/* Productions attempted, and those which did not match */
+	int productions;
+	int failed_productions;
+	/* Nodes allocated for a production, then destructed without being
+	   added to the tree */
+	int discarded_nodes;
+} ParseStats;
+
 typedef struct
 {
 	Lexer* lex;
 	Symtab* symtab;
 	Tree* tree;
+
+	ParseStats stats;
 } Parser;
 
 ErrorCode parser_construct(Parser* p, Lexer* lex, Symtab* symtab, Tree* tree);
@@ -20,4 +38,18 @@ ErrorCode parser_construct(Parser* p, Lexer* lex, Symtab* symtab, Tree* tree);
    stores into tree */
 ErrorCode parse_translation_unit(Parser* p);
 
+/* Parses the next external declaration of the translation unit,
+   reads from Lexer,
+   stores into tree as a child of the root
+   0 stored at pointer if at the end of the translation unit, 1 if an
+   external declaration was parsed */
+ErrorCode parse_next_external_declaration(Parser* p, int* parsed);
+
+/* Prints out the counts of productions attempted and nodes discarded */
+void debug_print_parse_stats(Parser* p);
+
+/* Prints out the calls, matches, nodes allocated and time of each parse
+   function as a table, and writes them as JSON to json_path */
+ErrorCode debug_print_parse_profile(const char* json_path);
+
 #endif
@@ -0,0 +1,428 @@
+#include "sccp.h"
+
+#include <inttypes.h>
+#include <stdio.h>
+
+#include "common.h"
+
+ErrorCode sccp_construct(Sccp* sccp) {
+	ASSERT(sccp != NULL, "Sccp is null");
+	sccp->ssa = NULL;
+	sccp->stab = NULL;
+	vec_construct(&sccp->lattice);
+	vec_construct(&sccp->value);
+	vec_construct(&sccp->exec);
+	sccp->changed = 0;
+	return ec_noerr;
+}
+
+void sccp_destruct(Sccp* sccp) {
+	ASSERT(sccp != NULL, "Sccp is null");
+	vec_destruct(&sccp->exec);
+	vec_destruct(&sccp->value);
+	vec_destruct(&sccp->lattice);
+}
+
+/* Returns the number of bits of integral type ts, long is 32 bits as
+   written by il2_write */
+static int sccp_bits(TypeSpecifiers ts) {
+	switch (type_rank(ts)) {
+	case 1:
+		return 8;
+	case 2:
+		return 16;
+	case 5:
+		return 64;
+	default:
+		return 32;
+	}
+}
+
+/* Returns value of integral type ts, sign extended to 64 bits if ts is
+   signed */
+static uint64_t sccp_extend(uint64_t value, TypeSpecifiers ts) {
+	int bits = sccp_bits(ts);
+	if (bits < 64 && type_signed(ts) && ((value >> (bits - 1)) & 1)) {
+		value |= ~(uint64_t)0 << bits;
+	}
+	return value;
+}
+
+/* Returns value of integral type from converted to the bits of integral
+   type to, the value is kept modulo 2^bits of to (C 6.3.1.3)
+   Widening into an unsigned type zero extends as mtc does in asmgen,
+   e.g., signed char -1 is 255 as unsigned int */
+static uint64_t sccp_convert(uint64_t value, TypeSpecifiers from, TypeSpecifiers to) {
+	int from_bits = sccp_bits(from);
+	int bits = sccp_bits(to);
+	if (type_signed(to) || bits <= from_bits) {
+		value = sccp_extend(value, from);
+	}
+	else if (from_bits < 64) {
+		value &= ((uint64_t)1 << from_bits) - 1;
+	}
+	if (bits < 64) {
+		value &= ((uint64_t)1 << bits) - 1;
+	}
+	return value;
+}
+
+/* Applies C 6.3.1.1 integer promotions to ts */
+static TypeSpecifiers sccp_promote(TypeSpecifiers ts) {
+	return type_rank(ts) < type_rank(ts_int) ? ts_int : ts;
+}
+
+/* Returns 1 if the instruction computes its result from only the values
+   of its operands, 0 otherwise */
+static int sccp_foldable(IL2Ins ins) {
+	switch (ins) {
+	case il2_add:
+	case il2_sub:
+	case il2_mul:
+	case il2_div:
+	case il2_mod:
+	case il2_ce:
+	case il2_cl:
+	case il2_cle:
+	case il2_cne:
+	case il2_not:
+	case il2_mov:
+	case il2_mtc:
+		return 1;
+	default:
+		return 0;
+	}
+}
+
+/* Computes the result of foldable instruction ins in type ts, from the
+   values op of the operands of types op_ts
+   Result saved to provided pointer
+   Returns 1 if the result is a constant, 0 if it is not known at
+   compile time, e.g., division by zero */
+static int sccp_fold(IL2Ins ins, TypeSpecifiers ts, const TypeSpecifiers* op_ts, const uint64_t* op, uint64_t* result) {
+	switch (ins) {
+	case il2_mov:
+	case il2_mtc:
+		*result = sccp_convert(op[0], op_ts[0], ts);
+		return 1;
+	case il2_not:
+		*result = op[0] == 0;
+		return 1;
+	case il2_ce:
+	case il2_cl:
+	case il2_cle:
+	case il2_cne:
+	{
+		/* Operands are compared in their common type */
+		TypeSpecifiers com = type_common_ts(sccp_promote(op_ts[0]), sccp_promote(op_ts[1]));
+		uint64_t x = sccp_extend(sccp_convert(op[0], op_ts[0], com), com);
+		uint64_t y = sccp_extend(sccp_convert(op[1], op_ts[1], com), com);
+		uint64_t less = type_signed(com) ? (int64_t)x < (int64_t)y : x < y;
+		if (ins == il2_ce) *result = x == y;
+		else if (ins == il2_cne) *result = x != y;
+		else if (ins == il2_cl) *result = less;
+		else *result = less || x == y;
+		return 1;
+	}
+	default:
+		break;
+	}
+
+	/* Arithmetic is modulo 2^64, then truncated to the bits of ts */
+	uint64_t x = sccp_extend(sccp_convert(op[0], op_ts[0], ts), ts);
+	uint64_t y = sccp_extend(sccp_convert(op[1], op_ts[1], ts), ts);
+	uint64_t r;
+	switch (ins) {
+	case il2_add:
+		r = x + y;
+		break;
+	case il2_sub:
+		r = x - y;
+		break;
+	case il2_mul:
+		r = x * y;
+		break;
+	case il2_div:
+	case il2_mod:
+		if (y == 0) return 0;
+		if (type_signed(ts)) {
+			/* Quotient of the minimum by -1 is not representable */
+			uint64_t min = sccp_extend((uint64_t)1 << (sccp_bits(ts) - 1), ts);
+			if (x == min && y == ~(uint64_t)0) return 0;
+			r = (uint64_t)(ins == il2_div ? (int64_t)x / (int64_t)y : (int64_t)x % (int64_t)y);
+		}
+		else {
+			r = ins == il2_div ? x / y : x % y;
+		}
+		break;
+	default:
+		ASSERT(0, "Instruction is not foldable");
+		return 0;
+	}
+	*result = sccp_convert(r, ts_ulonglong, ts);
+	return 1;
+}
+
+/* Value of sym saved to provided pointer if it is a constant
+   Returns what is known of the value of sym */
+static SccpLattice sccp_lookup(Sccp* sccp, Symbol* sym, uint64_t* value) {
+	if (symbol_is_constant(sym)) {
+		if (!type_integral(symbol_type(sym))) return sccp_unknown;
+		*value = symbol_constant_value(sym);
+		return sccp_constant;
+	}
+	/* Symbols which are not variables or versions are unknown */
+	int name = (int)symbol_aux(sym) - 1;
+	if (name < 0) return sccp_unknown;
+	*value = vec_at(&sccp->value, name);
+	return (SccpLattice)vec_at(&sccp->lattice, name);
+}
+
+/* Lowers the value of the version at index name to the meet of it and
+   the provided value */
+static void sccp_lower(Sccp* sccp, int name, SccpLattice lattice, uint64_t value) {
+	SccpLattice old = (SccpLattice)vec_at(&sccp->lattice, name);
+	if (lattice == sccp_undefined || old == sccp_unknown) return;
+	if (old == sccp_constant) {
+		if (lattice == sccp_constant && vec_at(&sccp->value, name) == value) return;
+		lattice = sccp_unknown;
+	}
+	vec_at(&sccp->lattice, name) = (uint8_t)lattice;
+	vec_at(&sccp->value, name) = value;
+	sccp->changed = 1;
+}
+
+/* Returns index of the block linked to at index i from block at index
+   blk */
+static int sccp_succ(Sccp* sccp, int blk, int i) {
+	Block* block = &vec_at(&sccp->ssa->cfg->blocks, blk);
+	return (int)(block_next(block, i) - vec_data(&sccp->ssa->cfg->blocks));
+}
+
+/* Returns 1 if control can flow from block at index from to block at
+   index to, 0 otherwise */
+static int sccp_edge(Sccp* sccp, int from, int to) {
+	Block* block = &vec_at(&sccp->ssa->cfg->blocks, from);
+	uint8_t exec = vec_at(&sccp->exec, from);
+	for (int i = 0; i < block_next_count(block); ++i) {
+		if ((exec & (2 << i)) && sccp_succ(sccp, from, i) == to) return 1;
+	}
+	return 0;
+}
+
+/* Marks the link at index i of block at index blk executable, and the
+   block it links to */
+static void sccp_mark(Sccp* sccp, int blk, int i) {
+	uint8_t* exec = &vec_at(&sccp->exec, blk);
+	if (*exec & (2 << i)) return;
+	*exec = (uint8_t)(*exec | (2 << i));
+	vec_at(&sccp->exec, sccp_succ(sccp, blk, i)) |= 1;
+	sccp->changed = 1;
+}
+
+/* Returns the index of the link taken by the jz or jnz at the end of
+   block at index blk if its condition has the provided value, -1 if
+   control leaves the function */
+static int sccp_taken(Sccp* sccp, int blk, uint64_t value) {
+	Cfg* cfg = sccp->ssa->cfg;
+	Block* block = &vec_at(&cfg->blocks, blk);
+	IL2Statement* stat = block_ilstat(block, block_ilstat_count(block) - 1);
+
+	int target = blk + 1;
+	if ((il2stat_ins(stat) == il2_jz) == (value == 0)) {
+		target = (int)(cfg_find_labelled(cfg, il2stat_arg(stat, 0)) - vec_data(&cfg->blocks));
+	}
+	for (int i = 0; i < block_next_count(block); ++i) {
+		if (sccp_succ(sccp, blk, i) == target) return i;
+	}
+	return -1;
+}
+
+/* Lowers the value of the symbol the statement assigns to, if any */
+static void sccp_visit_stat(Sccp* sccp, IL2Statement* stat) {
+	IL2Ins ins = il2stat_ins(stat);
+	if (!il2_isdef(ins)) return;
+
+	Symbol* dest = il2stat_arg(stat, 0);
+	int name = (int)symbol_aux(dest) - 1;
+	if (name < 0 || vec_at(&sccp->lattice, name) == sccp_unknown) return;
+	if (!sccp_foldable(ins)) {
+		sccp_lower(sccp, name, sccp_unknown, 0);
+		return;
+	}
+
+	TypeSpecifiers op_ts[MAX_IL2_ARGS - 1];
+	uint64_t op[MAX_IL2_ARGS - 1];
+	for (int i = 1; i < il2stat_argc(stat); ++i) {
+		Symbol* arg = il2stat_arg(stat, i);
+		SccpLattice lattice = sccp_lookup(sccp, arg, &op[i - 1]);
+		if (lattice != sccp_constant) {
+			sccp_lower(sccp, name, lattice, 0);
+			return;
+		}
+		op_ts[i - 1] = type_typespec(symbol_type(arg));
+	}
+
+	uint64_t result;
+	if (sccp_fold(ins, type_typespec(symbol_type(dest)), op_ts, op, &result)) {
+		sccp_lower(sccp, name, sccp_constant, result);
+	}
+	else {
+		sccp_lower(sccp, name, sccp_unknown, 0);
+	}
+}
+
+/* Lowers the values of the phis and statements of the executable block
+   at index blk, then marks the links control can take out of it */
+static void sccp_visit_block(Sccp* sccp, int blk) {
+	Ssa* ssa = sccp->ssa;
+	SsaBlock* sblk = ssa_block(ssa, blk);
+	for (int i = 0; i < vec_size(&sblk->phi); ++i) {
+		SsaPhi* phi = &vec_at(&sblk->phi, i);
+		int name = (int)symbol_aux(phi->result) - 1;
+		/* Only the versions arriving by executable links merge */
+		for (int j = 0; j < vec_size(&sblk->pred); ++j) {
+			int pred = vec_at(&sblk->pred, j);
+			if (pred >= 0 && !sccp_edge(sccp, pred, blk)) continue;
+
+			uint64_t value = 0;
+			SccpLattice lattice = sccp_lookup(sccp, vec_at(&ssa->phi_arg, phi->arg + j), &value);
+			sccp_lower(sccp, name, lattice, value);
+		}
+	}
+
+	Block* block = &vec_at(&ssa->cfg->blocks, blk);
+	int count = block_ilstat_count(block);
+	for (int i = 0; i < count; ++i) {
+		sccp_visit_stat(sccp, block_ilstat(block, i));
+	}
+
+	IL2Ins ins = count > 0 ? il2stat_ins(block_ilstat(block, count - 1)) : il2_none;
+	if (ins == il2_jz || ins == il2_jnz) {
+		uint64_t value;
+		SccpLattice lattice = sccp_lookup(sccp, il2stat_arg(block_ilstat(block, count - 1), 1), &value);
+		if (lattice == sccp_undefined) return;
+		if (lattice == sccp_constant) {
+			int taken = sccp_taken(sccp, blk, value);
+			if (taken >= 0) sccp_mark(sccp, blk, taken);
+			return;
+		}
+	}
+	for (int i = 0; i < block_next_count(block); ++i) {
+		sccp_mark(sccp, blk, i);
+	}
+}
+
+/* Returns the constant of the provided value in the type of sym
+   Constant saved to provided pointer */
+static ErrorCode sccp_make_constant(Sccp* sccp, Symbol* sym, uint64_t value, Symbol** constant) {
+	char token[24];
+	snprintf(token, sizeof(token), "%" PRIu64, value);
+	return symtab_add_constant(sccp->stab, constant, token, value, symbol_type(sym));
+}
+
+/* Folds the statements of the executable block at index blk, and the
+   jump at its end if its condition is a constant */
+static ErrorCode sccp_rewrite_block(Sccp* sccp, int blk) {
+	ErrorCode ecode;
+	Block* block = &vec_at(&sccp->ssa->cfg->blocks, blk);
+	int count = block_ilstat_count(block);
+	for (int i = 0; i < count; ++i) {
+		IL2Statement* stat = block_ilstat(block, i);
+		IL2Ins ins = il2stat_ins(stat);
+		uint64_t value;
+		Symbol* constant;
+
+		if (il2_isdef(ins) && sccp_foldable(ins) &&
+			sccp_lookup(sccp, il2stat_arg(stat, 0), &value) == sccp_constant) {
+			if ((ecode = sccp_make_constant(sccp, il2stat_arg(stat, 0), value, &constant)) != ec_noerr) return ecode;
+			*stat = il2stat_make2(il2_mov, il2stat_arg(stat, 0), constant);
+			continue;
+		}
+
+		/* Constants replace the versions read by the statement, phi
+		   arguments are left as versions to keep the SSA form
+		   conventional */
+		for (int j = 0; j < il2stat_argc(stat); ++j) {
+			if (!il2stat_isuse(stat, j) || symbol_is_constant(stat->arg[j])) continue;
+			if (sccp_lookup(sccp, stat->arg[j], &value) != sccp_constant) continue;
+			if ((ecode = sccp_make_constant(sccp, stat->arg[j], value, &constant)) != ec_noerr) return ecode;
+			stat->arg[j] = constant;
+		}
+	}
+
+	IL2Statement* last = count > 0 ? block_ilstat(block, count - 1) : NULL;
+	if (last == NULL || (il2stat_ins(last) != il2_jz && il2stat_ins(last) != il2_jnz)) return ec_noerr;
+	if (!symbol_is_constant(il2stat_arg(last, 1))) return ec_noerr;
+
+	/* Only the link taken is kept, the jump is removed if control flows
+	   through to the next block */
+	int taken = sccp_taken(sccp, blk, symbol_constant_value(il2stat_arg(last, 1)));
+	if (taken >= 0 && sccp_succ(sccp, blk, taken) != blk + 1) {
+		*last = il2stat_make1(il2_jmp, il2stat_arg(last, 0));
+	}
+	else {
+		block_remove_ilstat(block, count - 1);
+	}
+	for (int i = block_next_count(block) - 1; i >= 0; --i) {
+		if (i != taken) block_unlink(block, i);
+	}
+	return ec_noerr;
+}
+
+ErrorCode sccp_run(Sccp* sccp, Ssa* ssa, Symtab* stab) {
+	ASSERT(sccp != NULL, "Sccp is null");
+	ASSERT(ssa != NULL, "Ssa is null");
+	ASSERT(ssa->cfg != NULL, "Ssa holds no cfg");
+	ASSERT(stab != NULL, "Symtab is null");
+	ErrorCode ecode;
+
+	sccp->ssa = ssa;
+	sccp->stab = stab;
+	vec_clear(&sccp->lattice);
+	vec_clear(&sccp->value);
+	vec_clear(&sccp->exec);
+
+	/* A variable which is not renamed is its only version, unless its
+	   symbol is the version on entry or it is in memory */
+	int vars = vec_size(&ssa->var);
+	int names = vars + svec_size(&ssa->version);
+	for (int i = 0; i < names; ++i) {
+		SccpLattice lattice = sccp_undefined;
+		if (i < vars) {
+			SsaVar* v = &vec_at(&ssa->var, i);
+			if (v->escaped || v->renamed || !type_integral(symbol_type(v->sym))) lattice = sccp_unknown;
+		}
+		else {
+			SsaVersion* ver = &svec_at(&ssa->version, i - vars);
+			if (!type_integral(symbol_type(&ver->sym))) lattice = sccp_unknown;
+		}
+		if (!vec_push_back(&sccp->lattice, (uint8_t)lattice)) return ec_badalloc;
+		if (!vec_push_back(&sccp->value, 0)) return ec_badalloc;
+	}
+
+	int count = vec_size(&ssa->cfg->blocks);
+	for (int i = 0; i < count; ++i) {
+		if (!vec_push_back(&sccp->exec, 0)) return ec_badalloc;
+	}
+	if (count == 0) return ec_noerr;
+
+	vec_at(&sccp->exec, 0) = 1;
+	do {
+		sccp->changed = 0;
+		for (int i = 0; i < vec_size(&ssa->rpo); ++i) {
+			int blk = vec_at(&ssa->rpo, i);
+			if (vec_at(&sccp->exec, blk) & 1) sccp_visit_block(sccp, blk);
+		}
+	} while (sccp->changed);
+
+	for (int i = 0; i < count; ++i) {
+		if (vec_at(&sccp->exec, i) & 1) {
+			if ((ecode = sccp_rewrite_block(sccp, i)) != ec_noerr) return ecode;
+		}
+		else {
+			block_clear(&vec_at(&ssa->cfg->blocks, i));
+		}
+	}
+	return ec_noerr;
+}
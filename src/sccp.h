@@ -0,0 +1,57 @@
+/* Sparse conditional constant propagation (SCCP) over the SSA form of
+   the IL2 in a Cfg */
+#ifndef SCCP_H
+#define SCCP_H
+
+#include <stdint.h>
+
+#include "errorcode.h"
+#include "ssa.h"
+#include "symtab.h"
+#include "vec.h"
+
+/* What is known of the value of a version, values only move down from
+   undefined, to a constant, to unknown */
+typedef enum
+{
+	sccp_undefined = 0, /* No assignment reached yet */
+	sccp_constant,
+	sccp_unknown
+} SccpLattice;
+
+/* Each version of a variable is given a value assuming only the blocks
+   found executable run, starting from the entry block and following the
+   jumps which can be taken with the values known so far. The blocks are
+   revisited in reverse postorder until nothing changes
+
+   The statements computing a constant are then folded into a mov of the
+   constant, constants replace the versions they are the value of, jumps
+   on a constant become unconditional or are removed, and blocks never
+   executed are emptied */
+typedef struct
+{
+	Ssa* ssa;
+	Symtab* stab;
+
+	/* Indexed by the aux of a version minus 1, see Ssa */
+	vec_t(uint8_t) lattice; /* SccpLattice */
+	vec_t(uint64_t) value;  /* Bits of the constant in the version's type */
+
+	/* One per block, bit 0 is set if the block is executable, bit i + 1
+	   if its link at index i is executable */
+	vec_t(uint8_t) exec;
+
+	int changed; /* A value or block changed in the last visit */
+} Sccp;
+
+ErrorCode sccp_construct(Sccp* sccp);
+
+void sccp_destruct(Sccp* sccp);
+
+/* Propagates and folds the constants of the cfg ssa holds, constants
+   made by folding are added to stab
+   The blocks keep their phis and predecessors in ssa, which can only
+   be reverted afterwards */
+ErrorCode sccp_run(Sccp* sccp, Ssa* ssa, Symtab* stab);
+
+#endif
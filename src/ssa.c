@@ -0,0 +1,699 @@
+#include "ssa.h"
+
+#include "common.h"
+
+/* Block visited by the depth first search, with the index of its next
+   link to visit */
+typedef struct
+{
+	int block;
+	int link;
+} SsaVisit;
+
+/* Block assigning to a variable */
+typedef struct
+{
+	int var;
+	int block;
+} SsaDef;
+
+/* Version of a variable to restore once the renaming of the block which
+   defined a newer version is done */
+typedef struct
+{
+	int var;
+	Symbol* top;
+} SsaUndo;
+
+typedef vec_t(SsaUndo) SsaUndoLog;
+
+/* Block being renamed, with the index of its next child in the
+   dominator tree to rename, and the undo entries to keep once done */
+typedef struct
+{
+	int block;
+	int child;
+	int undo;
+} SsaRename;
+
+/* Returns the index of the variable sym is or is a version of, including
+   escaped variables, -1 if none */
+static int ssa_find(Ssa* ssa, Symbol* sym) {
+	int name = (int)symbol_aux(sym) - 1;
+	if (name < 0) return -1;
+	if (name < vec_size(&ssa->var)) return name;
+	return (&svec_at(&ssa->version, name - vec_size(&ssa->var)))->var;
+}
+
+/* Returns index of the block linked to at index i from block at index
+   blk */
+static int ssa_succ(Ssa* ssa, int blk, int i) {
+	Block* block = &vec_at(&ssa->cfg->blocks, blk);
+	return (int)(block_next(block, i) - vec_data(&ssa->cfg->blocks));
+}
+
+/* Destructs the blocks and versions, the storage is kept to convert
+   another cfg */
+static void ssa_clear(Ssa* ssa) {
+	for (int i = 0; i < vec_size(&ssa->var); ++i) {
+		symbol_set_aux(vec_at(&ssa->var, i).sym, 0);
+	}
+	for (int i = 0; i < vec_size(&ssa->block); ++i) {
+		SsaBlock* sblk = &vec_at(&ssa->block, i);
+		vec_destruct(&sblk->pred);
+		vec_destruct(&sblk->child);
+		vec_destruct(&sblk->frontier);
+		vec_destruct(&sblk->phi);
+	}
+	vec_clear(&ssa->block);
+	vec_clear(&ssa->rpo);
+	vec_clear(&ssa->phi_arg);
+	vec_clear(&ssa->var);
+
+	for (int i = 0; i < svec_size(&ssa->version); ++i) {
+		SsaVersion* ver = &svec_at(&ssa->version, i);
+		symbol_destruct(&ver->sym);
+	}
+	svec_clear(&ssa->version);
+	ssa->cfg = NULL;
+}
+
+ErrorCode ssa_construct(Ssa* ssa) {
+	ASSERT(ssa != NULL, "Ssa is null");
+	ssa->cfg = NULL;
+	vec_construct(&ssa->block);
+	vec_construct(&ssa->rpo);
+	vec_construct(&ssa->phi_arg);
+	vec_construct(&ssa->var);
+	svec_construct(&ssa->version);
+	return ec_noerr;
+}
+
+void ssa_destruct(Ssa* ssa) {
+	ASSERT(ssa != NULL, "Ssa is null");
+	ssa_clear(ssa);
+	vec_destruct(&ssa->block);
+	vec_destruct(&ssa->rpo);
+	vec_destruct(&ssa->phi_arg);
+	vec_destruct(&ssa->var);
+	svec_destruct(&ssa->version);
+}
+
+/* Finds the reachable blocks in reverse postorder, and the reachable
+   predecessors of each block */
+static ErrorCode ssa_order(Ssa* ssa) {
+	ErrorCode ecode = ec_noerr;
+	int count = vec_size(&ssa->cfg->blocks);
+
+	for (int i = 0; i < count; ++i) {
+		if (!vec_push_backu(&ssa->block)) return ec_badalloc;
+		SsaBlock* sblk = &vec_back(&ssa->block);
+		vec_construct(&sblk->pred);
+		vec_construct(&sblk->child);
+		vec_construct(&sblk->frontier);
+		vec_construct(&sblk->phi);
+		sblk->idom = -1;
+		sblk->rpo = -1;
+	}
+	if (count == 0) return ec_noerr;
+
+	/* Depth first search without recursion from the entry block, rpo is
+	   set to 0 once a block is visited */
+	vec_t(SsaVisit) stack;
+	vec_construct(&stack);
+	if (!vec_push_back(&stack, ((SsaVisit){0, 0}))) {
+		ecode = ec_badalloc;
+		goto exit;
+	}
+	vec_at(&ssa->block, 0).rpo = 0;
+	while (!vec_empty(&stack)) {
+		SsaVisit* visit = &vec_back(&stack);
+		Block* blk = &vec_at(&ssa->cfg->blocks, visit->block);
+		if (visit->link < block_next_count(blk)) {
+			int next = ssa_succ(ssa, visit->block, visit->link);
+			++visit->link;
+			if (vec_at(&ssa->block, next).rpo < 0) {
+				vec_at(&ssa->block, next).rpo = 0;
+				if (!vec_push_back(&stack, ((SsaVisit){next, 0}))) {
+					ecode = ec_badalloc;
+					goto exit;
+				}
+			}
+		}
+		else {
+			/* Postorder, reversed after */
+			if (!vec_push_back(&ssa->rpo, visit->block)) {
+				ecode = ec_badalloc;
+				goto exit;
+			}
+			(void)vec_pop_back(&stack);
+		}
+	}
+
+	int reachable = vec_size(&ssa->rpo);
+	for (int i = 0; i < reachable / 2; ++i) {
+		int tmp = vec_at(&ssa->rpo, i);
+		vec_at(&ssa->rpo, i) = vec_at(&ssa->rpo, reachable - 1 - i);
+		vec_at(&ssa->rpo, reachable - 1 - i) = tmp;
+	}
+
+	/* The entry block is also entered from outside the function, this
+	   is the predecessor -1 */
+	if (!vec_push_back(&vec_at(&ssa->block, 0).pred, -1)) {
+		ecode = ec_badalloc;
+		goto exit;
+	}
+	for (int i = 0; i < reachable; ++i) {
+		int b = vec_at(&ssa->rpo, i);
+		vec_at(&ssa->block, b).rpo = i;
+
+		Block* blk = &vec_at(&ssa->cfg->blocks, b);
+		for (int j = 0; j < block_next_count(blk); ++j) {
+			int next = ssa_succ(ssa, b, j);
+			if (!vec_push_back(&vec_at(&ssa->block, next).pred, b)) {
+				ecode = ec_badalloc;
+				goto exit;
+			}
+		}
+	}
+
+exit:
+	vec_destruct(&stack);
+	return ecode;
+}
+
+/* Returns the closest block dominating both blocks b1 and b2 */
+static int ssa_intersect(Ssa* ssa, int b1, int b2) {
+	while (b1 != b2) {
+		while (vec_at(&ssa->block, b1).rpo > vec_at(&ssa->block, b2).rpo) {
+			b1 = vec_at(&ssa->block, b1).idom;
+		}
+		while (vec_at(&ssa->block, b2).rpo > vec_at(&ssa->block, b1).rpo) {
+			b2 = vec_at(&ssa->block, b2).idom;
+		}
+	}
+	return b1;
+}
+
+/* Computes the immediate dominators iteratively in reverse postorder
+   (Cooper, Harvey, Kennedy: A Simple, Fast Dominance Algorithm), then
+   the dominator tree and the dominance frontiers */
+static ErrorCode ssa_dominators(Ssa* ssa) {
+	int reachable = vec_size(&ssa->rpo);
+	if (reachable == 0) return ec_noerr;
+
+	vec_at(&ssa->block, 0).idom = 0;
+	int changed = 1;
+	while (changed) {
+		changed = 0;
+		for (int i = 1; i < reachable; ++i) {
+			SsaBlock* sblk = &vec_at(&ssa->block, vec_at(&ssa->rpo, i));
+			int idom = -1;
+			for (int j = 0; j < vec_size(&sblk->pred); ++j) {
+				int pred = vec_at(&sblk->pred, j);
+				/* Not processed yet */
+				if (vec_at(&ssa->block, pred).idom < 0) continue;
+				idom = idom < 0 ? pred : ssa_intersect(ssa, pred, idom);
+			}
+			if (sblk->idom != idom) {
+				sblk->idom = idom;
+				changed = 1;
+			}
+		}
+	}
+
+	for (int i = 1; i < reachable; ++i) {
+		int b = vec_at(&ssa->rpo, i);
+		if (!vec_push_back(&vec_at(&ssa->block, vec_at(&ssa->block, b).idom).child, b)) return ec_badalloc;
+	}
+
+	/* Walk up the dominator tree from each predecessor of a join, until
+	   the dominator of the join. The entry block is in the frontier of
+	   the blocks which loop back to it, as it is also entered from
+	   outside the function */
+	for (int i = 0; i < reachable; ++i) {
+		int b = vec_at(&ssa->rpo, i);
+		SsaBlock* sblk = &vec_at(&ssa->block, b);
+		if (vec_size(&sblk->pred) < 2) continue;
+
+		for (int j = 0; j < vec_size(&sblk->pred); ++j) {
+			int runner = vec_at(&sblk->pred, j);
+			if (runner < 0) continue;
+			while (runner != sblk->idom || b == 0) {
+				SsaBlock* srunner = &vec_at(&ssa->block, runner);
+				/* Frontier of runner is built one join at a time */
+				if (vec_empty(&srunner->frontier) || vec_back(&srunner->frontier) != b) {
+					if (!vec_push_back(&srunner->frontier, b)) return ec_badalloc;
+				}
+				if (runner == 0) break;
+				runner = srunner->idom;
+			}
+		}
+	}
+	return ec_noerr;
+}
+
+/* Returns 1 if sym may be renamed into versions, 0 otherwise */
+static int ssa_renamable(Symbol* sym) {
+	if (symbol_is_constant(sym)) return 0;
+	if (symbol_class(sym) != sl_normal) return 0;
+	Type* type = symbol_type(sym);
+	return type_is_standard(type) && !type_array(type);
+}
+
+/* Adds the variable for sym if it is not already added
+   Index of the variable saved to provided pointer */
+static ErrorCode ssa_add_var(Ssa* ssa, Symbol* sym, int* var) {
+	*var = ssa_find(ssa, sym);
+	if (*var >= 0) return ec_noerr;
+
+	/* Variables at file scope can be assigned by calls */
+	uint8_t escaped = (uint8_t)symbol_file_scope(sym);
+	SsaVar v = {.sym = sym, .top = sym, .versions = 0, .defs = 0, .def_block = -1, .escaped = escaped, .global = 0, .renamed = 0};
+	if (!vec_push_back(&ssa->var, v)) return ec_badalloc;
+	*var = vec_size(&ssa->var) - 1;
+	symbol_set_aux(sym, (uint32_t)vec_size(&ssa->var));
+	return ec_noerr;
+}
+
+/* Returns index of the variable for sym if it is not escaped, -1
+   otherwise */
+static int ssa_find_unescaped(Ssa* ssa, Symbol* sym) {
+	int var = ssa_find(ssa, sym);
+	if (var < 0 || vec_at(&ssa->var, var).escaped) return -1;
+	return var;
+}
+
+int ssa_var(Ssa* ssa, Symbol* sym) {
+	ASSERT(ssa != NULL, "Ssa is null");
+	int var = ssa_find(ssa, sym);
+	if (var < 0 || !vec_at(&ssa->var, var).renamed) return -1;
+	return var;
+}
+
+/* Orders definitions by variable, then by block */
+static int ssa_def_cmp(const void* lhs, const void* rhs) {
+	const SsaDef* def1 = lhs;
+	const SsaDef* def2 = rhs;
+	if (def1->var != def2->var) return def1->var < def2->var ? -1 : 1;
+	if (def1->block != def2->block) return def1->block < def2->block ? -1 : 1;
+	return 0;
+}
+
+/* Adds a phi for the variable at index var to the block at index blk */
+static ErrorCode ssa_add_phi(Ssa* ssa, int blk, int var) {
+	SsaBlock* sblk = &vec_at(&ssa->block, blk);
+	SsaPhi phi = {.var = var, .result = NULL, .arg = vec_size(&ssa->phi_arg)};
+	if (!vec_push_back(&sblk->phi, phi)) return ec_badalloc;
+	for (int i = 0; i < vec_size(&sblk->pred); ++i) {
+		if (!vec_push_back(&ssa->phi_arg, NULL)) return ec_badalloc;
+	}
+	return ec_noerr;
+}
+
+/* Finds the variables, then adds phis for the variables read in a
+   block before assigned in it (semi-pruned SSA) at the iterated
+   dominance frontier of the blocks assigning them */
+static ErrorCode ssa_place_phis(Ssa* ssa) {
+	ErrorCode ecode = ec_noerr;
+	int reachable = vec_size(&ssa->rpo);
+
+	for (int i = 0; i < reachable; ++i) {
+		Block* blk = &vec_at(&ssa->cfg->blocks, vec_at(&ssa->rpo, i));
+		for (int j = 0; j < block_ilstat_count(blk); ++j) {
+			IL2Statement* stat = block_ilstat(blk, j);
+			IL2Ins ins = il2stat_ins(stat);
+			int var;
+			if (ins == il2_mad) {
+				if ((ecode = ssa_add_var(ssa, il2stat_arg(stat, 1), &var)) != ec_noerr) return ecode;
+				vec_at(&ssa->var, var).escaped = 1;
+			}
+			if (il2_isdef(ins) && ssa_renamable(il2stat_arg(stat, 0))) {
+				if ((ecode = ssa_add_var(ssa, il2stat_arg(stat, 0), &var)) != ec_noerr) return ecode;
+			}
+		}
+	}
+
+	vec_t(SsaDef) defs;
+	vec_construct(&defs);
+	vec_t(int) work;
+	vec_construct(&work);
+	/* Index of the last variable added to the worklist or given a phi
+	   in each block */
+	vec_t(int) in_work;
+	vec_construct(&in_work);
+	vec_t(int) has_phi;
+	vec_construct(&has_phi);
+
+	for (int i = 0; i < reachable; ++i) {
+		int b = vec_at(&ssa->rpo, i);
+		Block* blk = &vec_at(&ssa->cfg->blocks, b);
+		for (int j = 0; j < block_ilstat_count(blk); ++j) {
+			IL2Statement* stat = block_ilstat(blk, j);
+			for (int k = 0; k < il2stat_argc(stat); ++k) {
+				if (!il2stat_isuse(stat, k)) continue;
+				int var = ssa_find_unescaped(ssa, il2stat_arg(stat, k));
+				if (var >= 0 && vec_at(&ssa->var, var).def_block != b) {
+					vec_at(&ssa->var, var).global = 1;
+				}
+			}
+			if (!il2_isdef(il2stat_ins(stat))) continue;
+
+			int var = ssa_find_unescaped(ssa, il2stat_arg(stat, 0));
+			if (var < 0) continue;
+			++vec_at(&ssa->var, var).defs;
+			if (vec_at(&ssa->var, var).def_block == b) continue;
+			vec_at(&ssa->var, var).def_block = b;
+			if (!vec_push_back(&defs, ((SsaDef){var, b}))) {
+				ecode = ec_badalloc;
+				goto exit;
+			}
+		}
+	}
+	for (int i = 0; i < vec_size(&ssa->var); ++i) {
+		SsaVar* v = &vec_at(&ssa->var, i);
+		v->renamed = !v->escaped && (v->global || v->defs > 1);
+	}
+	if (vec_size(&defs) > 1) {
+		quicksort(vec_data(&defs), (size_t)vec_size(&defs), sizeof(SsaDef), ssa_def_cmp);
+	}
+
+	int count = vec_size(&ssa->block);
+	for (int i = 0; i < count; ++i) {
+		if (!vec_push_back(&in_work, -1) || !vec_push_back(&has_phi, -1)) {
+			ecode = ec_badalloc;
+			goto exit;
+		}
+	}
+
+	for (int i = 0; i < vec_size(&defs);) {
+		int var = vec_at(&defs, i).var;
+		int end = i;
+		while (end < vec_size(&defs) && vec_at(&defs, end).var == var) ++end;
+
+		/* Only read in the blocks assigning it, versions never merge */
+		if (!vec_at(&ssa->var, var).global) {
+			i = end;
+			continue;
+		}
+
+		vec_clear(&work);
+		for (; i < end; ++i) {
+			int b = vec_at(&defs, i).block;
+			vec_at(&in_work, b) = var;
+			if (!vec_push_back(&work, b)) {
+				ecode = ec_badalloc;
+				goto exit;
+			}
+		}
+		while (!vec_empty(&work)) {
+			SsaBlock* sblk = &vec_at(&ssa->block, vec_pop_back(&work));
+			for (int j = 0; j < vec_size(&sblk->frontier); ++j) {
+				int b = vec_at(&sblk->frontier, j);
+				if (vec_at(&has_phi, b) == var) continue;
+				vec_at(&has_phi, b) = var;
+				if ((ecode = ssa_add_phi(ssa, b, var)) != ec_noerr) goto exit;
+
+				/* The phi assigns the variable in b */
+				if (vec_at(&in_work, b) != var) {
+					vec_at(&in_work, b) = var;
+					if (!vec_push_back(&work, b)) {
+						ecode = ec_badalloc;
+						goto exit;
+					}
+				}
+			}
+		}
+	}
+
+exit:
+	vec_destruct(&has_phi);
+	vec_destruct(&in_work);
+	vec_destruct(&work);
+	vec_destruct(&defs);
+	return ecode;
+}
+
+/* Creates a new version of the variable at index var, which reaches the
+   statements after it until undone
+   Version saved to provided pointer */
+static ErrorCode ssa_new_version(Ssa* ssa, int var, SsaUndoLog* undo, Symbol** version) {
+	ErrorCode ecode;
+	SsaVar* v = &vec_at(&ssa->var, var);
+
+	if (!svec_push_backu(&ssa->version)) return ec_badalloc;
+	SsaVersion* ver = &svec_back(&ssa->version);
+	if ((ecode = symbol_construct(&ver->sym, symbol_token(v->sym), symbol_type(v->sym))) != ec_noerr) {
+		svec_splice(&ssa->version, svec_size(&ssa->version) - 1, 1);
+		return ecode;
+	}
+	symbol_set_valcat(&ver->sym, symbol_valcat(v->sym));
+	ver->var = var;
+	ver->num = ++v->versions;
+	symbol_set_aux(&ver->sym, (uint32_t)(vec_size(&ssa->var) + svec_size(&ssa->version)));
+
+	if (!vec_push_back(undo, ((SsaUndo){var, v->top}))) return ec_badalloc;
+	v->top = &ver->sym;
+	*version = &ver->sym;
+	return ec_noerr;
+}
+
+/* Sets the arguments of the phis in block at index blk for the edge from
+   block at index pred to the versions reaching the end of pred */
+static void ssa_fill_phis(Ssa* ssa, int blk, int pred) {
+	SsaBlock* sblk = &vec_at(&ssa->block, blk);
+	int i_pred = 0;
+	while (vec_at(&sblk->pred, i_pred) != pred) ++i_pred;
+
+	for (int i = 0; i < vec_size(&sblk->phi); ++i) {
+		SsaPhi* phi = &vec_at(&sblk->phi, i);
+		vec_at(&ssa->phi_arg, phi->arg + i_pred) = vec_at(&ssa->var, phi->var).top;
+	}
+}
+
+/* Renames the variables in the block at index blk to their versions */
+static ErrorCode ssa_rename_block(Ssa* ssa, int blk, SsaUndoLog* undo) {
+	ErrorCode ecode;
+	SsaBlock* sblk = &vec_at(&ssa->block, blk);
+	for (int i = 0; i < vec_size(&sblk->phi); ++i) {
+		SsaPhi* phi = &vec_at(&sblk->phi, i);
+		if ((ecode = ssa_new_version(ssa, phi->var, undo, &phi->result)) != ec_noerr) return ecode;
+	}
+
+	Block* block = &vec_at(&ssa->cfg->blocks, blk);
+	for (int i = 0; i < block_ilstat_count(block); ++i) {
+		IL2Statement* stat = block_ilstat(block, i);
+		for (int j = 0; j < il2stat_argc(stat); ++j) {
+			if (!il2stat_isuse(stat, j)) continue;
+			int var = ssa_var(ssa, stat->arg[j]);
+			if (var >= 0) stat->arg[j] = vec_at(&ssa->var, var).top;
+		}
+		if (!il2_isdef(il2stat_ins(stat))) continue;
+
+		int var = ssa_var(ssa, stat->arg[0]);
+		if (var < 0) continue;
+		if ((ecode = ssa_new_version(ssa, var, undo, &stat->arg[0])) != ec_noerr) return ecode;
+	}
+
+	for (int i = 0; i < block_next_count(block); ++i) {
+		ssa_fill_phis(ssa, ssa_succ(ssa, blk, i), blk);
+	}
+	return ec_noerr;
+}
+
+/* Renames the variables in a preorder walk of the dominator tree, the
+   version of a variable reaching a block is the last one defined in its
+   dominators */
+static ErrorCode ssa_rename(Ssa* ssa) {
+	ErrorCode ecode = ec_noerr;
+	if (vec_empty(&ssa->rpo)) return ec_noerr;
+
+	SsaUndoLog undo;
+	vec_construct(&undo);
+	vec_t(SsaRename) stack;
+	vec_construct(&stack);
+
+	/* Versions on entering the function */
+	ssa_fill_phis(ssa, 0, -1);
+
+	if ((ecode = ssa_rename_block(ssa, 0, &undo)) != ec_noerr) goto exit;
+	if (!vec_push_back(&stack, ((SsaRename){0, 0, 0}))) {
+		ecode = ec_badalloc;
+		goto exit;
+	}
+	while (!vec_empty(&stack)) {
+		SsaRename* frame = &vec_back(&stack);
+		SsaBlock* sblk = &vec_at(&ssa->block, frame->block);
+		if (frame->child < vec_size(&sblk->child)) {
+			int child = vec_at(&sblk->child, frame->child);
+			++frame->child;
+
+			int undo_size = vec_size(&undo);
+			if ((ecode = ssa_rename_block(ssa, child, &undo)) != ec_noerr) goto exit;
+			if (!vec_push_back(&stack, ((SsaRename){child, 0, undo_size}))) {
+				ecode = ec_badalloc;
+				goto exit;
+			}
+		}
+		else {
+			/* Versions of the block no longer reach */
+			while (vec_size(&undo) > frame->undo) {
+				SsaUndo entry = vec_pop_back(&undo);
+				vec_at(&ssa->var, entry.var).top = entry.top;
+			}
+			(void)vec_pop_back(&stack);
+		}
+	}
+
+exit:
+	vec_destruct(&stack);
+	vec_destruct(&undo);
+	return ecode;
+}
+
+ErrorCode ssa_convert(Ssa* ssa, Cfg* cfg) {
+	ASSERT(ssa != NULL, "Ssa is null");
+	ASSERT(cfg != NULL, "Cfg is null");
+	ASSERT(ssa->cfg == NULL, "Ssa already holds a cfg");
+	ErrorCode ecode;
+
+	ssa->cfg = cfg;
+	if ((ecode = ssa_order(ssa)) != ec_noerr) return ecode;
+	if ((ecode = ssa_dominators(ssa)) != ec_noerr) return ecode;
+	if ((ecode = ssa_place_phis(ssa)) != ec_noerr) return ecode;
+	return ssa_rename(ssa);
+}
+
+void ssa_revert(Ssa* ssa) {
+	ASSERT(ssa != NULL, "Ssa is null");
+	if (ssa->cfg == NULL) return;
+
+	for (int i = 0; i < vec_size(&ssa->rpo); ++i) {
+		int b = vec_at(&ssa->rpo, i);
+		SsaBlock* sblk = &vec_at(&ssa->block, b);
+		for (int j = 0; j < vec_size(&sblk->phi); ++j) {
+			SsaPhi* phi = &vec_at(&sblk->phi, j);
+			for (int k = 0; k < vec_size(&sblk->pred); ++k) {
+				Symbol* arg = vec_at(&ssa->phi_arg, phi->arg + k);
+				ASSERT(ssa_find(ssa, arg) == phi->var, "Phi argument is not a version of the phi's variable");
+			}
+		}
+
+		Block* blk = &vec_at(&ssa->cfg->blocks, b);
+		for (int j = 0; j < block_ilstat_count(blk); ++j) {
+			IL2Statement* stat = block_ilstat(blk, j);
+			for (int k = 0; k < il2stat_argc(stat); ++k) {
+				int var = ssa_find(ssa, stat->arg[k]);
+				if (var >= 0) stat->arg[k] = vec_at(&ssa->var, var).sym;
+			}
+		}
+	}
+	ssa_clear(ssa);
+}
+
+SsaBlock* ssa_block(Ssa* ssa, int i) {
+	ASSERT(ssa != NULL, "Ssa is null");
+	ASSERT(i >= 0, "Index out of range");
+	ASSERT(i < vec_size(&ssa->block), "Index out of range");
+	return &vec_at(&ssa->block, i);
+}
+
+int ssa_dominates(Ssa* ssa, int a, int b) {
+	ASSERT(ssa != NULL, "Ssa is null");
+	if (ssa_block(ssa, a)->idom < 0 || ssa_block(ssa, b)->idom < 0) return 0;
+	while (b != a) {
+		if (b == 0) return 0;
+		b = ssa_block(ssa, b)->idom;
+	}
+	return 1;
+}
+
+/* Prints list of block indices */
+static void debug_print_blocks(const char* title, int* blocks, int count) {
+	LOGF("    %s:", title);
+	for (int i = 0; i < count; ++i) {
+		LOGF(" %d", blocks[i]);
+	}
+	LOG("\n");
+}
+
+void debug_print_dom(Ssa* ssa) {
+	LOGF("Dominator tree [%d]\n", vec_size(&ssa->block));
+	for (int i = 0; i < vec_size(&ssa->block); ++i) {
+		SsaBlock* sblk = &vec_at(&ssa->block, i);
+		LOGF("  Block %d\n", i);
+		if (sblk->idom < 0) {
+			LOG("    Unreachable\n");
+			continue;
+		}
+		if (i != 0) {
+			LOGF("    Idom: %d\n", sblk->idom);
+		}
+		debug_print_blocks("Children", vec_data(&sblk->child), vec_size(&sblk->child));
+		debug_print_blocks("Frontier", vec_data(&sblk->frontier), vec_size(&sblk->frontier));
+	}
+}
+
+/* Prints symbol, versions are suffixed with their number */
+static void debug_print_version(Ssa* ssa, Symbol* sym) {
+	int var = ssa_find(ssa, sym);
+	if (var >= 0 && sym != vec_at(&ssa->var, var).sym) {
+		LOGF("%s.%d", symbol_token(sym), ((SsaVersion*)sym)->num);
+	}
+	else {
+		LOGF("%s", symbol_token(sym));
+	}
+}
+
+void debug_print_ssa(Ssa* ssa) {
+	LOGF("SSA [%d]\n", vec_size(&ssa->block));
+	for (int i = 0; i < vec_size(&ssa->block); ++i) {
+		SsaBlock* sblk = &vec_at(&ssa->block, i);
+		Block* blk = &vec_at(&ssa->cfg->blocks, i);
+		LOGF("  Block %d\n", i);
+		if (sblk->idom < 0) {
+			LOG("    Unreachable\n");
+		}
+		else {
+			debug_print_blocks("Pred", vec_data(&sblk->pred), vec_size(&sblk->pred));
+		}
+
+		/* Labels associated with block */
+		if (block_lab_count(blk) > 0) {
+			LOG("    Labels:");
+			for (int j = 0; j < block_lab_count(blk); ++j) {
+				LOGF(" %s", symbol_token(block_lab(blk, j)));
+			}
+			LOG("\n");
+		}
+
+		/* Phis, with one argument per predecessor */
+		LOG("    IL:\n");
+		for (int j = 0; j < vec_size(&sblk->phi); ++j) {
+			SsaPhi* phi = &vec_at(&sblk->phi, j);
+			LOGF("        %8s ", "phi");
+			debug_print_version(ssa, phi->result);
+			for (int k = 0; k < vec_size(&sblk->pred); ++k) {
+				LOG(", ");
+				debug_print_version(ssa, vec_at(&ssa->phi_arg, phi->arg + k));
+			}
+			LOG("\n");
+		}
+
+		for (int j = 0; j < block_ilstat_count(blk); ++j) {
+			IL2Statement* stat = block_ilstat(blk, j);
+			LOGF("    %3d %8s", j, il2_str(il2stat_ins(stat)));
+			for (int k = 0; k < il2stat_argc(stat); ++k) {
+				LOG(k == 0 ? " " : ", ");
+				debug_print_version(ssa, il2stat_arg(stat, k));
+			}
+			LOG("\n");
+		}
+
+		LOG("    ->");
+		for (int j = 0; j < block_next_count(blk); ++j) {
+			LOGF(" %d", ssa_succ(ssa, i, j));
+		}
+		LOG("\n");
+	}
+}
@@ -0,0 +1,124 @@
+/* Static single assignment (SSA) form of the IL2 in a Cfg */
+#ifndef SSA_H
+#define SSA_H
+
+#include "cfg.h"
+#include "errorcode.h"
+#include "symbol.h"
+#include "vec.h"
+
+/* Merges the versions of a variable reaching a block from its
+   predecessors into a new version */
+typedef struct
+{
+	int var;        /* Index of the variable in Ssa */
+	Symbol* result; /* Version defined by the phi */
+	/* Index of the first argument in Ssa.phi_arg, there is one argument
+	   per predecessor of the block, in the order of SsaBlock.pred */
+	int arg;
+} SsaPhi;
+
+typedef struct
+{
+	/* Reachable blocks which link to this block */
+	vec_t(int) pred;
+	/* Blocks immediately dominated by this block */
+	vec_t(int) child;
+	/* Dominance frontier, blocks where the dominance of this block
+	   ends */
+	vec_t(int) frontier;
+	vec_t(SsaPhi) phi;
+
+	/* Immediate dominator, the entry block is its own, -1 if the block
+	   is unreachable */
+	int idom;
+	/* Index of block in reverse postorder, -1 if unreachable */
+	int rpo;
+} SsaBlock;
+
+/* Symbol assigned to once, in place of a variable */
+typedef struct
+{
+	Symbol sym;
+	int var; /* Index of the variable in Ssa */
+	int num; /* Versions of a variable are numbered from 1 */
+} SsaVersion;
+
+/* Symbol assigned to by the IL2 */
+typedef struct
+{
+	/* The variable's symbol is also its version on entry, e.g., a
+	   parameter or a variable read before it is assigned */
+	Symbol* sym;
+	Symbol* top; /* Version reaching the statement being renamed */
+	int versions;
+	int defs;      /* Number of assignments */
+	int def_block; /* Last block found assigning to the variable */
+
+	/* Address taken by mad, or declared at file scope, can be assigned
+	   through a pointer or by a call so it is not renamed */
+	uint8_t escaped;
+	/* Read in a block before it is assigned in the block */
+	uint8_t global;
+	/* Renamed into versions, a variable assigned once and only read
+	   after the assignment in the same block is already in SSA form and
+	   keeps its symbol, as are most temporaries */
+	uint8_t renamed;
+} SsaVar;
+
+/* Converting a cfg into SSA form renames the IL2 statements of the cfg
+   in place, each assignment to a variable defines a new version of the
+   variable, and phis are added where versions merge. Reverting the cfg
+   renames the versions back to their variables, the cfg can then be
+   written out
+
+   Passes on the SSA form must keep it conventional: the versions of one
+   variable are never live at the same time, and the arguments of a phi
+   are versions of the phi's variable. Reverting then only has to drop
+   the phis */
+typedef struct
+{
+	Cfg* cfg;
+
+	/* One per block of the cfg */
+	vec_t(SsaBlock) block;
+	/* Reachable blocks in reverse postorder */
+	vec_t(int) rpo;
+
+	vec_t(Symbol*) phi_arg;
+
+	/* The aux of the symbol of a variable is 1 + its index, the aux of a
+	   version is 1 + the number of variables + the version's index */
+	vec_t(SsaVar) var;
+	/* Versions never move as statements point to them */
+	svec_t(SsaVersion) version;
+} Ssa;
+
+ErrorCode ssa_construct(Ssa* ssa);
+
+void ssa_destruct(Ssa* ssa);
+
+/* Computes the dominator tree of the cfg and converts its IL2 into SSA
+   form, cfg must be partitioned into blocks and remain alive until
+   ssa_revert */
+ErrorCode ssa_convert(Ssa* ssa, Cfg* cfg);
+
+/* Renames the versions in the IL2 of the cfg back to their variables
+   and clears the SSA form, ssa can convert another cfg afterwards */
+void ssa_revert(Ssa* ssa);
+
+/* Returns the index of the variable which symbol is the variable or a
+   version of, -1 if symbol is not renamed */
+int ssa_var(Ssa* ssa, Symbol* sym);
+
+/* Returns the SsaBlock for the block at index i of the cfg */
+SsaBlock* ssa_block(Ssa* ssa, int i);
+
+/* Returns 1 if block a dominates block b, 0 otherwise */
+int ssa_dominates(Ssa* ssa, int a, int b);
+
+void debug_print_dom(Ssa* ssa);
+
+void debug_print_ssa(Ssa* ssa);
+
+#endif
@@ -0,0 +1,164 @@
+#include "strpool.h"
+
+#include "common.h"
+
+/* Initial number of slots in hash table, must be power of 2 */
+#define STRPOOL_INITIAL_SLOTS 256
+
+/* FNV-1a */
+static uint32_t strpool_hash(const char* str, int len) {
+	uint32_t hash = 2166136261u;
+	for (int i = 0; i < len; ++i) {
+		hash ^= (uint8_t)str[i];
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/* Allocates a new hash table with given capacity and inserts the existing
+   strings into it */
+static ErrorCode strpool_rehash(StrPool* pool, int capacity) {
+	StrPoolSlot* slots = cmalloc((size_t)capacity * sizeof(StrPoolSlot));
+	if (slots == NULL) return ec_badalloc;
+	for (int i = 0; i < capacity; ++i) {
+		slots[i].id = -1;
+	}
+
+	uint32_t mask = (uint32_t)capacity - 1;
+	for (int i = 0; i < pool->slot_capacity; ++i) {
+		StrPoolSlot slot = pool->slots[i];
+		if (slot.id < 0) continue;
+
+		uint32_t j = slot.hash & mask;
+		while (slots[j].id >= 0) {
+			j = (j + 1) & mask;
+		}
+		slots[j] = slot;
+	}
+
+	if (pool->slots != NULL) cfree(pool->slots);
+	pool->slots = slots;
+	pool->slot_capacity = capacity;
+	return ec_noerr;
+}
+
+/* Copies len characters at str into the chunks, null terminated
+   Pointer to copy stored at the provided pointer */
+static ErrorCode strpool_store(StrPool* pool, const char* str, int len, const char** stored) {
+	int bytes = len + 1;
+	if (pool->chunk_used + bytes > pool->chunk_size) {
+		int size = bytes > STRPOOL_CHUNK_SIZE ? bytes : STRPOOL_CHUNK_SIZE;
+		char* chunk = cmalloc((size_t)size);
+		if (chunk == NULL) return ec_badalloc;
+		if (!vec_push_back(&pool->chunks, chunk)) {
+			cfree(chunk);
+			return ec_badalloc;
+		}
+		pool->chunk_used = 0;
+		pool->chunk_size = size;
+	}
+
+	char* dest = vec_back(&pool->chunks) + pool->chunk_used;
+	memcpy(dest, str, (size_t)len);
+	dest[len] = '\0';
+	pool->chunk_used += bytes;
+
+	*stored = dest;
+	return ec_noerr;
+}
+
+ErrorCode strpool_construct(StrPool* pool) {
+	ASSERT(pool != NULL, "StrPool is null");
+	vec_construct(&pool->chunks);
+	pool->chunk_used = 0;
+	pool->chunk_size = 0;
+	vec_construct(&pool->strs);
+	vec_construct(&pool->lens);
+
+	pool->slots = NULL;
+	pool->slot_capacity = 0;
+	return strpool_rehash(pool, STRPOOL_INITIAL_SLOTS);
+}
+
+void strpool_destruct(StrPool* pool) {
+	ASSERT(pool != NULL, "StrPool is null");
+	for (int i = 0; i < vec_size(&pool->chunks); ++i) {
+		cfree(vec_at(&pool->chunks, i));
+	}
+	vec_destruct(&pool->chunks);
+	vec_destruct(&pool->strs);
+	vec_destruct(&pool->lens);
+	if (pool->slots != NULL) cfree(pool->slots);
+}
+
+/* Returns the index of the slot holding len characters at str with hash,
+   or the empty slot where it would be inserted */
+static uint32_t strpool_probe(const StrPool* pool, const char* str, int len, uint32_t hash) {
+	uint32_t mask = (uint32_t)pool->slot_capacity - 1;
+	uint32_t i = hash & mask;
+	while (pool->slots[i].id >= 0) {
+		StrPoolSlot slot = pool->slots[i];
+		if (slot.hash == hash && vec_at(&pool->lens, slot.id) == len &&
+			memcmp(vec_at(&pool->strs, slot.id), str, (size_t)len) == 0) {
+			break;
+		}
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+ErrorCode strpool_intern(StrPool* pool, const char* str, int len, StrId* id) {
+	ASSERT(pool != NULL, "StrPool is null");
+	ErrorCode ecode;
+
+	uint32_t hash = strpool_hash(str, len);
+	uint32_t i = strpool_probe(pool, str, len, hash);
+	if (pool->slots[i].id >= 0) {
+		*id = pool->slots[i].id;
+		return ec_noerr;
+	}
+
+	/* Not found, add new string */
+	const char* stored;
+	if ((ecode = strpool_store(pool, str, len, &stored)) != ec_noerr) return ecode;
+	if (!vec_push_back(&pool->strs, stored)) return ec_badalloc;
+	if (!vec_push_back(&pool->lens, len)) {
+		(void)vec_pop_back(&pool->strs);
+		return ec_badalloc;
+	}
+
+	StrId new_id = vec_size(&pool->strs) - 1;
+	pool->slots[i].hash = hash;
+	pool->slots[i].id = new_id;
+
+	/* Keep load factor at most 1/2 */
+	if (vec_size(&pool->strs) * 2 > pool->slot_capacity) {
+		if ((ecode = strpool_rehash(pool, pool->slot_capacity * 2)) != ec_noerr) return ecode;
+	}
+
+	*id = new_id;
+	return ec_noerr;
+}
+
+void strpool_find(const StrPool* pool, const char* str, int len, StrId* id) {
+	ASSERT(pool != NULL, "StrPool is null");
+	uint32_t i = strpool_probe(pool, str, len, strpool_hash(str, len));
+	*id = pool->slots[i].id;
+}
+
+const char* strpool_str(const StrPool* pool, StrId id) {
+	ASSERT(pool != NULL, "StrPool is null");
+	ASSERT(id >= 0 && id < vec_size(&pool->strs), "Invalid string id");
+	return vec_at(&pool->strs, id);
+}
+
+int strpool_len(const StrPool* pool, StrId id) {
+	ASSERT(pool != NULL, "StrPool is null");
+	ASSERT(id >= 0 && id < vec_size(&pool->lens), "Invalid string id");
+	return vec_at(&pool->lens, id);
+}
+
+int strpool_size(const StrPool* pool) {
+	ASSERT(pool != NULL, "StrPool is null");
+	return vec_size(&pool->strs);
+}
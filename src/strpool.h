@@ -0,0 +1,65 @@
+/* Pool of interned strings
+   Each distinct string is stored once and identified by an integer id */
+#ifndef STRPOOL_H
+#define STRPOOL_H
+
+#include <stdint.h>
+
+#include "errorcode.h"
+#include "vec.h"
+
+typedef int StrId;
+
+/* Size of chunk used to store the strings, strings larger than this
+   are given their own chunk */
+#define STRPOOL_CHUNK_SIZE 4096
+
+typedef struct
+{
+	uint32_t hash;
+	StrId id; /* -1 if slot is empty */
+} StrPoolSlot;
+
+typedef struct
+{
+	/* Characters of the strings are stored in chunks, the chunks are
+	   never reallocated so pointers to strings remain valid until the
+	   pool is destructed */
+	vec_t(char*) chunks;
+	int chunk_used; /* Bytes used in last chunk */
+	int chunk_size; /* Bytes in last chunk */
+
+	/* Indexed by StrId */
+	vec_t(const char*) strs;
+	vec_t(int) lens;
+
+	/* Open addressing hash table, capacity is a power of 2 */
+	StrPoolSlot* slots;
+	int slot_capacity;
+} StrPool;
+
+ErrorCode strpool_construct(StrPool* pool);
+
+void strpool_destruct(StrPool* pool);
+
+/* Interns len characters at str, str does not need to be null terminated
+   The id of the interned string is stored at the provided pointer,
+   interning the same characters again gives the same id */
+ErrorCode strpool_intern(StrPool* pool, const char* str, int len, StrId* id);
+
+/* Finds len characters at str in the pool, str does not need to be null
+   terminated
+   The id of the string is stored at the provided pointer, -1 if the
+   characters were never interned */
+void strpool_find(const StrPool* pool, const char* str, int len, StrId* id);
+
+/* Returns the null terminated string for id */
+const char* strpool_str(const StrPool* pool, StrId id);
+
+/* Returns length of string for id */
+int strpool_len(const StrPool* pool, StrId id);
+
+/* Returns number of strings in pool */
+int strpool_size(const StrPool* pool);
+
+#endif
@@ -3,67 +3,109 @@
 #include "common.h"
 
 ErrorCode symbol_construct(Symbol* sym, const char* token, Type* type) {
-	ErrorCode ecode;
 	sym->class = sl_normal;
+	sym->valcat = vc_none;
+	sym->constant = 0;
+	sym->file_scope = 0;
+	sym->aux = 0;
+	sym->data.value = 0;
+	sym->type = type;
 
-	// Copy token into symbol
-	int i = 0;
-	while (token[i] != '\0') {
-		if (i >= MAX_SYMBOL_LEN) {
-			sym->token[0] = '\0';
-			return ec_symbol_nametoolong;
-		}
-		sym->token[i] = token[i];
-		++i;
+	if (strlength(token) > MAX_SYMBOL_LEN) {
+		sym->token = "";
+		return ec_symbol_nametoolong;
 	}
-	sym->token[i] = '\0';
-
-	if ((ecode = type_copy(type, &sym->type)) != ec_noerr) return ecode;
-	sym->valcat = vc_none;
+	sym->token = token;
 	return ec_noerr;
 }
 
 void symbol_destruct(Symbol* sym) {
-	type_destruct(&sym->type);
+	if (sym->class == sl_access) cfree(sym->data.access);
 }
 
-void symbol_sl_access(Symbol* sym, Symbol* ptr, Symbol* idx) {
+void symbol_set_constant(Symbol* sym, uint64_t value) {
 	ASSERT(sym != NULL, "Symbol is null");
+	ASSERT(sym->class == sl_normal, "Constant symbol cannot be accessed memory");
+	sym->constant = 1;
+	sym->data.value = value;
+}
+
+ErrorCode symbol_sl_access(Symbol* sym, Symbol* ptr, Symbol* idx) {
+	ASSERT(sym != NULL, "Symbol is null");
+	ASSERT(!sym->constant, "Accessed memory cannot be constant symbol");
+	if (sym->class != sl_access) {
+		sym->data.access = cmalloc(sizeof(SymbolAccess));
+		if (sym->data.access == NULL) return ec_badalloc;
+	}
 	sym->class = sl_access;
-	sym->ptr = ptr;
-	sym->ptr_idx = idx;
+	sym->data.access->ptr = ptr;
+	sym->data.access->ptr_idx = idx;
+	return ec_noerr;
 }
 
 SymbolClass symbol_class(Symbol* sym) {
-	return sym->class;
+	return (SymbolClass)sym->class;
 }
 
-char* symbol_token(Symbol* sym) {
+const char* symbol_token(Symbol* sym) {
 	ASSERT(sym != NULL, "Symbol is null");
 	return sym->token;
 }
 
 Type* symbol_type(Symbol* sym) {
 	ASSERT(sym != NULL, "Symbol is null");
-	return &sym->type;
+	return sym->type;
+}
+
+int symbol_is_constant(Symbol* sym) {
+	ASSERT(sym != NULL, "Symbol is null");
+	return sym->constant;
+}
+
+uint64_t symbol_constant_value(Symbol* sym) {
+	ASSERT(sym != NULL, "Symbol is null");
+	ASSERT(sym->constant, "Symbol is not a constant");
+	return sym->data.value;
+}
+
+int symbol_file_scope(Symbol* sym) {
+	ASSERT(sym != NULL, "Symbol is null");
+	return sym->file_scope;
+}
+
+void symbol_set_file_scope(Symbol* sym) {
+	ASSERT(sym != NULL, "Symbol is null");
+	sym->file_scope = 1;
+}
+
+uint32_t symbol_aux(Symbol* sym) {
+	ASSERT(sym != NULL, "Symbol is null");
+	return sym->aux;
+}
+
+void symbol_set_aux(Symbol* sym, uint32_t aux) {
+	ASSERT(sym != NULL, "Symbol is null");
+	sym->aux = aux;
 }
 
 ValueCategory symbol_valcat(Symbol* sym) {
 	ASSERT(sym != NULL, "Symbol is null");
-	return sym->valcat;
+	return (ValueCategory)sym->valcat;
 }
 
 void symbol_set_valcat(Symbol* sym, ValueCategory valcat) {
 	ASSERT(sym != NULL, "Symbol is null");
-	sym->valcat = valcat;
+	sym->valcat = (uint8_t)valcat;
 }
 
 Symbol* symbol_ptr_sym(Symbol* sym) {
 	ASSERT(sym != NULL, "Symbol is null");
-	return sym->ptr;
+	ASSERT(sym->class == sl_access, "Symbol does not access memory");
+	return sym->data.access->ptr;
 }
 
 Symbol* symbol_ptr_index(Symbol* sym) {
 	ASSERT(sym != NULL, "Symbol is null");
-	return sym->ptr_idx;
+	ASSERT(sym->class == sl_access, "Symbol does not access memory");
+	return sym->data.access->ptr_idx;
 }
@@ -2,6 +2,8 @@
 #ifndef SYMBOL_H
 #define SYMBOL_H
 
+#include <stdint.h>
+
 #include "errorcode.h"
 #include "type.h"
 
@@ -21,40 +23,85 @@ typedef enum
 } ValueCategory;
 
 typedef struct Symbol Symbol;
-struct Symbol
-{
-	SymbolClass class;
-	char token[MAX_SYMBOL_LEN + 1];
-	Type type;
-	ValueCategory valcat;
 
-	/* Only for class sl_access */
+/* Only for class sl_access, allocated separately as it is rare */
+typedef struct
+{
 	Symbol* ptr;
 	Symbol* ptr_idx;
+} SymbolAccess;
+
+/* Kept small as there are many symbols, mostly temporaries and labels
+   The token and type are not copied, they must remain valid for the
+   lifetime of the symbol, the symbol table owns them for its symbols */
+struct Symbol
+{
+	const char* token;
+	Type* type;
+	union
+	{
+		/* Constant value as the bits of its type, e.g., an unsigned int
+		   constant has the upper 32 bits cleared */
+		uint64_t value;
+		SymbolAccess* access;
+	} data;
+
+	uint8_t class;  /* SymbolClass */
+	uint8_t valcat; /* ValueCategory */
+	/* 1 if symbol is a constant, its value is held in data.value */
+	uint8_t constant;
+	/* 1 if symbol is declared at file scope */
+	uint8_t file_scope;
+	/* Free for a pass over the IL2 to associate the symbol with its own
+	   data, 0 when no pass is running. Fits in the padding */
+	uint32_t aux;
 };
 
-/* Creates symbol at given memory location */
+/* Creates symbol at given memory location
+   token and type must remain valid for the lifetime of the symbol */
 ErrorCode symbol_construct(Symbol* sym, const char* token, Type* type);
 
 void symbol_destruct(Symbol* sym);
 
+/* Makes symbol a constant of the given value */
+void symbol_set_constant(Symbol* sym, uint64_t value);
+
 /* Converts symbol to class representing access to memory location
    ptr: Is a symbol which when indexed yields this symbol
    idx: Is a symbol which indexes into ptr to yield this
 		symbol, leave as symid_invalid to default to 0
    e.g., int* p; int a = p[2];
    If this symbol is a, ptr is p, idx is 2 */
-void symbol_sl_access(Symbol* sym, Symbol* ptr, Symbol* idx);
+ErrorCode symbol_sl_access(Symbol* sym, Symbol* ptr, Symbol* idx);
 
 /* Returns SymbolClass for symbol */
 SymbolClass symbol_class(Symbol* sym);
 
 /* Returns token for symbol */
-char* symbol_token(Symbol* sym);
+const char* symbol_token(Symbol* sym);
 
 /* Returns type for symbol */
 Type* symbol_type(Symbol* sym);
 
+/* Returns 1 if symbol is a constant, 0 otherwise */
+int symbol_is_constant(Symbol* sym);
+
+/* Returns value of constant symbol */
+uint64_t symbol_constant_value(Symbol* sym);
+
+/* Returns 1 if symbol is declared at file scope, 0 otherwise */
+int symbol_file_scope(Symbol* sym);
+
+/* Marks symbol as declared at file scope */
+void symbol_set_file_scope(Symbol* sym);
+
+/* Returns the value associated with symbol by the pass running */
+uint32_t symbol_aux(Symbol* sym);
+
+/* Associates value with symbol for the pass running, the pass sets it
+   back to 0 when done */
+void symbol_set_aux(Symbol* sym, uint32_t aux);
+
 /* Returns ValueCategory for symbol */
 ValueCategory symbol_valcat(Symbol* sym);
 
@@ -3,29 +3,47 @@
 #include "common.h"
 #include "globals.h"
 
+/* Initial number of slots in constant hash table, must be power of 2 */
+#define SYMTAB_CONSTANT_INITIAL_SLOTS 64
+
+static ErrorCode symtab_constant_rehash(Symtab* stab, int capacity);
+static ErrorCode symtab_constant_insert(Symtab* stab, Symbol* sym);
+static ErrorCode symtab_intern_token(Symtab* stab, const char* token, StrId* name);
+
 ErrorCode symtab_construct(Symtab* stab) {
 	ASSERT(stab != NULL, "Symtab is null");
 	ErrorCode ecode;
 
-	hvec_construct(&stab->symbol);
-	hvec_construct(&stab->constant);
-
-	if ((ecode = type_construct(&stab->type_int, ts_int, 0)) != ec_noerr) return ecode;
-	if ((ecode = type_construct(&stab->type_label, ts_void, 0)) != ec_noerr) return ecode;
-
-	/* Create special constants */
-	Symbol sym_0;
-	symbol_construct(&sym_0, "0", &stab->type_int); /* Index 0 */
-	if (!hvec_push_back(&stab->constant, sym_0)) return ec_badalloc;
-
-	Symbol sym_1;
-	symbol_construct(&sym_1, "1", &stab->type_int); /* Index 0 */
-	if (!hvec_push_back(&stab->constant, sym_1)) return ec_badalloc;
+	svec_construct(&stab->symbol);
+	svec_construct(&stab->constant);
+	stab->constant_slots = NULL;
+	stab->constant_slot_capacity = 0;
+	if ((ecode = symtab_constant_rehash(stab, SYMTAB_CONSTANT_INITIAL_SLOTS)) != ec_noerr) return ecode;
+
+	if ((ecode = typetable_construct(&stab->types)) != ec_noerr) return ecode;
+	Type type;
+	if ((ecode = type_construct(&type, ts_int, 0)) != ec_noerr) return ecode;
+	ecode = typetable_intern(&stab->types, &type, &stab->type_int);
+	type_destruct(&type);
+	if (ecode != ec_noerr) return ecode;
+	if ((ecode = type_construct(&type, ts_void, 0)) != ec_noerr) return ecode;
+	ecode = typetable_intern(&stab->types, &type, &stab->type_label);
+	type_destruct(&type);
+	if (ecode != ec_noerr) return ecode;
 
 	stab->scopes = NULL;
 	stab->scopes_size = 0;
 	stab->scopes_capacity = 0;
 
+	if ((ecode = strpool_construct(&stab->names)) != ec_noerr) return ecode;
+	vec_construct(&stab->name_binding);
+	vec_construct(&stab->binding);
+
+	/* Create special constants, index 0 and 1 */
+	Symbol* sym;
+	if ((ecode = symtab_add_constant(stab, &sym, "0", 0, stab->type_int)) != ec_noerr) return ecode;
+	if ((ecode = symtab_add_constant(stab, &sym, "1", 1, stab->type_int)) != ec_noerr) return ecode;
+
 	for (int i = 0; i < sc_count; ++i) {
 		vec_construct(&stab->cat[i]);
 	}
@@ -47,20 +65,32 @@ void symtab_destruct(Symtab* stab) {
 	}
 	cfree(stab->scopes);
 
-	type_destruct(&stab->type_label);
-	type_destruct(&stab->type_int);
-
-	for (int i = 0; i < hvec_size(&stab->constant); ++i) {
-		Symbol* sym = &hvec_at(&stab->constant, i);
+	for (int i = 0; i < svec_size(&stab->constant); ++i) {
+		Symbol* sym = &svec_at(&stab->constant, i);
 		symbol_destruct(sym);
 	}
-	hvec_destruct(&stab->constant);
+	svec_destruct(&stab->constant);
+	if (stab->constant_slots != NULL) cfree(stab->constant_slots);
 
-	for (int i = 0; i < hvec_size(&stab->symbol); ++i) {
-		Symbol* sym = &hvec_at(&stab->symbol, i);
+	for (int i = 0; i < svec_size(&stab->symbol); ++i) {
+		Symbol* sym = &svec_at(&stab->symbol, i);
 		symbol_destruct(sym);
 	}
-	hvec_destruct(&stab->symbol);
+	svec_destruct(&stab->symbol);
+
+	/* Symbols point to the types and names, destruct after symbols */
+	typetable_destruct(&stab->types);
+
+	vec_destruct(&stab->binding);
+	vec_destruct(&stab->name_binding);
+	strpool_destruct(&stab->names);
+}
+
+/* Interns token in the names of the symbol table, StrId stored at pointer */
+static ErrorCode symtab_intern_token(Symtab* stab, const char* token, StrId* name) {
+	int len = strlength(token);
+	if (len > MAX_SYMBOL_LEN) return ec_symbol_nametoolong;
+	return strpool_intern(&stab->names, token, len, name);
 }
 
 ErrorCode symtab_push_cat(Symtab* stab, SymbolCat cat, Symbol* sym) {
@@ -130,62 +160,113 @@ void symtab_pop_scope(Symtab* stab) {
 	}
 
 	--stab->scopes_size;
+
+	/* Names of the popped scope are no longer visible */
+	while (!vec_empty(&stab->binding) && vec_back(&stab->binding).scope >= stab->scopes_size) {
+		SymtabBinding binding = vec_pop_back(&stab->binding);
+		vec_at(&stab->name_binding, binding.name) = binding.shadowed;
+	}
+
 	if (g_debug_print_parse_recursion) {
 		LOGF("Pop scope at depth %d\n", stab->scopes_size);
 	}
 }
 
-/* Finds provided token within indicated scope
-   Returns NULL if not found */
-static Symbol* symtab_find_scoped(Symtab* stab, int i_scope, const char* token) {
+SymtabMark symtab_mark(Symtab* stab) {
 	ASSERT(stab != NULL, "Symtab is null");
+	ASSERT(stab->scopes_size > 0, "No scope exists");
+
+	SymtabMark mark;
+	mark.scope = stab->scopes_size - 1;
+	mark.symbol = svec_size(&stab->symbol);
+	mark.scope_symbol = vec_size(&stab->scopes[mark.scope]);
+	mark.temp_num = stab->temp_num;
+	mark.label_num = stab->label_num;
+	return mark;
+}
 
-	for (int i = 0; i < vec_size(&stab->scopes[i_scope]); ++i) {
-		Symbol* sym = vec_at(&stab->scopes[i_scope], i);
-		if (strequ(symbol_token(sym), token)) return sym;
+void symtab_release(Symtab* stab, SymtabMark mark) {
+	ASSERT(stab != NULL, "Symtab is null");
+	ASSERT(stab->scopes_size - 1 == mark.scope, "Symbols released outside of scope of mark");
+	ASSERT(mark.symbol <= svec_size(&stab->symbol), "Symbols of mark already released");
+
+	/* Symbols of the scope of mark are after mark in the order they were
+	   added to the symbol table, all other symbols after mark are in the
+	   popped scopes */
+	Symtab_Scope* scope = &stab->scopes[mark.scope];
+	int j = vec_size(scope) - 1;
+	for (int i = svec_size(&stab->symbol) - 1; i >= mark.symbol; --i) {
+		Symbol* sym = &svec_at(&stab->symbol, i);
+		if (j >= mark.scope_symbol && vec_at(scope, j) == sym) {
+			--j;
+			continue;
+		}
+		/* Kept symbols are not moved by splice, only their handles */
+		symbol_destruct(sym);
+		svec_splice(&stab->symbol, i, 1);
 	}
-	return NULL;
+
+	/* Names of temporaries and labels are reused */
+	stab->temp_num = mark.temp_num;
+	stab->label_num = mark.label_num;
 }
 
 Symbol* symtab_find(Symtab* stab, const char* token) {
 	ASSERT(stab != NULL, "Symtab is null");
 
-	for (int i_scope = stab->scopes_size - 1; i_scope >= 0; --i_scope) {
-		Symbol* found = symtab_find_scoped(stab, i_scope, token);
-		if (found != NULL) return found;
-	}
-	return NULL;
+	StrId name;
+	strpool_find(&stab->names, token, strlength(token), &name);
+	if (name < 0) return NULL;
+
+	int i_binding = vec_at(&stab->name_binding, name);
+	if (i_binding < 0) return NULL;
+	return vec_at(&stab->binding, i_binding).sym;
 }
 
-/* Allocates storage for symbol in symbol table
-   Stores Symbol* of added symbol at pointer
-   or ec_symtab_dupname if it already exists */
-static ErrorCode symtab_add_scoped(Symtab* stab, Symbol** sym_ptr, int i_scope, const char* token, Type* type) {
+/* Allocates storage for symbol with interned name in symbol table, within
+   indicated scope
+   The symbol is not given a binding, it cannot be found by name
+   Stores Symbol* of added symbol at pointer */
+static ErrorCode symtab_add_scoped(Symtab* stab, Symbol** sym_ptr, int i_scope, StrId name, Type* type) {
 	ASSERT(stab != NULL, "Symtab is null");
 	ASSERT(stab->scopes_size > 0, "Invalid scope");
+	ErrorCode ecode;
 
-	/* Add to vec of symbols in scope */
-	if (token != NULL) {
-		/* Normal symbols can not have duplicates in same scope */
-		if (symtab_find_scoped(stab, i_scope, token) != NULL) {
-			ERRMSGF("Symbol already exists %s\n", token);
-			*sym_ptr = NULL;
-			return ec_symtab_dupname;
-		}
-	}
+	Type* interned_type;
+	if ((ecode = typetable_intern(&stab->types, type, &interned_type)) != ec_noerr) return ecode;
 
 	/* Add to vec of symbols */
-	if (!hvec_push_backu(&stab->symbol)) return ec_badalloc;
-	Symbol* sym = &hvec_back(&stab->symbol);
+	if (!svec_push_backu(&stab->symbol)) return ec_badalloc;
+	Symbol* sym = &svec_back(&stab->symbol);
 
 	if (!vec_push_backu(&stab->scopes[i_scope])) return ec_badalloc;
 	vec_back(&stab->scopes[i_scope]) = sym;
 
-	symbol_construct(sym, token, type);
+	symbol_construct(sym, strpool_str(&stab->names, name), interned_type);
 	*sym_ptr = sym;
 	return ec_noerr;
 }
 
+/* Returns ec_symtab_dupname if name is bound in the current scope */
+static ErrorCode symtab_check_dupname(Symtab* stab, StrId name) {
+	int curr_scope = stab->scopes_size - 1;
+	int i_binding = vec_at(&stab->name_binding, name);
+	if (i_binding >= 0 && vec_at(&stab->binding, i_binding).scope == curr_scope) {
+		ERRMSGF("Symbol already exists %s\n", strpool_str(&stab->names, name));
+		return ec_symtab_dupname;
+	}
+	return ec_noerr;
+}
+
+/* Binds name to sym in the current scope, shadowing the binding of the
+   name in an outer scope */
+static ErrorCode symtab_push_binding(Symtab* stab, Symbol* sym, StrId name) {
+	SymtabBinding binding = {sym, name, stab->scopes_size - 1, vec_at(&stab->name_binding, name)};
+	if (!vec_push_back(&stab->binding, binding)) return ec_badalloc;
+	vec_at(&stab->name_binding, name) = vec_size(&stab->binding) - 1;
+	return ec_noerr;
+}
+
 ErrorCode symtab_add(Symtab* stab, Symbol** sym_ptr, const char* token, Type* type) {
 	ASSERT(stab != NULL, "Symtab is null");
 	ASSERT(token != NULL, "token is null");
@@ -195,20 +276,121 @@ ErrorCode symtab_add(Symtab* stab, Symbol** sym_ptr, const char* token, Type* ty
 
 	/* Add new symbol to current scope */
 	ASSERT(stab->scopes_size > 0, "No scope exists");
-	int curr_scope = stab->scopes_size - 1;
-	return symtab_add_scoped(stab, sym_ptr, curr_scope, token, type);
+	ErrorCode ecode;
+
+	StrId name;
+	if ((ecode = symtab_intern_token(stab, token, &name)) != ec_noerr) return ecode;
+	while (vec_size(&stab->name_binding) <= name) {
+		if (!vec_push_back(&stab->name_binding, -1)) return ec_badalloc;
+	}
+
+	/* Normal symbols can not have duplicates in same scope */
+	if ((ecode = symtab_check_dupname(stab, name)) != ec_noerr) {
+		*sym_ptr = NULL;
+		return ecode;
+	}
+
+	if ((ecode = symtab_add_scoped(stab, sym_ptr, stab->scopes_size - 1, name, type)) != ec_noerr) return ecode;
+	/* First scope is the file scope */
+	if (stab->scopes_size == 1) symbol_set_file_scope(*sym_ptr);
+	return symtab_push_binding(stab, *sym_ptr, name);
+}
+
+ErrorCode symtab_bind(Symtab* stab, Symbol* sym) {
+	ASSERT(stab != NULL, "Symtab is null");
+	ASSERT(sym != NULL, "Symbol is null");
+	ASSERT(stab->scopes_size > 0, "No scope exists");
+	ErrorCode ecode;
+
+	/* Token of the symbol was interned when it was added */
+	const char* token = symbol_token(sym);
+	StrId name;
+	strpool_find(&stab->names, token, strlength(token), &name);
+	ASSERT(name >= 0, "Symbol not in symbol table");
+
+	if ((ecode = symtab_check_dupname(stab, name)) != ec_noerr) return ecode;
+
+	Symtab_Scope* scope = &stab->scopes[stab->scopes_size - 1];
+	if (!vec_push_back(scope, sym)) return ec_badalloc;
+	return symtab_push_binding(stab, sym, name);
+}
+
+static uint32_t symtab_constant_hash(uint64_t value, const Type* type) {
+	TypeSpecifiers ts = type_typespec(type);
+	uint64_t hash = value ^ ((uint64_t)ts << 56) ^ ((uint64_t)type_pointer(type) << 48);
+	hash *= 0x9E3779B97F4A7C15u;
+	return (uint32_t)(hash >> 32);
 }
 
-ErrorCode symtab_add_constant(Symtab* stab, Symbol** sym_ptr, const char* token, Type* type) {
+/* Returns the index of the slot holding the constant of value and
+   canonical type, or the empty slot where it would be inserted */
+static uint32_t symtab_constant_probe(Symtab* stab, uint64_t value, const Type* type) {
+	uint32_t mask = (uint32_t)stab->constant_slot_capacity - 1;
+	uint32_t i = symtab_constant_hash(value, type) & mask;
+	while (stab->constant_slots[i] >= 0) {
+		Symbol* sym = &svec_at(&stab->constant, stab->constant_slots[i]);
+		if (symbol_constant_value(sym) == value && symbol_type(sym) == type) break;
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/* Allocates a new constant hash table with given capacity and inserts
+   the existing constants into it */
+static ErrorCode symtab_constant_rehash(Symtab* stab, int capacity) {
+	int* slots = cmalloc((size_t)capacity * sizeof(int));
+	if (slots == NULL) return ec_badalloc;
+	for (int i = 0; i < capacity; ++i) {
+		slots[i] = -1;
+	}
+	if (stab->constant_slots != NULL) cfree(stab->constant_slots);
+	stab->constant_slots = slots;
+	stab->constant_slot_capacity = capacity;
+
+	for (int i = 0; i < svec_size(&stab->constant); ++i) {
+		Symbol* sym = &svec_at(&stab->constant, i);
+		uint32_t j = symtab_constant_probe(stab, symbol_constant_value(sym), symbol_type(sym));
+		stab->constant_slots[j] = i;
+	}
+	return ec_noerr;
+}
+
+/* Adds the last constant sym to the constant hash table */
+static ErrorCode symtab_constant_insert(Symtab* stab, Symbol* sym) {
+	uint32_t i = symtab_constant_probe(stab, symbol_constant_value(sym), symbol_type(sym));
+	ASSERT(stab->constant_slots[i] < 0, "Constant already in hash table");
+	stab->constant_slots[i] = svec_size(&stab->constant) - 1;
+
+	/* Keep load factor at most 1/2 */
+	if (svec_size(&stab->constant) * 2 > stab->constant_slot_capacity) {
+		return symtab_constant_rehash(stab, stab->constant_slot_capacity * 2);
+	}
+	return ec_noerr;
+}
+
+ErrorCode symtab_add_constant(Symtab* stab, Symbol** sym_ptr, const char* token, uint64_t value, Type* type) {
 	ASSERT(stab != NULL, "Symtab is null");
 	ASSERT(token != NULL, "token is null");
 	ASSERT('0' <= token[0] && token[0] <= '9', "Attempted to add non-constant to symbol table");
 
 	ErrorCode ecode;
-	if (!hvec_push_backu(&stab->constant)) return ec_badalloc;
+	Type* interned_type;
+	if ((ecode = typetable_intern(&stab->types, type, &interned_type)) != ec_noerr) return ecode;
 
-	Symbol* sym = &hvec_back(&stab->constant);
-	if ((ecode = symbol_construct(sym, token, type)) != ec_noerr) return ecode;
+	uint32_t i = symtab_constant_probe(stab, value, interned_type);
+	if (stab->constant_slots[i] >= 0) {
+		*sym_ptr = &svec_at(&stab->constant, stab->constant_slots[i]);
+		return ec_noerr;
+	}
+
+	StrId name;
+	if ((ecode = symtab_intern_token(stab, token, &name)) != ec_noerr) return ecode;
+
+	if (!svec_push_backu(&stab->constant)) return ec_badalloc;
+	Symbol* sym = &svec_back(&stab->constant);
+	symbol_construct(sym, strpool_str(&stab->names, name), interned_type);
+	symbol_set_constant(sym, value);
+	if ((ecode = symtab_constant_insert(stab, sym)) != ec_noerr) return ecode;
 	*sym_ptr = sym;
 	return ec_noerr;
 }
@@ -218,8 +400,11 @@ ErrorCode symtab_add_temporary(Symtab* stab, Symbol** sym_ptr, Type* type) {
 	AAPPENDI(token, "__t", stab->temp_num);
 	++stab->temp_num;
 
+	ASSERT(stab->scopes_size > 0, "No scope exists");
 	ErrorCode ecode;
-	if ((ecode = symtab_add(stab, sym_ptr, token, type)) != ec_noerr) return ecode;
+	StrId name;
+	if ((ecode = symtab_intern_token(stab, token, &name)) != ec_noerr) return ecode;
+	if ((ecode = symtab_add_scoped(stab, sym_ptr, stab->scopes_size - 1, name, type)) != ec_noerr) return ecode;
 	symbol_set_valcat(*sym_ptr, vc_nlval);
 	return ec_noerr;
 }
@@ -232,24 +417,26 @@ ErrorCode symtab_add_label(Symtab* stab, Symbol** sym_ptr) {
 	ASSERT(stab->scopes_size >= 2, "No function scope");
 	/* Scope at index 1 is function scope */
 	ErrorCode ecode;
-	if ((ecode = symtab_add_scoped(stab, sym_ptr, 1, token, &stab->type_label)) != ec_noerr) return ecode;
+	StrId name;
+	if ((ecode = symtab_intern_token(stab, token, &name)) != ec_noerr) return ecode;
+	if ((ecode = symtab_add_scoped(stab, sym_ptr, 1, name, stab->type_label)) != ec_noerr) return ecode;
 	symbol_set_valcat(*sym_ptr, vc_nlval);
 	return ec_noerr;
 }
 
 Symbol* symtab_constant_zero(Symtab* stab) {
 	ASSERT(stab != NULL, "Symtab is null");
-	return &hvec_at(&stab->constant, 0);
+	return &svec_at(&stab->constant, 0);
 }
 
 Symbol* symtab_constant_one(Symtab* stab) {
 	ASSERT(stab != NULL, "Symtab is null");
-	return &hvec_at(&stab->constant, 1);
+	return &svec_at(&stab->constant, 1);
 }
 
 Type* symtab_type_int(Symtab* stab) {
 	ASSERT(stab != NULL, "Symtab is null");
-	return &stab->type_int;
+	return stab->type_int;
 }
 
 void debug_print_symtab(Symtab* stab) {
@@ -285,9 +472,9 @@ void debug_print_symtab(Symtab* stab) {
 		}
 	}
 
-	LOGF("Constants: [%d]\n", hvec_size(&stab->constant));
-	for (int i = 0; i < hvec_size(&stab->constant); ++i) {
-		Symbol* sym = &hvec_at(&stab->constant, i);
+	LOGF("Constants: [%d]\n", svec_size(&stab->constant));
+	for (int i = 0; i < svec_size(&stab->constant); ++i) {
+		Symbol* sym = &svec_at(&stab->constant, i);
 		Type* type = symbol_type(sym);
 		LOGF("    %d %s", i, ts_str(type_typespec(type)));
 		LOGF(" %s\n", symbol_token(sym));
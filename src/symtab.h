@@ -3,7 +3,9 @@
 #define SYMTAB_H
 
 #include "errorcode.h"
+#include "strpool.h"
 #include "symbol.h"
+#include "typetable.h"
 #include "vec.h"
 
 /* The category(purpose) a symbol serves
@@ -19,15 +21,35 @@ typedef enum
 
 typedef vec_t(Symbol*) Symtab_Scope;
 
+/* Name of a symbol visible from the scope it was added to, shadows the
+   binding of the same name in an outer scope */
 typedef struct
 {
-	/* Holds all symbols ever added */
-	hvec_t(Symbol) symbol;
+	Symbol* sym;
+	StrId name;
+	int scope;
+	int shadowed; /* Index of the binding shadowed, -1 if none */
+} SymtabBinding;
 
-	/* Holds all constants symbols ever added */
-	hvec_t(Symbol) constant;
-	Type type_int;
-	Type type_label;
+typedef struct
+{
+	/* Holds all symbols added and not yet released */
+	svec_t(Symbol) symbol;
+
+	/* Holds all constants symbols ever added, each distinct (value, type)
+	   is added once */
+	svec_t(Symbol) constant;
+	/* Open addressing hash table of constants by (value, type), holds
+	   index into constant, -1 if slot is empty
+	   capacity is a power of 2 */
+	int* constant_slots;
+	int constant_slot_capacity;
+
+	/* Types of symbols are canonical types in types, symbols of the same
+	   type have the same Type* */
+	TypeTable types;
+	Type* type_int;
+	Type* type_label;
 
 	/* First scope is most global
 	   First symbol element is earliest in occurrence
@@ -36,6 +58,21 @@ typedef struct
 	int scopes_size;
 	int scopes_capacity;
 
+	/* Tokens of all symbols are interned in names, symbols point to the
+	   interned token
+
+	   Symbols are found by name without searching the scopes
+	   The StrId of a name indexes name_binding for the index of the
+	   innermost binding of the name, -1 if the name is not visible
+	   Bindings of inner scopes are after the bindings of outer scopes,
+	   popping a scope removes its bindings from the back and restores
+	   the bindings they shadowed
+	   Temporaries and labels have unique names and are never found by
+	   name, they have no binding */
+	StrPool names;
+	vec_t(int) name_binding;
+	vec_t(SymtabBinding) binding;
+
 	/* Stack for symbol category, push and pop with
 	   symtab_push_cat()
 	   symtab_pop_cat() */
@@ -46,6 +83,17 @@ typedef struct
 	int label_num;
 } Symtab;
 
+/* Position in the symbol table, the symbols added after it can be
+   released with symtab_release() */
+typedef struct
+{
+	int scope;
+	int symbol;
+	int scope_symbol; /* Symbols in the scope */
+	int temp_num;
+	int label_num;
+} SymtabMark;
+
 ErrorCode symtab_construct(Symtab* stab);
 
 void symtab_destruct(Symtab* stab);
@@ -73,6 +121,15 @@ ErrorCode symtab_push_scope(Symtab* stab);
 /* Removes current symbol scope, now uses the last scope */
 void symtab_pop_scope(Symtab* stab);
 
+/* Returns the position after the last symbol added, within the current scope */
+SymtabMark symtab_mark(Symtab* stab);
+
+/* Destructs the symbols added since mark to scopes which have been
+   popped, the storage of the symbols is reused by symbols added later
+   Must be called in the scope mark was taken in, symbols of that scope,
+   constants and types are kept */
+void symtab_release(Symtab* stab, SymtabMark mark);
+
 /* Finds provided token in symbol table, closest scope first
    Returns NULL if not found */
 Symbol* symtab_find(Symtab* stab, const char* token);
@@ -83,12 +140,21 @@ Symbol* symtab_find(Symtab* stab, const char* token);
 
 /* Creates symbol with provided information in symbol table
    Stores Symbol* of added symbol at pointer,
-   or ec_symtab_dupname if it already exists */
+   or ec_symtab_dupname if it already exists
+   Symbols added to the first scope are at file scope */
 ErrorCode symtab_add(Symtab* stab, Symbol** sym_ptr, const char* token, Type* type);
 
+/* Makes a symbol already in the symbol table visible by its name from
+   the current scope
+   ec_symtab_dupname if a symbol of the same name is in the current scope */
+ErrorCode symtab_bind(Symtab* stab, Symbol* sym);
+
 /* Adds constant to symbol table
-   Stores Symbol* of added constant at pointer */
-ErrorCode symtab_add_constant(Symtab* stab, Symbol** sym_ptr, const char* token, Type* type);
+   token is the spelling of the constant, value is its value as the bits
+   of type
+   Stores Symbol* of added constant at pointer, if a constant of the same
+   value and type was added before, it is stored instead */
+ErrorCode symtab_add_constant(Symtab* stab, Symbol** sym_ptr, const char* token, uint64_t value, Type* type);
 
 /* Creates a new temporary for the current scope in symbol table */
 ErrorCode symtab_add_temporary(Symtab* stab, Symbol** symid_ptr, Type* type);
@@ -106,7 +172,7 @@ Symbol* symtab_constant_zero(Symtab* stab);
 /* Returns the constant 1 */
 Symbol* symtab_constant_one(Symtab* stab);
 
-/* Returns the type int */
+/* Returns the canonical type int */
 Type* symtab_type_int(Symtab* stab);
 
 /* Debug */
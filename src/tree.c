@@ -11,63 +11,112 @@ const char* tt_str(TNodeType tt) {
 	return tnode_type_str[(int)tt];
 }
 
-ErrorCode tnode_alloc(TNode** node_ptr) {
+ErrorCode tnode_alloc(Tree* tree, TNode** node_ptr) {
+	ASSERT(tree != NULL, "Tree is null");
 	ASSERT(node_ptr != NULL, "Node pointer is null");
 
-	*node_ptr = ccalloc(1, sizeof(TNode));
-	if (*node_ptr == NULL) return ec_badalloc;
+	TNode* node = tree->free_node;
+	if (node != NULL) {
+		tree->free_node = (TNode*)(void*)node->child;
+		++tree->node_reused;
+	}
+	else {
+		node = arena_alloc(&tree->arena, sizeof(TNode));
+		if (node == NULL) return ec_badalloc;
+	}
+	++tree->node_count;
+
+	cmemzero(node, sizeof(TNode));
+	*node_ptr = node;
 	return ec_noerr;
 }
 
+/* Returns the class of a child array with capacity */
+static int child_class(int capacity) {
+	int class = 0;
+	while (capacity > 1) {
+		capacity /= 2;
+		++class;
+	}
+	return class;
+}
+
+/* Allocates a child array with capacity 2^(class + 1) - 1 */
+static TNode** child_alloc(Tree* tree, int class) {
+	ASSERT(class < TREE_CHILD_CLASSES, "Child array too large");
+	++tree->child_count;
+
+	TNode** child = tree->free_child[class];
+	if (child != NULL) {
+		tree->free_child[class] = (TNode**)(void*)child[0];
+		++tree->child_reused;
+		return child;
+	}
+
+	size_t capacity = ((size_t)2 << class) - 1;
+	return arena_alloc(&tree->arena, capacity * sizeof(TNode*));
+}
+
+/* Keeps child array with capacity for reuse */
+static void child_free(Tree* tree, TNode** child, int capacity) {
+	int class = child_class(capacity);
+	child[0] = (TNode*)(void*)tree->free_child[class];
+	tree->free_child[class] = child;
+}
+
 /* Deletes members only, assumes children have been handled */
-static void tnode_destruct_members(TNode* node) {
-	cfree(node->child);
-	cfree(node);
+static void tnode_destruct_members(Tree* tree, TNode* node) {
+	if (node->child != NULL) child_free(tree, node->child, node->child_capacity);
+
+	node->child = (TNode**)(void*)tree->free_node;
+	tree->free_node = node;
+	++tree->node_destructed;
 }
 
-void tnode_destruct(TNode* node) {
+void tnode_destruct(Tree* tree, TNode* node) {
 	if (node == NULL) return;
 
 	for (int i = 0; i < node->child_count; ++i) {
 		if (node->child[i] != NULL) {
-			tnode_destruct(node->child[i]);
+			tnode_destruct(tree, node->child[i]);
 		}
 	}
-	tnode_destruct_members(node);
+	tnode_destruct_members(tree, node);
 }
 
-ErrorCode tnode_attach(TNode* node, TNode* new_node) {
+ErrorCode tnode_attach(Tree* tree, TNode* node, TNode* new_node) {
 	ASSERT(node != NULL, "Node is null");
 	ASSERT(new_node != NULL, "New node is null");
 
 	/* Resize */
 	if (node->child_count >= node->child_capacity) {
-		node->child_capacity = node->child_capacity * 2 + 1;
-		TNode** new_buf = cmalloc(node->child_capacity * sizeof(TNode));
+		int capacity = node->child_capacity * 2 + 1;
+		TNode** new_buf = child_alloc(tree, child_class(capacity));
 		if (new_buf == NULL) return ec_badalloc;
 
 		for (int i = 0; i < node->child_count; ++i) {
 			new_buf[i] = node->child[i];
 		}
-		cfree(node->child);
+		if (node->child != NULL) child_free(tree, node->child, node->child_capacity);
 		node->child = new_buf;
+		node->child_capacity = capacity;
 	}
 
 	node->child[node->child_count++] = new_node;
 	return ec_noerr;
 }
 
-ErrorCode tnode_alloca(TNode** node_ptr, TNode* parent) {
+ErrorCode tnode_alloca(Tree* tree, TNode** node_ptr, TNode* parent) {
 	ASSERT(node_ptr != NULL, "Node is null");
 	ASSERT(parent != NULL, "Parent is null");
 	ErrorCode ecode;
 
-	ecode = tnode_alloc(node_ptr);
+	ecode = tnode_alloc(tree, node_ptr);
 	if (ecode == ec_noerr) {
-		ecode = tnode_attach(parent, *node_ptr);
+		ecode = tnode_attach(tree, parent, *node_ptr);
 		if (ecode == ec_noerr) return ec_noerr;
 
-		tnode_destruct(*node_ptr);
+		tnode_destruct(tree, *node_ptr);
 		return ecode;
 	}
 	return ecode;
@@ -90,7 +139,7 @@ TNode* tnode_child(TNode* node, int i) {
 	return node->child[node->child_count + i];
 }
 
-ErrorCode tnode_replace_child(TNode* node, TNode** new_child_ptr, int i) {
+ErrorCode tnode_replace_child(Tree* tree, TNode* node, TNode** new_child_ptr, int i) {
 	ASSERT(node != NULL, "Node is null");
 
 	if (i >= 0) {
@@ -101,15 +150,39 @@ ErrorCode tnode_replace_child(TNode* node, TNode** new_child_ptr, int i) {
 		i = node->child_count + i;
 	}
 
-	tnode_destruct(node->child[i]);
+	tnode_destruct(tree, node->child[i]);
 
 	ErrorCode ecode;
-	if ((ecode = tnode_alloc(&node->child[i])) != ec_noerr) return ecode;
+	if ((ecode = tnode_alloc(tree, &node->child[i])) != ec_noerr) return ecode;
 
 	*new_child_ptr = node->child[i];
 	return ec_noerr;
 }
 
+ErrorCode tnode_wrap_child(Tree* tree, TNode* node, TNode** new_node_ptr, int i) {
+	ASSERT(node != NULL, "Node is null");
+	ErrorCode ecode;
+
+	if (i >= 0) {
+		ASSERT(i < node->child_count, "Child index out of range");
+	}
+	else {
+		ASSERT(node->child_count + i >= 0, "Child reverse index out of range");
+		i = node->child_count + i;
+	}
+
+	TNode* new_node;
+	if ((ecode = tnode_alloc(tree, &new_node)) != ec_noerr) return ecode;
+	if ((ecode = tnode_attach(tree, new_node, node->child[i])) != ec_noerr) {
+		tnode_destruct(tree, new_node);
+		return ecode;
+	}
+
+	node->child[i] = new_node;
+	*new_node_ptr = new_node;
+	return ec_noerr;
+}
+
 TNodeType tnode_type(TNode* node) {
 	ASSERT(node != NULL, "Node is null");
 	return node->type;
@@ -196,7 +269,7 @@ void tnode_set(TNode* node, TNodeType tt, void* data) {
 /* Remove the ith child of node
    The index i is adjusted as in a loop, the same index has to be rescanned
    if the child was removed */
-static ErrorCode do_remove(TNode* node, int* i) {
+static ErrorCode do_remove(Tree* tree, TNode* node, int* i) {
 	ASSERT(node != NULL, "Node is null");
 	ErrorCode ecode;
 
@@ -216,7 +289,7 @@ static ErrorCode do_remove(TNode* node, int* i) {
 
 		/* Add remaining child's children to this node */
 		for (int j = 1; j < child->child_count; ++j) {
-			if ((ecode = tnode_attach(node, child->child[j])) != ec_noerr) return ecode;
+			if ((ecode = tnode_attach(tree, node, child->child[j])) != ec_noerr) return ecode;
 		}
 		/* Swap the children into the right position
 		   e.g., A -> B -> D, E
@@ -230,11 +303,11 @@ static ErrorCode do_remove(TNode* node, int* i) {
 			node->child[j - child->child_count + 1] = tmp;
 		}
 	}
-	tnode_destruct_members(child);
+	tnode_destruct_members(tree, child);
 	return ec_noerr;
 }
 
-ErrorCode tnode_remove_if(TNode* node, int (*cmp)(TNode*)) {
+ErrorCode tnode_remove_if(Tree* tree, TNode* node, int (*cmp)(TNode*)) {
 	ASSERT(node != NULL, "Node is null");
 	ErrorCode ecode;
 
@@ -242,15 +315,15 @@ ErrorCode tnode_remove_if(TNode* node, int (*cmp)(TNode*)) {
 		TNode* child = node->child[i];
 
 		ASSERT(child != NULL, "TNode child is NULL");
-		if ((ecode = tnode_remove_if(child, cmp)) != ec_noerr) return ecode;
+		if ((ecode = tnode_remove_if(tree, child, cmp)) != ec_noerr) return ecode;
 
 		if (!cmp(child)) continue;
-		if ((ecode = do_remove(node, &i)) != ec_noerr) return ecode;
+		if ((ecode = do_remove(tree, node, &i)) != ec_noerr) return ecode;
 	}
 	return ec_noerr;
 }
 
-ErrorCode tnode_remove_ifi(TNode* node, int i, int (*cmp)(TNode*)) {
+ErrorCode tnode_remove_ifi(Tree* tree, TNode* node, int i, int (*cmp)(TNode*)) {
 	ASSERT(node != NULL, "Node is null");
 	ErrorCode ecode;
 
@@ -264,10 +337,10 @@ ErrorCode tnode_remove_ifi(TNode* node, int i, int (*cmp)(TNode*)) {
 
 	TNode* child = node->child[i];
 	ASSERT(child != NULL, "TNode child is NULL");
-	if ((ecode = tnode_remove_if(child, cmp)) != ec_noerr) return ecode;
+	if ((ecode = tnode_remove_if(tree, child, cmp)) != ec_noerr) return ecode;
 
 	if (cmp(child)) {
-		if ((ecode = do_remove(node, &i)) != ec_noerr) return ecode;
+		if ((ecode = do_remove(tree, node, &i)) != ec_noerr) return ecode;
 	}
 	return ec_noerr;
 }
@@ -276,13 +349,23 @@ ErrorCode tree_construct(Tree* tree) {
 	ASSERT(tree != NULL, "Tree is null");
 	ErrorCode ecode;
 
-	if ((ecode = tnode_alloc(&tree->root)) != ec_noerr) return ecode;
+	arena_construct(&tree->arena);
+	tree->free_node = NULL;
+	for (int i = 0; i < TREE_CHILD_CLASSES; ++i) {
+		tree->free_child[i] = NULL;
+	}
+	tree->node_count = 0;
+	tree->child_count = 0;
+	tree->node_reused = 0;
+	tree->child_reused = 0;
+
+	if ((ecode = tnode_alloc(tree, &tree->root)) != ec_noerr) return ecode;
 	tree->root->type = tt_root;
 	return ec_noerr;
 }
 
 void tree_destruct(Tree* tree) {
-	tnode_destruct(tree->root);
+	arena_destruct(&tree->arena);
 }
 
 TNode* tree_root(Tree* tree) {
@@ -290,6 +373,14 @@ TNode* tree_root(Tree* tree) {
 	return tree->root;
 }
 
+void tree_clear(Tree* tree) {
+	ASSERT(tree != NULL, "Tree is null");
+	for (int i = 0; i < tree->root->child_count; ++i) {
+		tnode_destruct(tree, tree->root->child[i]);
+	}
+	tree->root->child_count = 0;
+}
+
 /* Prints out the parse tree
    branch stores the branch string, e.g., "| |   | "
    i_branch is index of null terminator in branch
@@ -529,3 +620,12 @@ void debug_print_tree(Tree* tree) {
 	branch[0] = '\0';
 	debug_tnode_walk(tree, tree->root, branch, 0, max_branch);
 }
+
+void debug_print_tree_stats(Tree* tree) {
+	ASSERT(tree != NULL, "Tree is null");
+	LOG("Tree stats:\n");
+	LOGF("  Nodes: %d (%d reused)\n", tree->node_count, tree->node_reused);
+	LOGF("  Child arrays: %d (%d reused)\n", tree->child_count, tree->child_reused);
+	LOGF("  Arena: %zu bytes used, %zu bytes in %d chunks\n", tree->arena.bytes_used, tree->arena.bytes_reserved,
+		 arena_chunk_count(&tree->arena));
+}
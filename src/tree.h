@@ -2,6 +2,7 @@
 #ifndef TREE_H
 #define TREE_H
 
+#include "arena.h"
 #include "constant.h"
 #include "errorcode.h"
 #include "symbol.h"
@@ -15,7 +16,7 @@ typedef struct
 
 typedef struct
 {
-	char token[MAX_TOKEN_LEN + 1];
+	const char* token; /* Interned by the lexer, valid until it is destructed */
 } TNodeNewIdentifier;
 
 typedef struct
@@ -188,19 +189,46 @@ typedef struct TNode
 	TNodeData data;
 } TNode;
 
-/* Allocates a new TNode, stored at node_ptr */
-ErrorCode tnode_alloc(TNode** node_ptr);
+/* Capacities of child arrays are 2^n - 1, a freed child array is kept
+   for reuse by its n - 1 */
+#define TREE_CHILD_CLASSES 31
 
-/* Allocates a new TNode, stored at node_ptr
+/* Nodes and their child arrays are allocated from the tree's arena,
+   and are freed all at once when the tree is destructed
+   Nodes and child arrays which are destructed before are reused */
+typedef struct Tree
+{
+	TNode* root;
+
+	Arena arena;
+	/* Free nodes, linked through child */
+	TNode* free_node;
+	/* Free child arrays for each class, linked through element 0 */
+	TNode** free_child[TREE_CHILD_CLASSES];
+
+	/* Nodes and child arrays allocated, including reused ones */
+	int node_count;
+	int child_count;
+	/* Nodes and child arrays which were reused */
+	int node_reused;
+	int child_reused;
+	/* Nodes destructed before the tree */
+	int node_destructed;
+} Tree;
+
+/* Allocates a new TNode in tree, stored at node_ptr */
+ErrorCode tnode_alloc(Tree* tree, TNode** node_ptr);
+
+/* Allocates a new TNode in tree, stored at node_ptr
    attached to parent */
-ErrorCode tnode_alloca(TNode** node_ptr, TNode* parent);
+ErrorCode tnode_alloca(Tree* tree, TNode** node_ptr, TNode* parent);
 
-/* Frees TNode and children */
-void tnode_destruct(TNode* node);
+/* Frees TNode and children, their memory is reused by the tree */
+void tnode_destruct(Tree* tree, TNode* node);
 
 /* Attaches TNode new_node onto TNode node
    node takes ownership of new_node */
-ErrorCode tnode_attach(TNode* node, TNode* new_node);
+ErrorCode tnode_attach(Tree* tree, TNode* node, TNode* new_node);
 
 /* Counts number of children for given node */
 int tnode_count_child(TNode* node);
@@ -211,7 +239,12 @@ TNode* tnode_child(TNode* node, int i);
 
 /* Replaces the child at index with new child, saved to provided pointer
    negative to index backwards (-1 means last child, -2 second last) */
-ErrorCode tnode_replace_child(TNode* node, TNode** new_child_ptr, int i);
+ErrorCode tnode_replace_child(Tree* tree, TNode* node, TNode** new_child_ptr, int i);
+
+/* Puts a new node in place of the child at index, the child becomes the
+   only child of the new node, saved to provided pointer
+   negative to index backwards (-1 means last child, -2 second last) */
+ErrorCode tnode_wrap_child(Tree* tree, TNode* node, TNode** new_node_ptr, int i);
 
 /* Retrieves the type for node */
 TNodeType tnode_type(TNode* node);
@@ -226,17 +259,12 @@ void tnode_set(TNode* node, TNodeType tt, void* data);
 
 /* For the subtree starting at node,
    remove each node if provided cmp function returns 1 */
-ErrorCode tnode_remove_if(TNode* node, int (*cmp)(TNode*));
+ErrorCode tnode_remove_if(Tree* tree, TNode* node, int (*cmp)(TNode*));
 
 /* For the subtree starting at node's child at idx,
    remove each node if provided cmp function returns 1.
    negative to index backwards (-1 means last child, -2 second last) */
-ErrorCode tnode_remove_ifi(TNode* node, int i, int (*cmp)(TNode*));
-
-typedef struct
-{
-	TNode* root;
-} Tree;
+ErrorCode tnode_remove_ifi(Tree* tree, TNode* node, int i, int (*cmp)(TNode*));
 
 ErrorCode tree_construct(Tree* tree);
 void tree_destruct(Tree* tree);
@@ -244,6 +272,12 @@ void tree_destruct(Tree* tree);
 /* Returns the root of the tree */
 TNode* tree_root(Tree* tree);
 
+/* Frees all nodes except the root, their memory is reused by the tree */
+void tree_clear(Tree* tree);
+
 void debug_print_tree(Tree* tree);
 
+/* Prints out the memory used by the tree */
+void debug_print_tree_stats(Tree* tree);
+
 #endif
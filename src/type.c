@@ -204,57 +204,52 @@ Type* type_return(Type* type) {
 	return type->data.function.return_type;
 }
 
-int type_bytes(const Type* type) {
-	ASSERT(type != NULL, "Type is null");
-
-	if (type->pointers > 0) {
-		return 8;
-	}
-
-	ASSERT(type->category == TypeCategory_standard, "Expected standard type");
-	TypeSpecifiers ts = type->data.standard.typespec;
-	ASSERT(ts != ts_none, "Invalid type specifiers");
-
-	int bytes = 0;
+/* Number of bytes a value of the type specifiers takes up */
+static int type_typespec_bytes(TypeSpecifiers ts) {
 	switch (ts) {
 	case ts_void:
-		bytes = 0;
-		break;
+		return 0;
 	case ts_char:
 	case ts_schar:
 	case ts_uchar:
-		bytes = 1;
-		break;
+		return 1;
 	case ts_short:
 	case ts_ushort:
-		bytes = 2;
-		break;
+		return 2;
 	case ts_int:
 	case ts_uint:
-		bytes = 4;
-		break;
+		return 4;
 	case ts_long:
 	case ts_ulong:
-		bytes = 4;
-		break;
+		return 4;
 	case ts_longlong:
 	case ts_ulonglong:
-		bytes = 8;
-		break;
+		return 8;
 	case ts_float:
-		bytes = 4;
-		break;
+		return 4;
 	case ts_double:
 	case ts_ldouble:
-		bytes = 8;
-		break;
+		return 8;
 	case ts_none:
 	case ts_count:
 	default:
 		ASSERT(0, "Bad type specifier");
-		bytes = 0;
-		break;
+		return 0;
 	}
+}
+
+int type_bytes(const Type* type) {
+	ASSERT(type != NULL, "Type is null");
+
+	if (type->pointers > 0) {
+		return 8;
+	}
+
+	ASSERT(type->category == TypeCategory_standard, "Expected standard type");
+	TypeSpecifiers ts = type->data.standard.typespec;
+	ASSERT(ts != ts_none, "Invalid type specifiers");
+
+	int bytes = type_typespec_bytes(ts);
 	if (type->dimension > 0) {
 		ASSERT(type->dimension == 1, "Only single dimension arrays supported for now");
 		bytes *= type->size[0];
@@ -286,6 +281,23 @@ int type_equal(const Type* lhs, const Type* rhs) {
 	return 1;
 }
 
+int type_same_representation(const Type* lhs, const Type* rhs) {
+	ASSERT(lhs != NULL, "Type is null");
+	ASSERT(rhs != NULL, "Type is null");
+
+	if (lhs->category != TypeCategory_standard || rhs->category != TypeCategory_standard) return 0;
+	if (lhs->dimension > 0 || rhs->dimension > 0) return 0;
+	if (lhs->pointers != rhs->pointers) return 0;
+
+	TypeSpecifiers lts = lhs->data.standard.typespec;
+	TypeSpecifiers rts = rhs->data.standard.typespec;
+	if (lts == rts) return 1;
+	/* Integers of the same size and signedness, e.g., int and long */
+	if (type_signed(lts) != type_signed(rts) || type_unsigned(lts) != type_unsigned(rts)) return 0;
+	if (!type_signed(lts) && !type_unsigned(lts)) return 0;
+	return type_typespec_bytes(lts) == type_typespec_bytes(rts);
+}
+
 int type_rank(TypeSpecifiers typespec) {
 	switch (typespec) {
 	case ts_char:
@@ -429,6 +441,13 @@ int type_unsigned(TypeSpecifiers typespec) {
 	}
 }
 
+uint64_t type_max(TypeSpecifiers typespec) {
+	int bits = type_typespec_bytes(typespec) * 8;
+	uint64_t max = ~(uint64_t)0 >> (64 - bits);
+	if (type_signed(typespec)) max >>= 1;
+	return max;
+}
+
 int type_signed_represent_unsigned(TypeSpecifiers sign, TypeSpecifiers unsign) {
 	switch (sign) {
 	case ts_char:
@@ -2,6 +2,8 @@
 #ifndef TYPE_H
 #define TYPE_H
 
+#include <stdint.h>
+
 #include "errorcode.h"
 
 /* Maximum length of declaration specifier string,
@@ -131,6 +133,11 @@ int type_bytes(const Type* type);
 /* Return 1 if both types are equal, 0 if not */
 int type_equal(const Type* lhs, const Type* rhs);
 
+/* Returns 1 if values of both types are stored the same way, e.g., int
+   and long are both 32 bit signed integers, 0 if not
+   Arrays are never the same representation */
+int type_same_representation(const Type* lhs, const Type* rhs);
+
 /* Returns the integer conversion rank for a given integer type */
 int type_rank(TypeSpecifiers typespec);
 
@@ -159,6 +166,9 @@ int type_signed(TypeSpecifiers typespec);
 /* Returns 1 if the provided type is unsigned, 0 if not */
 int type_unsigned(TypeSpecifiers typespec);
 
+/* Returns the largest value of the provided integer type */
+uint64_t type_max(TypeSpecifiers typespec);
+
 /* Returns 1 if the given signed type can represent to given unsigned type */
 int type_signed_represent_unsigned(TypeSpecifiers sign, TypeSpecifiers unsign);
 
@@ -0,0 +1,227 @@
+#include "typetable.h"
+
+#include "common.h"
+
+/* Initial number of slots in hash tables, must be power of 2 */
+#define TYPETABLE_INITIAL_SLOTS 64
+
+/* FNV-1a over the fields which distinguish types */
+static uint32_t typetable_hash_word(uint32_t hash, uint32_t word) {
+	for (int i = 0; i < 4; ++i) {
+		hash ^= (word >> (i * 8)) & 0xFF;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+static uint32_t typetable_hash(const Type* type) {
+	uint32_t hash = 2166136261u;
+	hash = typetable_hash_word(hash, (uint32_t)type->category);
+	if (type->category == TypeCategory_standard) {
+		hash = typetable_hash_word(hash, (uint32_t)type->data.standard.typespec);
+	}
+	else {
+		hash = typetable_hash_word(hash, typetable_hash(type->data.function.return_type));
+	}
+	hash = typetable_hash_word(hash, (uint32_t)type->pointers);
+	hash = typetable_hash_word(hash, (uint32_t)type->dimension);
+	hash = typetable_hash_word(hash, (uint32_t)type->size[0]);
+	return hash;
+}
+
+/* Returns 1 if the types are the same in every way, type_equal does not
+   compare array dimensions */
+static int typetable_same(const Type* lhs, const Type* rhs) {
+	if (!type_equal(lhs, rhs)) return 0;
+	if (lhs->category == TypeCategory_function &&
+		!typetable_same(lhs->data.function.return_type, rhs->data.function.return_type)) {
+		return 0;
+	}
+	return lhs->dimension == rhs->dimension && lhs->size[0] == rhs->size[0];
+}
+
+/* Returns the index of the slot holding type with hash, or the empty slot
+   where it would be inserted */
+static uint32_t typetable_probe(const TypeTable* table, const Type* type, uint32_t hash) {
+	uint32_t mask = (uint32_t)table->slot_capacity - 1;
+	uint32_t i = hash & mask;
+	while (table->slots[i].type != NULL) {
+		TypeTableSlot slot = table->slots[i];
+		if (slot.hash == hash && typetable_same(slot.type, type)) break;
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/* Allocates a new hash table of types with given capacity and inserts
+   the existing types into it */
+static ErrorCode typetable_rehash(TypeTable* table, int capacity) {
+	TypeTableSlot* slots = cmalloc((size_t)capacity * sizeof(TypeTableSlot));
+	if (slots == NULL) return ec_badalloc;
+	for (int i = 0; i < capacity; ++i) {
+		slots[i].type = NULL;
+	}
+
+	uint32_t mask = (uint32_t)capacity - 1;
+	for (int i = 0; i < table->slot_capacity; ++i) {
+		TypeTableSlot slot = table->slots[i];
+		if (slot.type == NULL) continue;
+
+		uint32_t j = slot.hash & mask;
+		while (slots[j].type != NULL) {
+			j = (j + 1) & mask;
+		}
+		slots[j] = slot;
+	}
+
+	if (table->slots != NULL) cfree(table->slots);
+	table->slots = slots;
+	table->slot_capacity = capacity;
+	return ec_noerr;
+}
+
+static uint32_t typetable_common_hash(const Type* type1, const Type* type2) {
+	uint64_t hash = ((uint64_t)(uintptr_t)type1 * 31) ^ (uint64_t)(uintptr_t)type2;
+	hash *= 0x9E3779B97F4A7C15u;
+	return (uint32_t)(hash >> 32);
+}
+
+/* Returns the index of the slot holding the common type of type1 and
+   type2, or the empty slot where it would be inserted */
+static uint32_t typetable_common_probe(const TypeTable* table, const Type* type1, const Type* type2) {
+	uint32_t mask = (uint32_t)table->common_slot_capacity - 1;
+	uint32_t i = typetable_common_hash(type1, type2) & mask;
+	while (table->common_slots[i].type1 != NULL) {
+		TypeTableCommonSlot slot = table->common_slots[i];
+		if (slot.type1 == type1 && slot.type2 == type2) break;
+		i = (i + 1) & mask;
+	}
+	return i;
+}
+
+/* Allocates a new hash table of common types with given capacity and
+   inserts the existing common types into it */
+static ErrorCode typetable_common_rehash(TypeTable* table, int capacity) {
+	TypeTableCommonSlot* old_slots = table->common_slots;
+	int old_capacity = table->common_slot_capacity;
+
+	TypeTableCommonSlot* slots = cmalloc((size_t)capacity * sizeof(TypeTableCommonSlot));
+	if (slots == NULL) return ec_badalloc;
+	for (int i = 0; i < capacity; ++i) {
+		slots[i].type1 = NULL;
+	}
+	table->common_slots = slots;
+	table->common_slot_capacity = capacity;
+
+	for (int i = 0; i < old_capacity; ++i) {
+		TypeTableCommonSlot slot = old_slots[i];
+		if (slot.type1 == NULL) continue;
+		table->common_slots[typetable_common_probe(table, slot.type1, slot.type2)] = slot;
+	}
+
+	if (old_slots != NULL) cfree(old_slots);
+	return ec_noerr;
+}
+
+ErrorCode typetable_construct(TypeTable* table) {
+	ASSERT(table != NULL, "TypeTable is null");
+	ErrorCode ecode;
+	svec_construct(&table->type);
+
+	table->slots = NULL;
+	table->slot_capacity = 0;
+	if ((ecode = typetable_rehash(table, TYPETABLE_INITIAL_SLOTS)) != ec_noerr) return ecode;
+
+	table->common_slots = NULL;
+	table->common_slot_capacity = 0;
+	table->common_size = 0;
+	return typetable_common_rehash(table, TYPETABLE_INITIAL_SLOTS);
+}
+
+void typetable_destruct(TypeTable* table) {
+	ASSERT(table != NULL, "TypeTable is null");
+	for (int i = 0; i < svec_size(&table->type); ++i) {
+		type_destruct(&svec_at(&table->type, i));
+	}
+	svec_destruct(&table->type);
+	if (table->slots != NULL) cfree(table->slots);
+	if (table->common_slots != NULL) cfree(table->common_slots);
+}
+
+ErrorCode typetable_intern(TypeTable* table, const Type* type, Type** handle) {
+	ASSERT(table != NULL, "TypeTable is null");
+	ASSERT(type != NULL, "Type is null");
+	ErrorCode ecode;
+
+	uint32_t hash = typetable_hash(type);
+	uint32_t i = typetable_probe(table, type, hash);
+	if (table->slots[i].type != NULL) {
+		*handle = table->slots[i].type;
+		return ec_noerr;
+	}
+
+	/* Not found, add copy of type */
+	if (!svec_push_backu(&table->type)) return ec_badalloc;
+	Type* canonical = &svec_back(&table->type);
+	if ((ecode = type_copy(type, canonical)) != ec_noerr) {
+		svec_splice(&table->type, svec_size(&table->type) - 1, 1);
+		return ecode;
+	}
+	table->slots[i].hash = hash;
+	table->slots[i].type = canonical;
+
+	/* Keep load factor at most 1/2 */
+	if (svec_size(&table->type) * 2 > table->slot_capacity) {
+		if ((ecode = typetable_rehash(table, table->slot_capacity * 2)) != ec_noerr) return ecode;
+	}
+
+	*handle = canonical;
+	return ec_noerr;
+}
+
+ErrorCode typetable_common(TypeTable* table, const Type* type1, const Type* type2, Type** handle) {
+	ASSERT(table != NULL, "TypeTable is null");
+	ASSERT(type1 != NULL, "Type is null");
+	ASSERT(type2 != NULL, "Type is null");
+	ErrorCode ecode;
+
+	uint32_t i = typetable_common_probe(table, type1, type2);
+	if (table->common_slots[i].type1 != NULL) {
+		*handle = table->common_slots[i].common;
+		return ec_noerr;
+	}
+
+	/* Promote types smaller than int to int */
+	Type t1;
+	Type t2;
+	Type common;
+	if ((ecode = type_promotion(type1, &t1)) != ec_noerr) goto exit1;
+	if ((ecode = type_promotion(type2, &t2)) != ec_noerr) goto exit2;
+	/* Evaluate common type */
+	if ((ecode = type_common(&t1, &t2, &common)) != ec_noerr) goto exit3;
+	if ((ecode = typetable_intern(table, &common, handle)) != ec_noerr) goto exit4;
+
+	table->common_slots[i].type1 = type1;
+	table->common_slots[i].type2 = type2;
+	table->common_slots[i].common = *handle;
+	++table->common_size;
+
+	/* Keep load factor at most 1/2 */
+	if (table->common_size * 2 > table->common_slot_capacity) {
+		ecode = typetable_common_rehash(table, table->common_slot_capacity * 2);
+	}
+
+exit4:
+	type_destruct(&common);
+exit3:
+	type_destruct(&t2);
+exit2:
+	type_destruct(&t1);
+exit1:
+	return ecode;
+}
+
+int typetable_size(const TypeTable* table) {
+	ASSERT(table != NULL, "TypeTable is null");
+	return svec_size(&table->type);
+}
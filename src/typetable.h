@@ -0,0 +1,62 @@
+/* Table of canonical types
+   Each distinct type is held once, types from the table are compared
+   by their handle (pointer) instead of by their fields */
+#ifndef TYPETABLE_H
+#define TYPETABLE_H
+
+#include <stdint.h>
+
+#include "errorcode.h"
+#include "type.h"
+#include "vec.h"
+
+typedef struct
+{
+	uint32_t hash;
+	Type* type; /* NULL if slot is empty */
+} TypeTableSlot;
+
+/* Memoized common type of a pair of canonical types */
+typedef struct
+{
+	const Type* type1; /* NULL if slot is empty */
+	const Type* type2;
+	Type* common;
+} TypeTableCommonSlot;
+
+typedef struct
+{
+	/* Canonical types, never move as handles point to them */
+	svec_t(Type) type;
+
+	/* Open addressing hash table of canonical types, capacity is a
+	   power of 2 */
+	TypeTableSlot* slots;
+	int slot_capacity;
+
+	/* Open addressing hash table of common types, capacity is a
+	   power of 2 */
+	TypeTableCommonSlot* common_slots;
+	int common_slot_capacity;
+	int common_size;
+} TypeTable;
+
+ErrorCode typetable_construct(TypeTable* table);
+
+void typetable_destruct(TypeTable* table);
+
+/* Finds the canonical type equal to type in every way, including array
+   dimensions, adding a copy of type if there is none
+   The handle of the canonical type is stored at the provided pointer */
+ErrorCode typetable_intern(TypeTable* table, const Type* type, Type** handle);
+
+/* Applies C 6.3.1.1 integer promotions to both canonical types, then
+   C 6.3.1.8 usual arithmetic conversions to obtain their common type
+   Results are memoized by the pair of handles
+   The handle of the common type is stored at the provided pointer */
+ErrorCode typetable_common(TypeTable* table, const Type* type1, const Type* type2, Type** handle);
+
+/* Returns number of canonical types */
+int typetable_size(const TypeTable* table);
+
+#endif
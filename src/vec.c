@@ -95,8 +95,9 @@ int hvec_expand_(char* vec_, int elem_bytes) {
 	return 1;
 }
 
-int hvec_insert_(char* vec_, int elem_bytes, int idx) {
-	hvec_vec_* vec = (hvec_vec_*)vec_;
+/* Moves handles at and after index backwards, handle past the length
+   must be valid */
+static void handle_insert_(hvec_vec_* vec, int idx) {
 	/* Since each vec element is a pointer to heap, take the last pointer and
 	   move it to idx (as it is still usable)
 
@@ -105,12 +106,16 @@ int hvec_insert_(char* vec_, int elem_bytes, int idx) {
 	   |     |     |     | idx |     |     | length |
 						  ^ Put here        ^ Take this pointer
 											  (Will be overwritten)  */
-	if (!hvec_expand_(vec_, elem_bytes)) return 0;
 	void* elem = vec_at(vec, vec_size(vec));
 	for (int i = vec_size(vec); i > idx; --i) {
 		vec_at(vec, i) = vec_at(vec, i - 1);
 	}
 	vec_at(vec, idx) = elem;
+}
+
+int hvec_insert_(char* vec_, int elem_bytes, int idx) {
+	if (!hvec_expand_(vec_, elem_bytes)) return 0;
+	handle_insert_((hvec_vec_*)vec_, idx);
 	return 1;
 }
 
@@ -143,3 +148,54 @@ void hvec_splice_(char* vec_, int start, int count) {
 loop_exit:
 	vec->length -= count;
 }
+
+void svec_destruct_(char* vec_, char* slabs_) {
+	hvec_vec_* vec = (hvec_vec_*)vec_;
+	svec_slabs_* slabs = (svec_slabs_*)slabs_;
+	for (int i = 0; i < vec_size(slabs); ++i) {
+		cfree(vec_at(slabs, i));
+	}
+	vec_destruct(slabs);
+	vec_destruct(vec);
+}
+
+int svec_reserve_(char* vec_, char* slabs_, int n, int elem_bytes) {
+	hvec_vec_* vec = (hvec_vec_*)vec_;
+	svec_slabs_* slabs = (svec_slabs_*)slabs_;
+	if (n > vec->capacity) {
+		int old_capacity = vec->capacity;
+		/* Capacity is kept a multiple of the slab size so every slab is
+		   filled with handles */
+		int slab_count = (n - old_capacity + SVEC_SLAB_SIZE - 1) / SVEC_SLAB_SIZE;
+		if (!vec_reserve(vec, old_capacity + slab_count * SVEC_SLAB_SIZE)) return 0;
+		if (!vec_reserve(slabs, vec_size(slabs) + slab_count)) return 0;
+		/* Capacity only counts handles pointing into a slab */
+		vec->capacity = old_capacity;
+
+		for (int i = 0; i < slab_count; ++i) {
+			char* slab = cmalloc((size_t)elem_bytes * SVEC_SLAB_SIZE);
+			if (slab == NULL) return 0;
+			(void)vec_push_back(slabs, slab);
+			for (int j = 0; j < SVEC_SLAB_SIZE; ++j) {
+				vec->data[old_capacity + i * SVEC_SLAB_SIZE + j] = slab + (size_t)elem_bytes * (size_t)j;
+			}
+			vec->capacity = old_capacity + (i + 1) * SVEC_SLAB_SIZE;
+		}
+	}
+	return 1;
+}
+
+int svec_expand_(char* vec_, char* slabs_, int elem_bytes) {
+	hvec_vec_* vec = (hvec_vec_*)vec_;
+	if (vec->length == vec->capacity) {
+		/* Double the slabs, at least one new slab */
+		return svec_reserve_(vec_, slabs_, vec->capacity * 2 + 1, elem_bytes);
+	}
+	return 1;
+}
+
+int svec_insert_(char* vec_, char* slabs_, int elem_bytes, int idx) {
+	if (!svec_expand_(vec_, slabs_, elem_bytes)) return 0;
+	handle_insert_((hvec_vec_*)vec_, idx);
+	return 1;
+}
@@ -195,4 +195,103 @@ int hvec_insert_(char* vec_, int elem_bytes, int idx);
 /* Deletes count elements starting at index start */
 void hvec_splice_(char* vec_, int start, int count);
 
+/* ============================================================ */
+/* Stores T via a handle like hvec, allows resizing, inserting and splicing
+   without invalidating pointers to elements. Behaves the same as a hvec
+   to be a drop in replacement
+
+   Instead of allocating each element individually, the elements are
+   allocated in slabs of SVEC_SLAB_SIZE elements, freed when the svec is
+   destructed. Elements pushed one after another are next to each other
+   in memory until they are reordered by insert or splice
+   _ _ _ _ _ _ _ _
+   - - - - - - - -  Slab of elements
+   ^ ^ ^ ^
+   | | | |
+   __________
+   ---------- Handles
+   ^
+   | Index */
+
+/* Number of elements in each slab */
+#define SVEC_SLAB_SIZE 64
+
+/* Creates a svector containing values of type T
+   The members have a s_ prefix to prevent accidently using vec_ */
+#define svec_t(T__)        \
+	struct                 \
+	{                      \
+		vec_t(T__*) s_vec; \
+		vec_t(char*) s_slabs; \
+	}
+
+/* Initializes the svector, must be called before svector is used */
+#define svec_construct(v__) (vec_construct(&(v__)->s_vec), vec_construct(&(v__)->s_slabs))
+
+/* Frees memory allocated by svector, call when finished using */
+#define svec_destruct(v__) svec_destruct_(svec_unpack_(v__))
+
+/* Access specified element withOUT bounds checking */
+#define svec_at(v__, idx__) *vec_at(&(v__)->s_vec, (idx__))
+
+/* Returns the first value in the svector, do not use on empty svector */
+#define svec_front(v__) *vec_front(&(v__)->s_vec)
+
+/* Returns the last value in the svector, do not use on empty svector */
+#define svec_back(v__) *vec_back(&(v__)->s_vec)
+
+/* Returns number of elements in svector */
+#define svec_size(v__) vec_size(&(v__)->s_vec)
+
+/* Returns 1 if svector is empty, 0 if not */
+#define svec_empty(v__) vec_empty(&(v__)->s_vec)
+
+/* Reserves capacity for at least n elements in svector
+   Returns 1 if successful, 0 if error */
+#define svec_reserve(v__, n__) svec_reserve_(svec_unpack_(v__), (n__), svec_value_size_(v__))
+
+/* Clears all values from the svector, new length is 0 */
+#define svec_clear(v__) vec_clear(&(v__)->s_vec)
+
+/* Pushes uninitialized value to end of svector
+   Returns 1 if successful, 0 if error */
+#define svec_push_backu(v__) (svec_expand_(svec_unpack_(v__), svec_value_size_(v__)) ? ((v__)->s_vec.length++, 1) : 0)
+
+/* Pushes a value to the end of the svector
+   Returns 1 if successful, 0 if error */
+#define svec_push_back(v__, val__) \
+	(svec_expand_(svec_unpack_(v__), svec_value_size_(v__)) ? ((v__)->s_vec.length++, svec_back(v__) = (val__), 1) : 0)
+
+/* Removes count values starting at index start */
+#define svec_splice(v__, start__, count__) hvec_splice_((char*)&(v__)->s_vec, (start__), (count__))
+
+/* Inserts val at index shifting the elements after the index to make room
+   1 if successful, 0 if error */
+#define svec_insert(v__, val__, idx__)                                   \
+	(svec_insert_(svec_unpack_(v__), svec_value_size_(v__), (idx__))     \
+		 ? (svec_at((v__), (idx__)) = (val__), (v__)->s_vec.length++, 1) \
+		 : 0)
+
+#define svec_unpack_(v__) (char*)&(v__)->s_vec, (char*)&(v__)->s_slabs
+
+/* vec holds T__**, 1 pointer added by svec, 1 by vec */
+#define svec_value_size_(v__) sizeof(**(v__)->s_vec.data)
+
+/* The type to treat the slabs as when accessing it via a function */
+typedef vec_t(char*) svec_slabs_;
+
+void svec_destruct_(char* vec_, char* slabs_);
+
+/* Allocates storage for n elements
+   Each vec element (T__*) up to capacity is a valid pointer to memory in a
+   slab to store svec elements
+   Does not change length */
+int svec_reserve_(char* vec_, char* slabs_, int n, int elem_bytes);
+
+/* Allocates storage if necessary so an additional element can be stored */
+int svec_expand_(char* vec_, char* slabs_, int elem_bytes);
+
+/* Moves elements at and after index backwards */
+int svec_insert_(char* vec_, char* slabs_, int elem_bytes, int idx);
+
 #endif
@@ -0,0 +1,260 @@
+/* Microbenchmarks
+   Usage: bench [name of benchmark...]
+   Runs all benchmarks if none are named */
+
+#include <time.h>
+
+#include "charscan.h"
+#include "common.h"
+#include "lexer.h"
+
+/* Prevents the compiler from optimizing away benchmarked results */
+static volatile int bench_sink;
+
+/* Returns seconds of processor time since start */
+static double bench_seconds(clock_t start) {
+	return (double)(clock() - start) / CLOCKS_PER_SEC;
+}
+
+/* Prints the rate of operations for the given time */
+static void bench_report(const char* name, long ops, double seconds) {
+	printf("%-28s %12ld ops %9.4f s", name, ops, seconds);
+	if (seconds > 0) {
+		printf(" %14.0f ops/s", (double)ops / seconds);
+	}
+	printf("\n");
+}
+
+/* ============================================================ */
+/* Keyword classification */
+
+/* Mix of keywords and identifiers seen in typical source */
+static const char* bench_words[] = {
+	"int",	  "i",		  "return", "argc", "argv",	 "char", "if",		 "else",	 "while",  "for",
+	"count",  "buf",	  "len",	"void", "static", "size", "unsigned", "long",	 "struct", "node",
+	"next",	  "const",	  "result", "data", "break", "x",	  "y",		 "index",	 "double", "value",
+	"sizeof", "continue", "tmp",	"do",	"short", "ptr",  "p",		 "typedef", "extern", "error"};
+
+/* The lookup used before tok_classify, kept for comparison */
+static int bench_strbinfind_iskeyword(const char* token) {
+	const char* token_keyword[] = {
+		"_Bool",  "_Complex", "_Imaginary", "auto",		"break",  "case",	  "char",	"const",  "continue", "default",
+		"do",	  "double",	  "else",		"enum",		"extern", "float",	  "for",	"goto",	  "if",		  "inline",
+		"int",	  "long",	  "register",	"restrict", "return", "short",	  "signed", "sizeof", "static",	  "struct",
+		"switch", "typedef",  "union",		"unsigned", "void",	  "volatile", "while"};
+	return strbinfind(token, strlength(token), token_keyword, ARRAY_SIZE(token_keyword)) >= 0;
+}
+
+static void bench_keyword(void) {
+	const int words = ARRAY_SIZE(bench_words);
+	int lens[ARRAY_SIZE(bench_words)];
+	for (int i = 0; i < words; ++i) {
+		lens[i] = strlength(bench_words[i]);
+	}
+
+	const long iterations = 20000000;
+
+	clock_t start = clock();
+	int keywords = 0;
+	for (long i = 0; i < iterations; ++i) {
+		int w = (int)(i % words);
+		keywords += tok_classify(bench_words[w], lens[w]) != tk_identifier;
+	}
+	bench_report("keyword tok_classify", iterations, bench_seconds(start));
+	bench_sink = keywords;
+
+	/* Old lookup is much slower, fewer iterations */
+	const long iterations_old = iterations / 10;
+	start = clock();
+	keywords = 0;
+	for (long i = 0; i < iterations_old; ++i) {
+		keywords += bench_strbinfind_iskeyword(bench_words[i % words]);
+	}
+	bench_report("keyword strbinfind", iterations_old, bench_seconds(start));
+	bench_sink = keywords;
+}
+
+/* ============================================================ */
+/* Lexing */
+
+/* Generated source file lexed by bench_lex */
+#define BENCH_LEX_PATH      "out/bench_lex.i"
+#define BENCH_LEX_FUNCTIONS 40000
+
+/* Writes a source file of functions, indent is the indentation for each
+   level and name is the name of the main variable
+   Returns 1 if successful */
+static int bench_lex_generate(const char* indent, const char* name) {
+	FILE* f = fopen(BENCH_LEX_PATH, "w");
+	if (f == NULL) return 0;
+	for (int i = 0; i < BENCH_LEX_FUNCTIONS; ++i) {
+		const char* in = indent;
+		fprintf(f, "static unsigned long long compute_checksum_%d(const unsigned char* buffer, int length) {\n", i);
+		fprintf(f, "%sunsigned long long %s = %d;\n", in, name, i * 7919);
+		fprintf(f, "%sfor (int index = 0; index < length; ++index) {\n", in);
+		fprintf(f, "%s%s%s = %s * 31 + buffer[index];\n", in, in, name, name);
+		fprintf(f, "%s%sif (%s > 4294967296) {\n", in, in, name);
+		fprintf(f, "%s%s%s%s = %s %% 1000000007;\n", in, in, in, name, name);
+		fprintf(f, "%s%s}\n", in, in);
+		fprintf(f, "%s}\n", in);
+		fprintf(f, "%sreturn %s;\n", in, name);
+		fprintf(f, "}\n\n");
+	}
+	return fclose(f) == 0;
+}
+
+/* Lexes generated file at the given scanning level */
+static void bench_lex_level(CharscanLevel level, const char* name) {
+	charscan_set_level(level);
+	if (charscan_level() != level) {
+		printf("%-28s not supported\n", name);
+		return;
+	}
+
+	Lexer lex;
+	if (lexer_construct(&lex, BENCH_LEX_PATH) != ec_noerr) {
+		printf("%-28s failed to open %s\n", name, BENCH_LEX_PATH);
+		return;
+	}
+
+	/* Scanning the runs of blank and identifier characters alone */
+	long runs = 0;
+	clock_t start = clock();
+	for (int pos = 0; pos < lex.buf_len;) {
+		int len = charscan_blank(lex.buf + pos, lex.buf_len - pos);
+		len += charscan_identifier(lex.buf + pos + len, lex.buf_len - pos - len);
+		pos += len > 0 ? len : 1;
+		++runs;
+	}
+	char scan_name[40];
+	snprintf(scan_name, sizeof(scan_name), "%s scan", name);
+	bench_report(scan_name, runs, bench_seconds(start));
+
+	long tokens = 0;
+	start = clock();
+	while (1) {
+		const Token* token;
+		if (lexer_getc(&lex, &token) != ec_noerr) break;
+		if (token->kind == tk_eof) break;
+		lexer_consume(&lex);
+		++tokens;
+	}
+	double seconds = bench_seconds(start);
+	bench_report(name, tokens, seconds);
+	if (seconds > 0) {
+		printf("%-28s %12.2f MB/s\n", "", (double)lex.buf_len / (1024.0 * 1024.0) / seconds);
+	}
+	lexer_destruct(&lex);
+}
+
+/* Lexes generated file at each scanning level */
+static void bench_lex_levels(const char* indent, const char* name) {
+	if (!bench_lex_generate(indent, name)) {
+		printf("Failed to write %s\n", BENCH_LEX_PATH);
+		return;
+	}
+	CharscanLevel max = charscan_level_max();
+	bench_lex_level(charscan_scalar, "lex scalar");
+	bench_lex_level(charscan_sse2, "lex sse2");
+	bench_lex_level(charscan_avx2, "lex avx2");
+	charscan_set_level(max);
+	remove(BENCH_LEX_PATH);
+}
+
+static void bench_lex(void) {
+	printf("Typical indentation and identifiers\n");
+	bench_lex_levels("    ", "accumulated_value");
+	printf("Long indentation and identifiers\n");
+	bench_lex_levels("                ", "accumulated_value_of_checksum_for_buffer_contents");
+}
+
+/* ============================================================ */
+/* Stable address containers */
+
+/* Same size as Symbol */
+typedef struct
+{
+	uint64_t a;
+	uint64_t b;
+	uint64_t c;
+	uint64_t d;
+} BenchElem;
+
+#define BENCH_VEC_ELEMS 1000000
+#define BENCH_VEC_ROUNDS 10
+
+/* Benchmarks pushing, iterating, then accessing random indices of a
+   container, v__ is a hvec or svec with prefix p__ */
+#define BENCH_VEC(v__, p__, name__)                                               \
+	do {                                                                          \
+		long pushes = 0;                                                          \
+		double push_seconds = 0;                                                  \
+		long iterates = 0;                                                        \
+		double iterate_seconds = 0;                                               \
+		long ats = 0;                                                             \
+		double at_seconds = 0;                                                    \
+		uint64_t sum = 0;                                                         \
+		for (int round = 0; round < BENCH_VEC_ROUNDS; ++round) {                  \
+			p__##construct(v__);                                                  \
+			clock_t start = clock();                                              \
+			for (int i = 0; i < BENCH_VEC_ELEMS; ++i) {                           \
+				BenchElem elem = {(uint64_t)i, 0, 0, 0};                          \
+				if (!p__##push_back(v__, elem)) break;                            \
+			}                                                                     \
+			push_seconds += bench_seconds(start);                                 \
+			pushes += p__##size(v__);                                             \
+                                                                                  \
+			start = clock();                                                      \
+			for (int i = 0; i < p__##size(v__); ++i) {                            \
+				sum += (p__##at(v__, i)).a;                                       \
+			}                                                                     \
+			iterate_seconds += bench_seconds(start);                              \
+			iterates += p__##size(v__);                                           \
+                                                                                  \
+			start = clock();                                                      \
+			uint32_t index = 1;                                                   \
+			for (int i = 0; i < p__##size(v__); ++i) {                            \
+				index = index * 1664525u + 1013904223u;                           \
+				sum += (p__##at(v__, (int)(index % (uint32_t)p__##size(v__)))).a; \
+			}                                                                     \
+			at_seconds += bench_seconds(start);                                   \
+			ats += p__##size(v__);                                                \
+			p__##destruct(v__);                                                   \
+		}                                                                         \
+		bench_report(name__ " push", pushes, push_seconds);                       \
+		bench_report(name__ " iterate", iterates, iterate_seconds);               \
+		bench_report(name__ " random at", ats, at_seconds);                       \
+		bench_sink = (int)sum;                                                    \
+	} while (0)
+
+static void bench_vec(void) {
+	hvec_t(BenchElem) hvec;
+	BENCH_VEC(&hvec, hvec_, "hvec");
+	svec_t(BenchElem) svec;
+	BENCH_VEC(&svec, svec_, "svec");
+}
+
+/* ============================================================ */
+
+typedef struct
+{
+	const char* name;
+	void (*func)(void);
+} Benchmark;
+
+static const Benchmark benchmarks[] = {
+	{"keyword", bench_keyword},
+	{"lex", bench_lex},
+	{"vec", bench_vec},
+};
+
+int main(int argc, char** argv) {
+	for (int i = 0; i < ARRAY_SIZE(benchmarks); ++i) {
+		int run = argc <= 1;
+		for (int j = 1; j < argc; ++j) {
+			if (strequ(argv[j], benchmarks[i].name)) run = 1;
+		}
+		if (run) benchmarks[i].func();
+	}
+	return 0;
+}
@@ -1,6 +1,7 @@
 #include "CuTest.h"
 
 #include "cfg.h"
+#include "symtab.h"
 
 static void CreateNewBlock(CuTest* tc) {
 	Cfg cfg;
@@ -14,8 +15,130 @@ static void CreateNewBlock(CuTest* tc) {
 	cfg_destruct(&cfg);
 }
 
+/* Blocks begin at labels and after jumps and returns, linked to the
+   blocks control can flow to */
+static void PartitionBlocks(CuTest* tc) {
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+
+	Symbol* t;
+	Symbol* l0;
+	Symbol* l1;
+	Symbol* l2;
+	CuAssertIntEquals(tc, symtab_add_temporary(&stab, &t, symtab_type_int(&stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l0), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l1), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l2), ec_noerr);
+	Symbol* zero = symtab_constant_zero(&stab);
+	Symbol* one = symtab_constant_one(&stab);
+
+	Cfg cfg;
+	CuAssertIntEquals(tc, cfg_construct(&cfg), ec_noerr);
+	Block* blk;
+	CuAssertIntEquals(tc, cfg_new_block(&cfg, &blk), ec_noerr);
+
+	IL2Statement stats[] = {
+		il2stat_make2(il2_mov, t, zero),
+		il2stat_make2(il2_jz, l1, t),
+		il2stat_make(il2_add, t, t, one),
+		il2stat_make1(il2_jmp, l2),
+		il2stat_make1(il2_lab, l1),
+		il2stat_make1(il2_lab, l0),
+		il2stat_make2(il2_jnz, l0, t),
+		il2stat_make1(il2_lab, l2),
+		il2stat_make1(il2_ret, t),
+	};
+	for (int i = 0; i < (int)(sizeof(stats) / sizeof(stats[0])); ++i) {
+		CuAssertIntEquals(tc, block_add_ilstat(blk, stats[i]), ec_noerr);
+	}
+
+	CuAssertIntEquals(tc, cfg_partition(&cfg), ec_noerr);
+
+	/* 0: mov, jz     -> 1 2
+	   1: add, jmp    -> 3
+	   2: l1 l0: jnz  -> 3 2
+	   3: l2: ret */
+	CuAssertIntEquals(tc, 4, vec_size(&cfg.blocks));
+	Block* b = vec_data(&cfg.blocks);
+	int stat_counts[] = {2, 2, 1, 1};
+	int lab_counts[] = {0, 0, 2, 1};
+	for (int i = 0; i < 4; ++i) {
+		CuAssertIntEquals(tc, stat_counts[i], block_ilstat_count(&b[i]));
+		CuAssertIntEquals(tc, lab_counts[i], block_lab_count(&b[i]));
+	}
+	CuAssertIntEquals(tc, il2_jz, il2stat_ins(block_ilstat(&b[0], 1)));
+	CuAssertIntEquals(tc, il2_jnz, il2stat_ins(block_ilstat(&b[2], 0)));
+	CuAssertPtrEquals(tc, l1, block_lab(&b[2], 0));
+	CuAssertPtrEquals(tc, l0, block_lab(&b[2], 1));
+
+	CuAssertIntEquals(tc, 2, block_next_count(&b[0]));
+	CuAssertPtrEquals(tc, &b[1], block_next(&b[0], 0));
+	CuAssertPtrEquals(tc, &b[2], block_next(&b[0], 1));
+	CuAssertIntEquals(tc, 1, block_next_count(&b[1]));
+	CuAssertPtrEquals(tc, &b[3], block_next(&b[1], 0));
+	CuAssertIntEquals(tc, 2, block_next_count(&b[2]));
+	CuAssertPtrEquals(tc, &b[3], block_next(&b[2], 0));
+	CuAssertPtrEquals(tc, &b[2], block_next(&b[2], 1));
+	CuAssertIntEquals(tc, 0, block_next_count(&b[3]));
+
+	CuAssertPtrEquals(tc, &b[2], cfg_find_labelled(&cfg, l0));
+	CuAssertPtrEquals(tc, &b[2], cfg_find_labelled(&cfg, l1));
+	CuAssertPtrEquals(tc, &b[3], cfg_find_labelled(&cfg, l2));
+	CuAssertPtrEquals(tc, NULL, cfg_find_labelled(&cfg, t));
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* Functions partitioned one after another into the same cfg, the last
+   block of the first function does not end in a return and is not linked
+   to the first block of the second
+   0: mov, jz l0  -> 1
+   1: l0: mov
+   2: ret */
+static void PartitionFunctions(CuTest* tc) {
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+
+	Symbol* t;
+	Symbol* l0;
+	CuAssertIntEquals(tc, symtab_add_temporary(&stab, &t, symtab_type_int(&stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l0), ec_noerr);
+	Symbol* zero = symtab_constant_zero(&stab);
+
+	Cfg cfg;
+	CuAssertIntEquals(tc, cfg_construct(&cfg), ec_noerr);
+	Block* blk;
+	CuAssertIntEquals(tc, cfg_new_block(&cfg, &blk), ec_noerr);
+	CuAssertIntEquals(tc, block_add_ilstat(blk, il2stat_make2(il2_mov, t, zero)), ec_noerr);
+	CuAssertIntEquals(tc, block_add_ilstat(blk, il2stat_make2(il2_jz, l0, t)), ec_noerr);
+	CuAssertIntEquals(tc, block_add_ilstat(blk, il2stat_make1(il2_lab, l0)), ec_noerr);
+	CuAssertIntEquals(tc, block_add_ilstat(blk, il2stat_make2(il2_mov, t, t)), ec_noerr);
+	CuAssertIntEquals(tc, cfg_partition(&cfg), ec_noerr);
+
+	CuAssertIntEquals(tc, cfg_new_block(&cfg, &blk), ec_noerr);
+	CuAssertIntEquals(tc, block_add_ilstat(blk, il2stat_make1(il2_ret, t)), ec_noerr);
+	CuAssertIntEquals(tc, cfg_partition(&cfg), ec_noerr);
+
+	CuAssertIntEquals(tc, 3, vec_size(&cfg.blocks));
+	Block* b = vec_data(&cfg.blocks);
+	CuAssertIntEquals(tc, 1, block_next_count(&b[0]));
+	CuAssertPtrEquals(tc, &b[1], block_next(&b[0], 0));
+	CuAssertIntEquals(tc, 0, block_next_count(&b[1]));
+	CuAssertIntEquals(tc, 0, block_next_count(&b[2]));
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
 CuSuite* CfgGetSuite() {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, CreateNewBlock);
+	SUITE_ADD_TEST(suite, PartitionBlocks);
+	SUITE_ADD_TEST(suite, PartitionFunctions);
 	return suite;
 }
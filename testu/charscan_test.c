@@ -0,0 +1,60 @@
+#include "CuTest.h"
+
+#include "charscan.h"
+#include "common.h"
+
+static void CharscanClass(CuTest* tc) {
+	for (int i = 0; i < 256; ++i) {
+		char c = (char)i;
+		int identifier = ('a' <= c && c <= 'z') || ('A' <= c && c <= 'Z') || ('0' <= c && c <= '9') || c == '_';
+		int blank = c == ' ' || c == '\t';
+		int whitespace = blank || c == '\n';
+
+		uint8_t cls = charscan_class[i];
+		CuAssertIntEquals(tc, identifier, (cls & CHARSCAN_IDENTIFIER) != 0);
+		CuAssertIntEquals(tc, blank, (cls & CHARSCAN_BLANK) != 0);
+		CuAssertIntEquals(tc, whitespace, (cls & CHARSCAN_WHITESPACE) != 0);
+	}
+	CuAssertTrue(tc, charscan_class['#'] & CHARSCAN_PUNCTUATOR);
+	CuAssertTrue(tc, charscan_class['~'] & CHARSCAN_PUNCTUATOR);
+	CuAssertIntEquals(tc, 0, charscan_class['"']);
+	CuAssertIntEquals(tc, 0, charscan_class[200]);
+}
+
+/* Every level gives the same result as scalar for runs ending
+   at every position within the vector width */
+static void CharscanLevels(CuTest* tc) {
+	/* Characters just outside the ranges checked with comparisons */
+	const char stops[] = {'@', '[', '`', '{', '/', ':', '\n', '\r', '\xff', '\x80', '\0', '-'};
+
+	char buf[100];
+	for (int level = charscan_scalar; level <= (int)charscan_level_max(); ++level) {
+		charscan_set_level((CharscanLevel)level);
+		CuAssertIntEquals(tc, level, (int)charscan_level());
+
+		for (int run = 0; run < 70; ++run) {
+			for (int s = 0; s < ARRAY_SIZE(stops); ++s) {
+				for (int i = 0; i < run; ++i) {
+					buf[i] = "azAZ09_x"[i % 7];
+				}
+				buf[run] = stops[s];
+				CuAssertIntEquals(tc, run, charscan_identifier(buf, ARRAY_SIZE(buf)));
+
+				for (int i = 0; i < run; ++i) {
+					buf[i] = i % 3 == 0 ? '\t' : ' ';
+				}
+				CuAssertIntEquals(tc, run, charscan_blank(buf, ARRAY_SIZE(buf)));
+			}
+			/* Reads at most len characters */
+			CuAssertIntEquals(tc, run / 2, charscan_blank(buf, run / 2));
+		}
+	}
+	charscan_set_level(charscan_level_max());
+}
+
+CuSuite* CharscanGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, CharscanClass);
+	SUITE_ADD_TEST(suite, CharscanLevels);
+	return suite;
+}
@@ -0,0 +1,198 @@
+#include "CuTest.h"
+
+#include "cfg.h"
+#include "common.h"
+#include "copyprop.h"
+#include "ssa.h"
+#include "symtab.h"
+
+/* Makes symbol table with function scope for the labels */
+static void MakeSymtab(CuTest* tc, Symtab* stab) {
+	CuAssertIntEquals(tc, symtab_construct(stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(stab), ec_noerr);
+}
+
+/* Returns variable of type ts */
+static Symbol* Variable(CuTest* tc, Symtab* stab, const char* token, TypeSpecifiers ts) {
+	Type type;
+	CuAssertIntEquals(tc, type_construct(&type, ts, 0), ec_noerr);
+	Symbol* sym;
+	CuAssertIntEquals(tc, symtab_add(stab, &sym, token, &type), ec_noerr);
+	type_destruct(&type);
+	symbol_set_valcat(sym, vc_lval);
+	return sym;
+}
+
+/* Returns temporary of type ts */
+static Symbol* Temporary(CuTest* tc, Symtab* stab, const char* token, TypeSpecifiers ts) {
+	Symbol* sym = Variable(tc, stab, token, ts);
+	symbol_set_valcat(sym, vc_nlval);
+	return sym;
+}
+
+/* Partitions the statements into blocks of the cfg, then propagates
+   the copies */
+static void Propagate(CuTest* tc, Cfg* cfg, IL2Statement* stats, int count) {
+	CuAssertIntEquals(tc, cfg_construct(cfg), ec_noerr);
+	Block* blk;
+	CuAssertIntEquals(tc, cfg_new_block(cfg, &blk), ec_noerr);
+	for (int i = 0; i < count; ++i) {
+		CuAssertIntEquals(tc, block_add_ilstat(blk, stats[i]), ec_noerr);
+	}
+	CuAssertIntEquals(tc, cfg_partition(cfg), ec_noerr);
+
+	Ssa ssa;
+	CuAssertIntEquals(tc, ssa_construct(&ssa), ec_noerr);
+	CopyProp cp;
+	CuAssertIntEquals(tc, copyprop_construct(&cp), ec_noerr);
+	CuAssertIntEquals(tc, ssa_convert(&ssa, cfg), ec_noerr);
+	CuAssertIntEquals(tc, copyprop_run(&cp, &ssa), ec_noerr);
+	ssa_revert(&ssa);
+	copyprop_destruct(&cp);
+	ssa_destruct(&ssa);
+}
+
+/* Asserts statement at index i of block has the instruction and
+   arguments */
+static void AssertStat(CuTest* tc, Block* blk, int i, IL2Ins ins, Symbol* a0, Symbol* a1, Symbol* a2) {
+	IL2Statement* stat = block_ilstat(blk, i);
+	CuAssertIntEquals(tc, ins, il2stat_ins(stat));
+	CuAssertPtrEquals(tc, a0, il2stat_arg(stat, 0));
+	if (a1 != NULL) CuAssertPtrEquals(tc, a1, il2stat_arg(stat, 1));
+	if (a2 != NULL) CuAssertPtrEquals(tc, a2, il2stat_arg(stat, 2));
+}
+
+/* The temporaries copying a temporary are replaced by it, and the mov
+   out of the last temporary assigns the variable in its place
+   add t1, a, b; mov t2, t1; mtc t3, t2; mov x, t3; ret x
+   -> add x, a, b; ret x */
+static void MergeCopies(CuTest* tc) {
+	Symtab stab;
+	MakeSymtab(tc, &stab);
+	Symbol* a = Variable(tc, &stab, "a", ts_int);
+	Symbol* b = Variable(tc, &stab, "b", ts_int);
+	Symbol* x = Variable(tc, &stab, "x", ts_long);
+	Symbol* t1 = Temporary(tc, &stab, "t1", ts_int);
+	Symbol* t2 = Temporary(tc, &stab, "t2", ts_int);
+	Symbol* t3 = Temporary(tc, &stab, "t3", ts_long);
+
+	IL2Statement stats[] = {
+		il2stat_make(il2_add, t1, a, b),
+		il2stat_make2(il2_mov, t2, t1),
+		il2stat_make2(il2_mtc, t3, t2),
+		il2stat_make2(il2_mov, x, t3),
+		il2stat_make1(il2_ret, x),
+	};
+	Cfg cfg;
+	Propagate(tc, &cfg, stats, ARRAY_SIZE(stats));
+
+	Block* blk = &vec_at(&cfg.blocks, 0);
+	CuAssertIntEquals(tc, 2, block_ilstat_count(blk));
+	AssertStat(tc, blk, 0, il2_add, x, a, b);
+	AssertStat(tc, blk, 1, il2_ret, x, NULL, NULL);
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* Conversions which change the representation are kept, temporaries
+   not read are removed unless computing them can fault, and a variable
+   is not assigned earlier past memory accesses
+   0: add t1, a, b
+   1: mtc t2, t1      char, kept
+   2: mul t3, a, a    not read, removed
+   3: div t4, a, b    not read, may divide by zero
+   4: mti p, t2
+   5: mov x, t1       not merged past mti, p may point to x
+   6: ret x */
+static void KeepUnsafe(CuTest* tc) {
+	Symtab stab;
+	MakeSymtab(tc, &stab);
+	Symbol* a = Variable(tc, &stab, "a", ts_int);
+	Symbol* b = Variable(tc, &stab, "b", ts_int);
+	Symbol* x = Variable(tc, &stab, "x", ts_int);
+	Type type;
+	CuAssertIntEquals(tc, type_construct(&type, ts_char, 1), ec_noerr);
+	Symbol* p;
+	CuAssertIntEquals(tc, symtab_add(&stab, &p, "p", &type), ec_noerr);
+	type_destruct(&type);
+	Symbol* t1 = Temporary(tc, &stab, "t1", ts_int);
+	Symbol* t2 = Temporary(tc, &stab, "t2", ts_char);
+	Symbol* t3 = Temporary(tc, &stab, "t3", ts_int);
+	Symbol* t4 = Temporary(tc, &stab, "t4", ts_int);
+
+	IL2Statement stats[] = {
+		il2stat_make(il2_add, t1, a, b),
+		il2stat_make2(il2_mtc, t2, t1),
+		il2stat_make(il2_mul, t3, a, a),
+		il2stat_make(il2_div, t4, a, b),
+		il2stat_make2(il2_mti, p, t2),
+		il2stat_make2(il2_mov, x, t1),
+		il2stat_make1(il2_ret, x),
+	};
+	Cfg cfg;
+	Propagate(tc, &cfg, stats, ARRAY_SIZE(stats));
+
+	Block* blk = &vec_at(&cfg.blocks, 0);
+	CuAssertIntEquals(tc, 6, block_ilstat_count(blk));
+	AssertStat(tc, blk, 0, il2_add, t1, a, b);
+	AssertStat(tc, blk, 1, il2_mtc, t2, t1, NULL);
+	AssertStat(tc, blk, 2, il2_div, t4, a, b);
+	AssertStat(tc, blk, 3, il2_mti, p, t2, NULL);
+	AssertStat(tc, blk, 4, il2_mov, x, t1, NULL);
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* A temporary assigned in each arm of a conditional is merged at the
+   join, the copy out of it is not propagated as the temporary has more
+   than one assignment
+   0: jz l1, a        -> 2
+   1: mov t1, a; jmp l2
+   2: l1: mov t1, b
+   3: l2: mov t2, t1; ret t2 */
+static void KeepMerged(CuTest* tc) {
+	Symtab stab;
+	MakeSymtab(tc, &stab);
+	Symbol* a = Variable(tc, &stab, "a", ts_int);
+	Symbol* b = Variable(tc, &stab, "b", ts_int);
+	Symbol* t1 = Temporary(tc, &stab, "t1", ts_int);
+	Symbol* t2 = Temporary(tc, &stab, "t2", ts_int);
+	Symbol* l1;
+	Symbol* l2;
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l1), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l2), ec_noerr);
+
+	IL2Statement stats[] = {
+		il2stat_make2(il2_jz, l1, a),
+		il2stat_make2(il2_mov, t1, a),
+		il2stat_make1(il2_jmp, l2),
+		il2stat_make1(il2_lab, l1),
+		il2stat_make2(il2_mov, t1, b),
+		il2stat_make1(il2_lab, l2),
+		il2stat_make2(il2_mov, t2, t1),
+		il2stat_make1(il2_ret, t2),
+	};
+	Cfg cfg;
+	Propagate(tc, &cfg, stats, ARRAY_SIZE(stats));
+	Block* blk = vec_data(&cfg.blocks);
+
+	AssertStat(tc, &blk[1], 0, il2_mov, t1, a, NULL);
+	AssertStat(tc, &blk[2], 0, il2_mov, t1, b, NULL);
+	CuAssertIntEquals(tc, 2, block_ilstat_count(&blk[3]));
+	AssertStat(tc, &blk[3], 0, il2_mov, t2, t1, NULL);
+	AssertStat(tc, &blk[3], 1, il2_ret, t2, NULL, NULL);
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+CuSuite* CopyPropGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, MergeCopies);
+	SUITE_ADD_TEST(suite, KeepUnsafe);
+	SUITE_ADD_TEST(suite, KeepMerged);
+	return suite;
+}
@@ -0,0 +1,91 @@
+#include "CuTest.h"
+
+#include "flattree.h"
+
+static void FlattenChildrenAdjacent(CuTest* tc) {
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+
+	/* root
+	   ├ n1
+	   | ├ n1_1
+	   | └ n1_2
+	   └ n2
+		 └ n2_1 */
+	TNode* n1;
+	tnode_alloca(&tree, &n1, tree_root(&tree));
+	TNode* n2;
+	tnode_alloca(&tree, &n2, tree_root(&tree));
+	TNode* n1_1;
+	tnode_alloca(&tree, &n1_1, n1);
+	TNode* n1_2;
+	tnode_alloca(&tree, &n1_2, n1);
+	TNode* n2_1;
+	tnode_alloca(&tree, &n2_1, n2);
+
+	TNodeJumpStatement data;
+	data.type = TNodeJumpStatement_break;
+	tnode_set(n1_2, tt_jump_statement, &data);
+	tnode_set(n2, tt_compound_statement, NULL);
+
+	FlatTree ftree;
+	CuAssertIntEquals(tc, flat_tree_construct(&ftree, &tree), ec_noerr);
+	tree_destruct(&tree);
+
+	CuAssertIntEquals(tc, 6, flat_tree_size(&ftree));
+
+	FNodeId root = flat_tree_root(&ftree);
+	CuAssertIntEquals(tc, tt_root, fnode_type(&ftree, root));
+	CuAssertIntEquals(tc, 2, fnode_count_child(&ftree, root));
+
+	FNodeId f1 = fnode_child(&ftree, root, 0);
+	FNodeId f2 = fnode_child(&ftree, root, 1);
+	CuAssertIntEquals(tc, f1 + 1, f2);
+	CuAssertIntEquals(tc, f2, fnode_child(&ftree, root, -1));
+	CuAssertIntEquals(tc, 2, fnode_count_child(&ftree, f1));
+	CuAssertIntEquals(tc, tt_compound_statement, fnode_type(&ftree, f2));
+	CuAssertIntEquals(tc, 1, fnode_count_child(&ftree, f2));
+
+	FNodeId f1_2 = fnode_child(&ftree, f1, 1);
+	CuAssertIntEquals(tc, tt_jump_statement, fnode_type(&ftree, f1_2));
+	CuAssertIntEquals(tc, TNodeJumpStatement_break, ((TNodeJumpStatement*)fnode_data(&ftree, f1_2))->type);
+	CuAssertIntEquals(tc, 0, fnode_count_child(&ftree, f1_2));
+
+	flat_tree_destruct(&ftree);
+}
+
+static void FlattenDeepTree(CuTest* tc) {
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+
+	/* Deeper than the call stack would allow if flattened recursively */
+	const int depth = 1000000;
+	TNode* node = tree_root(&tree);
+	for (int i = 0; i < depth; ++i) {
+		TNode* child;
+		CuAssertIntEquals(tc, tnode_alloca(&tree, &child, node), ec_noerr);
+		node = child;
+	}
+
+	FlatTree ftree;
+	CuAssertIntEquals(tc, flat_tree_construct(&ftree, &tree), ec_noerr);
+	tree_destruct(&tree);
+
+	CuAssertIntEquals(tc, depth + 1, flat_tree_size(&ftree));
+	FNodeId id = flat_tree_root(&ftree);
+	int count = 0;
+	while (fnode_count_child(&ftree, id) != 0) {
+		id = fnode_child(&ftree, id, 0);
+		++count;
+	}
+	CuAssertIntEquals(tc, depth, count);
+
+	flat_tree_destruct(&ftree);
+}
+
+CuSuite* FlatTreeGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, FlattenChildrenAdjacent);
+	SUITE_ADD_TEST(suite, FlattenDeepTree);
+	return suite;
+}
@@ -0,0 +1,445 @@
+#include "CuTest.h"
+
+#include <stdlib.h>
+#include <string.h>
+
+#include "copyprop.h"
+#include "il2gen.h"
+#include "parser.h"
+#include "ssa.h"
+
+/* Adds a function definition to the root of the tree, returns its
+   compound statement
+   root
+   └ function_definition
+	 ├ 4 nodes unused by IL2 generation
+	 └ compound_statement */
+static TNode* FunctionBody(CuTest* tc, Tree* tree) {
+	TNode* function;
+	CuAssertIntEquals(tc, tnode_alloca(tree, &function, tree_root(tree)), ec_noerr);
+	tnode_set(function, tt_function_definition, NULL);
+	for (int i = 0; i < 4; ++i) {
+		TNode* unused;
+		CuAssertIntEquals(tc, tnode_alloca(tree, &unused, function), ec_noerr);
+	}
+	TNode* body;
+	CuAssertIntEquals(tc, tnode_alloca(tree, &body, function), ec_noerr);
+	tnode_set(body, tt_compound_statement, NULL);
+	return body;
+}
+
+/* Expression a = a = ... = a with 100000 terms, each assignment is the
+   right operand of the one before it. Would overflow the call stack if
+   generated recursively */
+static void GenerateDeepExpression(CuTest* tc) {
+	const int terms = 100000;
+
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+
+	Symbol* a;
+	CuAssertIntEquals(tc, symtab_add(&stab, &a, "a", symtab_type_int(&stab)), ec_noerr);
+
+	/* compound_statement
+	   └ assignment_expression
+		 ├ identifier(a)
+		 └ assignment_expression ... */
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+	TNode* node = FunctionBody(tc, &tree);
+
+	TNodeIdentifier identifier;
+	identifier.symbol = a;
+	TNodeAssignmentExpression assign;
+	assign.type = TNodeAssignmentExpression_assign;
+	for (int i = 0; i < terms - 1; ++i) {
+		TNode* assign_node;
+		CuAssertIntEquals(tc, tnode_alloca(&tree, &assign_node, node), ec_noerr);
+		tnode_set(assign_node, tt_assignment_expression, &assign);
+
+		TNode* lhs;
+		CuAssertIntEquals(tc, tnode_alloca(&tree, &lhs, assign_node), ec_noerr);
+		tnode_set(lhs, tt_identifier, &identifier);
+		node = assign_node;
+	}
+	TNode* last;
+	CuAssertIntEquals(tc, tnode_alloca(&tree, &last, node), ec_noerr);
+	tnode_set(last, tt_identifier, &identifier);
+
+	FlatTree ftree;
+	CuAssertIntEquals(tc, flat_tree_construct(&ftree, &tree), ec_noerr);
+	tree_destruct(&tree);
+
+	Cfg cfg;
+	CuAssertIntEquals(tc, cfg_construct(&cfg), ec_noerr);
+	IL2Gen il2;
+	CuAssertIntEquals(tc, il2_construct(&il2, &cfg, &stab, &ftree), ec_noerr);
+	CuAssertIntEquals(tc, il2_gen(&il2), ec_noerr);
+
+	/* One mov for each assignment */
+	CuAssertIntEquals(tc, 1, vec_size(&cfg.blocks));
+	Block* blk = &vec_at(&cfg.blocks, 0);
+	CuAssertIntEquals(tc, terms - 1, block_ilstat_count(blk));
+	for (int i = 0; i < block_ilstat_count(blk); ++i) {
+		IL2Statement* stat = block_ilstat(blk, i);
+		CuAssertIntEquals(tc, il2_mov, il2stat_ins(stat));
+		CuAssertPtrEquals(tc, a, il2stat_arg(stat, 0));
+		CuAssertPtrEquals(tc, a, il2stat_arg(stat, 1));
+	}
+
+	il2_destruct(&il2);
+	cfg_destruct(&cfg);
+	flat_tree_destruct(&ftree);
+	symtab_destruct(&stab);
+}
+
+/* Expression a + a + ... + a with 100000 terms, each addition is the
+   left operand of the one after it as parsed. Would overflow the call
+   stack if generated recursively */
+static void GenerateDeepSum(CuTest* tc) {
+	const int terms = 100000;
+
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+
+	Symbol* a;
+	CuAssertIntEquals(tc, symtab_add(&stab, &a, "a", symtab_type_int(&stab)), ec_noerr);
+
+	/* compound_statement
+	   └ binary_expression(+)
+		 ├ binary_expression(+) ...
+		 └ identifier(a) */
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+	TNode* node = FunctionBody(tc, &tree);
+
+	TNodeIdentifier identifier;
+	identifier.symbol = a;
+	TNodeBinaryExpression add;
+	add.type = TNodeBinaryExpression_add;
+
+	/* The right operands are added once the left operand of each
+	   addition is in place */
+	TNode** adds = malloc((size_t)(terms - 1) * sizeof(TNode*));
+	CuAssertPtrNotNull(tc, adds);
+	for (int i = 0; i < terms - 1; ++i) {
+		CuAssertIntEquals(tc, tnode_alloca(&tree, &adds[i], node), ec_noerr);
+		tnode_set(adds[i], tt_binary_expression, &add);
+		node = adds[i];
+	}
+	TNode* first;
+	CuAssertIntEquals(tc, tnode_alloca(&tree, &first, node), ec_noerr);
+	tnode_set(first, tt_identifier, &identifier);
+	for (int i = 0; i < terms - 1; ++i) {
+		TNode* rhs;
+		CuAssertIntEquals(tc, tnode_alloca(&tree, &rhs, adds[i]), ec_noerr);
+		tnode_set(rhs, tt_identifier, &identifier);
+	}
+	free(adds);
+
+	FlatTree ftree;
+	CuAssertIntEquals(tc, flat_tree_construct(&ftree, &tree), ec_noerr);
+	tree_destruct(&tree);
+
+	Cfg cfg;
+	CuAssertIntEquals(tc, cfg_construct(&cfg), ec_noerr);
+	IL2Gen il2;
+	CuAssertIntEquals(tc, il2_construct(&il2, &cfg, &stab, &ftree), ec_noerr);
+	CuAssertIntEquals(tc, il2_gen(&il2), ec_noerr);
+
+	/* One add for each addition, innermost first, each adding a to the
+	   sum before it */
+	CuAssertIntEquals(tc, 1, vec_size(&cfg.blocks));
+	Block* blk = &vec_at(&cfg.blocks, 0);
+	CuAssertIntEquals(tc, terms - 1, block_ilstat_count(blk));
+	Symbol* sum = a;
+	for (int i = 0; i < block_ilstat_count(blk); ++i) {
+		IL2Statement* stat = block_ilstat(blk, i);
+		CuAssertIntEquals(tc, il2_add, il2stat_ins(stat));
+		CuAssertPtrEquals(tc, sum, il2stat_arg(stat, 1));
+		CuAssertPtrEquals(tc, a, il2stat_arg(stat, 2));
+		sum = il2stat_arg(stat, 0);
+	}
+
+	il2_destruct(&il2);
+	cfg_destruct(&cfg);
+	flat_tree_destruct(&ftree);
+	symtab_destruct(&stab);
+}
+
+/* 10000 functions generated one at a time, the memory used by the tree,
+   cfg and symbols of a function is reused by the functions after it */
+static void GenerateFunctionsFlatMemory(CuTest* tc) {
+	const int functions = 10000;
+
+	FILE* rf = tmpfile();
+	CuAssertPtrNotNull(tc, rf);
+	for (int i = 0; i < functions; ++i) {
+		fprintf(rf,
+				"int f%d(int argc, char** argv) {\n"
+				"    int a = argc;\n"
+				"    while (a < %d) { a = a * 2 + 1; }\n"
+				"    return a;\n"
+				"}\n",
+				i, i);
+	}
+	rewind(rf);
+	FILE* wf = tmpfile();
+	CuAssertPtrNotNull(tc, wf);
+
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct_stream(&lex, rf), ec_noerr);
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+	Parser p;
+	CuAssertIntEquals(tc, parser_construct(&p, &lex, &stab, &tree), ec_noerr);
+	Cfg cfg;
+	CuAssertIntEquals(tc, cfg_construct(&cfg), ec_noerr);
+
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+
+	size_t tree_bytes = 0;
+	int cfg_capacity = 0;
+	for (int i = 0; i < functions; ++i) {
+		SymtabMark mark = symtab_mark(&stab);
+
+		int parsed;
+		CuAssertIntEquals(tc, parse_next_external_declaration(&p, &parsed), ec_noerr);
+		CuAssertIntEquals(tc, 1, parsed);
+
+		FlatTree ftree;
+		CuAssertIntEquals(tc, flat_tree_construct(&ftree, &tree), ec_noerr);
+		IL2Gen il2;
+		CuAssertIntEquals(tc, il2_construct(&il2, &cfg, &stab, &ftree), ec_noerr);
+		CuAssertIntEquals(tc, il2_gen(&il2), ec_noerr);
+		CuAssertIntEquals(tc, il2_write_function(&il2, wf, mark.symbol), ec_noerr);
+		il2_destruct(&il2);
+		flat_tree_destruct(&ftree);
+
+		tree_clear(&tree);
+		cfg_clear(&cfg);
+		symtab_release(&stab, mark);
+
+		if (i == 0) {
+			tree_bytes = tree.arena.bytes_reserved;
+			cfg_capacity = cfg.blocks.capacity;
+		}
+		CuAssertTrue(tc, tree_bytes == tree.arena.bytes_reserved);
+		CuAssertIntEquals(tc, cfg_capacity, cfg.blocks.capacity);
+		/* Only the symbols of the functions are kept */
+		CuAssertIntEquals(tc, i + 1, svec_size(&stab.symbol));
+	}
+
+	int parsed;
+	CuAssertIntEquals(tc, parse_next_external_declaration(&p, &parsed), ec_noerr);
+	CuAssertIntEquals(tc, 0, parsed);
+	symtab_pop_scope(&stab);
+
+	/* Storage of released symbols is reused, only grown for the kept
+	   function symbols */
+	CuAssertTrue(tc, stab.symbol.s_vec.capacity <= 2 * (functions + SVEC_SLAB_SIZE));
+
+	cfg_destruct(&cfg);
+	tree_destruct(&tree);
+	symtab_destruct(&stab);
+	lexer_destruct(&lex);
+	fclose(wf);
+	fclose(rf);
+}
+
+/* Generates the IL2 for the function in source, converts it to SSA form
+   and propagates its copies if optimize is 1, then writes it into text */
+static void WriteFunction(CuTest* tc, const char* source, int optimize, char* text, size_t size) {
+	FILE* rf = tmpfile();
+	CuAssertPtrNotNull(tc, rf);
+	fprintf(rf, "%s", source);
+	rewind(rf);
+	FILE* wf = tmpfile();
+	CuAssertPtrNotNull(tc, wf);
+
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct_stream(&lex, rf), ec_noerr);
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+	Parser p;
+	CuAssertIntEquals(tc, parser_construct(&p, &lex, &stab, &tree), ec_noerr);
+	Cfg cfg;
+	CuAssertIntEquals(tc, cfg_construct(&cfg), ec_noerr);
+
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	SymtabMark mark = symtab_mark(&stab);
+	int parsed;
+	CuAssertIntEquals(tc, parse_next_external_declaration(&p, &parsed), ec_noerr);
+	CuAssertIntEquals(tc, 1, parsed);
+
+	FlatTree ftree;
+	CuAssertIntEquals(tc, flat_tree_construct(&ftree, &tree), ec_noerr);
+	IL2Gen il2;
+	CuAssertIntEquals(tc, il2_construct(&il2, &cfg, &stab, &ftree), ec_noerr);
+	CuAssertIntEquals(tc, il2_gen(&il2), ec_noerr);
+
+	if (optimize) {
+		Ssa ssa;
+		CuAssertIntEquals(tc, ssa_construct(&ssa), ec_noerr);
+		CopyProp cp;
+		CuAssertIntEquals(tc, copyprop_construct(&cp), ec_noerr);
+		CuAssertIntEquals(tc, ssa_convert(&ssa, &cfg), ec_noerr);
+		CuAssertIntEquals(tc, copyprop_run(&cp, &ssa), ec_noerr);
+		ssa_revert(&ssa);
+		copyprop_destruct(&cp);
+		ssa_destruct(&ssa);
+	}
+
+	CuAssertIntEquals(tc, il2_write_function(&il2, wf, mark.symbol), ec_noerr);
+	il2_destruct(&il2);
+	flat_tree_destruct(&ftree);
+
+	rewind(wf);
+	size_t len = fread(text, 1, size - 1, wf);
+	CuAssertTrue(tc, len < size - 1);
+	text[len] = '\0';
+
+	symtab_pop_scope(&stab);
+	cfg_destruct(&cfg);
+	tree_destruct(&tree);
+	symtab_destruct(&stab);
+	lexer_destruct(&lex);
+	fclose(wf);
+	fclose(rf);
+}
+
+/* Copies the symbol name at the start of str, up to a ',' or newline,
+   into name */
+static void SymbolName(CuTest* tc, const char* str, char* name, size_t size) {
+	size_t len = strcspn(str, ",\n");
+	CuAssertTrue(tc, len < size);
+	memcpy(name, str, len);
+	name[len] = '\0';
+}
+
+/* Returns 1 if name is an argument of a statement in the IL2 text, after
+   its defs, 0 otherwise */
+static int IsReferenced(const char* text, const char* name) {
+	const char* stats = strchr(text, '\n') + 1;
+	while (strncmp(stats, "def ", 4) == 0) stats = strchr(stats, '\n') + 1;
+
+	size_t len = strlen(name);
+	for (const char* use = strstr(stats, name); use != NULL; use = strstr(use + 1, name)) {
+		if (use[len] == ',' || use[len] == '\n') return 1;
+	}
+	return 0;
+}
+
+/* Returns 1 if the IL2 text has a def for name, 0 otherwise */
+static int IsDefined(const char* text, const char* name) {
+	size_t len = strlen(name);
+	for (const char* line = strstr(text, "\ndef "); line != NULL; line = strstr(line + 1, "\ndef ")) {
+		const char* def_name = strchr(line + 5, ' ') + 1;
+		if (strncmp(def_name, name, len) == 0 && def_name[len] == '\n') return 1;
+	}
+	return 0;
+}
+
+/* Temporaries whose statements were all removed by copy propagation
+   are not defined in the written IL2 */
+static void WriteReferencedDefs(CuTest* tc) {
+	char text[4096];
+	WriteFunction(tc,
+			"int f(int argc, char** argv) {\n"
+			"    int a = argc + 1;\n"
+			"    long b = a;\n"
+			"    return b;\n"
+			"}\n",
+			1, text, sizeof(text));
+
+	int defs = 0;
+	for (char* line = strstr(text, "\ndef "); line != NULL; line = strstr(line + 1, "\ndef ")) {
+		char name[64];
+		SymbolName(tc, strchr(line + 5, ' ') + 1, name, sizeof(name));
+		CuAssertTrue(tc, IsReferenced(text, name));
+		++defs;
+	}
+	/* a and b, the temporaries for argc + 1 and the conversion of a are
+	   merged into them */
+	CuAssertIntEquals(tc, 2, defs);
+}
+
+/* The labels of the blocks of a loop are defined, including the label
+   of the continue which no jump targets */
+static void WriteLabelDefs(CuTest* tc) {
+	const char* source =
+		"int f(int argc, char** argv) {\n"
+		"    int a = argc;\n"
+		"    while (a < 10) { a = a * 2 + 1; }\n"
+		"    return a;\n"
+		"}\n";
+	for (int optimize = 0; optimize <= 1; ++optimize) {
+		char text[4096];
+		WriteFunction(tc, source, optimize, text, sizeof(text));
+
+		int labels = 0;
+		for (char* line = strstr(text, "\nlab "); line != NULL; line = strstr(line + 1, "\nlab ")) {
+			char name[64];
+			SymbolName(tc, line + 5, name, sizeof(name));
+			CuAssertTrue(tc, IsDefined(text, name));
+			++labels;
+		}
+		CuAssertTrue(tc, labels >= 3);
+	}
+}
+
+/* No IL2 exists for calls, generating one is an error instead of
+   leaving its result unassigned */
+static void GenerateCallRejected(CuTest* tc) {
+	FILE* rf = tmpfile();
+	CuAssertPtrNotNull(tc, rf);
+	fprintf(rf, "int f(int x) { return f(x); }\n");
+	rewind(rf);
+
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct_stream(&lex, rf), ec_noerr);
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+	Parser p;
+	CuAssertIntEquals(tc, parser_construct(&p, &lex, &stab, &tree), ec_noerr);
+	Cfg cfg;
+	CuAssertIntEquals(tc, cfg_construct(&cfg), ec_noerr);
+
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	int parsed;
+	CuAssertIntEquals(tc, parse_next_external_declaration(&p, &parsed), ec_noerr);
+	CuAssertIntEquals(tc, 1, parsed);
+
+	FlatTree ftree;
+	CuAssertIntEquals(tc, flat_tree_construct(&ftree, &tree), ec_noerr);
+	IL2Gen il2;
+	CuAssertIntEquals(tc, il2_construct(&il2, &cfg, &stab, &ftree), ec_noerr);
+	CuAssertIntEquals(tc, ec_syntaxerr, il2_gen(&il2));
+	il2_destruct(&il2);
+	flat_tree_destruct(&ftree);
+
+	cfg_destruct(&cfg);
+	tree_destruct(&tree);
+	symtab_destruct(&stab);
+	lexer_destruct(&lex);
+	fclose(rf);
+}
+
+CuSuite* IL2GenGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, GenerateDeepExpression);
+	SUITE_ADD_TEST(suite, GenerateDeepSum);
+	SUITE_ADD_TEST(suite, GenerateFunctionsFlatMemory);
+	SUITE_ADD_TEST(suite, WriteReferencedDefs);
+	SUITE_ADD_TEST(suite, WriteLabelDefs);
+	SUITE_ADD_TEST(suite, GenerateCallRejected);
+	return suite;
+}
@@ -1,5 +1,6 @@
 #include "CuTest.h"
 
+#include "common.h"
 #include "lexer.h"
 
 static void ReadToken(CuTest* tc) {
@@ -7,50 +8,482 @@ static void ReadToken(CuTest* tc) {
 	CuAssertIntEquals(tc, lexer_construct(&lex, "testu/testcode"), ec_noerr);
 
 	/* Does not consume */
-	const char* token;
+	const Token* token;
 	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "float");
+	CuAssertIntEquals(tc, tk_float, token->kind);
+	CuAssertStrEquals(tc, "float", token->str);
 	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "float");
+	CuAssertIntEquals(tc, tk_float, token->kind);
+	CuAssertStrEquals(tc, "float", token->str);
 	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "z");
+	CuAssertIntEquals(tc, tk_identifier, token->kind);
+	CuAssertStrEquals(tc, "z", token->str);
 	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "z");
+	CuAssertIntEquals(tc, tk_identifier, token->kind);
+	CuAssertStrEquals(tc, "z", token->str);
 
 	lexer_consume(&lex);
 	/* Reads next token after consume */
 	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "z");
+	CuAssertIntEquals(tc, tk_identifier, token->kind);
+	CuAssertStrEquals(tc, "z", token->str);
 	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "z");
+	CuAssertIntEquals(tc, tk_identifier, token->kind);
+	CuAssertStrEquals(tc, "z", token->str);
 	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "=");
+	CuAssertIntEquals(tc, tk_equal, token->kind);
+	CuAssertStrEquals(tc, "=", token->str);
 	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "=");
+	CuAssertIntEquals(tc, tk_equal, token->kind);
+	CuAssertStrEquals(tc, "=", token->str);
 
 	lexer_consume(&lex);
 	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "=");
+	CuAssertIntEquals(tc, tk_equal, token->kind);
+	CuAssertStrEquals(tc, "=", token->str);
 	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "1");
+	CuAssertIntEquals(tc, tk_constant, token->kind);
+	CuAssertStrEquals(tc, "1", token->str);
 
 	lexer_consume(&lex);
 	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "1");
+	CuAssertIntEquals(tc, tk_constant, token->kind);
+	CuAssertStrEquals(tc, "1", token->str);
 	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, ";");
+	CuAssertIntEquals(tc, tk_semicolon, token->kind);
+	CuAssertStrEquals(tc, ";", token->str);
 
 	lexer_consume(&lex);
 	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, ";");
+	CuAssertIntEquals(tc, tk_semicolon, token->kind);
+	CuAssertStrEquals(tc, ";", token->str);
 	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
-	CuAssertStrEquals(tc, token, "int");
+	CuAssertIntEquals(tc, tk_int, token->kind);
+	CuAssertStrEquals(tc, "int", token->str);
 
 	lexer_destruct(&lex);
 }
 
+static void ReadTokenEof(CuTest* tc) {
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct(&lex, "testu/testcode"), ec_noerr);
+
+	/* Last token of file, followed by blank tokens */
+	const Token* token;
+	int count = 0;
+	while (1) {
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		if (token->kind == tk_eof) break;
+		lexer_consume(&lex);
+		++count;
+	}
+	CuAssertIntEquals(tc, 21, count);
+	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_eof, token->kind);
+	CuAssertStrEquals(tc, "", token->str);
+	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_eof, token->kind);
+	CuAssertStrEquals(tc, "", token->str);
+
+	lexer_destruct(&lex);
+}
+
+static void TokenInterned(CuTest* tc) {
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct(&lex, "testu/testcode"), ec_noerr);
+
+	/* 1 appears twice, it should have the same id each time */
+	const Token* token;
+	StrId one_id = -1;
+	int one_count = 0;
+	while (1) {
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		if (token->kind == tk_eof) break;
+
+		if (token->kind == tk_identifier || token->kind == tk_constant) {
+			CuAssertTrue(tc, token->id >= 0);
+			CuAssertPtrEquals(tc, (void*)strpool_str(&lex.pool, token->id), (void*)token->str);
+		}
+		else {
+			CuAssertIntEquals(tc, -1, token->id);
+			CuAssertStrEquals(tc, tk_str(token->kind), token->str);
+		}
+
+		if (token->kind == tk_constant && strequ(token->str, "1")) {
+			if (one_id >= 0) CuAssertIntEquals(tc, one_id, token->id);
+			one_id = token->id;
+			++one_count;
+		}
+		lexer_consume(&lex);
+	}
+	CuAssertIntEquals(tc, 2, one_count);
+
+	lexer_destruct(&lex);
+}
+
+static void PretokenizeSameTokens(CuTest* tc) {
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct(&lex, "testu/testcode"), ec_noerr);
+	Lexer lex_table;
+	CuAssertIntEquals(tc, lexer_construct(&lex_table, "testu/testcode"), ec_noerr);
+	CuAssertIntEquals(tc, lexer_tokenize(&lex_table), ec_noerr);
+	/* 21 tokens and tk_eof */
+	CuAssertIntEquals(tc, 22, vec_size(&lex_table.table.kind));
+
+	/* Reads the same tokens as when lexing on demand */
+	while (1) {
+		const Token* token;
+		const Token* token_table;
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		CuAssertIntEquals(tc, lexer_getc(&lex_table, &token_table), ec_noerr);
+		CuAssertIntEquals(tc, token->kind, token_table->kind);
+		CuAssertStrEquals(tc, token->str, token_table->str);
+		CuAssertIntEquals(tc, token->loc, token_table->loc);
+		CuAssertIntEquals(tc, strlength(token->str), vec_at(&lex_table.table.length, lex_table.cursor));
+
+		CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
+		CuAssertIntEquals(tc, lexer_getc2(&lex_table, &token_table), ec_noerr);
+		CuAssertIntEquals(tc, token->kind, token_table->kind);
+		CuAssertStrEquals(tc, token->str, token_table->str);
+
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		if (token->kind == tk_eof) break;
+		lexer_consume(&lex);
+		lexer_consume(&lex_table);
+	}
+
+	lexer_destruct(&lex_table);
+	lexer_destruct(&lex);
+}
+
+static void PretokenizeLookahead(CuTest* tc) {
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct(&lex, "testu/testcode"), ec_noerr);
+	CuAssertIntEquals(tc, lexer_tokenize(&lex), ec_noerr);
+
+	/* float z = 1; int */
+	const Token* token;
+	CuAssertIntEquals(tc, lexer_peek(&lex, 3, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_constant, token->kind);
+	CuAssertStrEquals(tc, "1", token->str);
+	CuAssertIntEquals(tc, lexer_peek(&lex, 5, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_int, token->kind);
+	/* Past the end is tk_eof */
+	CuAssertIntEquals(tc, lexer_peek(&lex, 100, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_eof, token->kind);
+
+	/* Rewind to mark reads the same tokens again */
+	lexer_consume(&lex);
+	int mark = lexer_mark(&lex);
+	lexer_consume(&lex);
+	lexer_consume(&lex);
+	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_constant, token->kind);
+
+	lexer_rewind(&lex, mark);
+	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_identifier, token->kind);
+	CuAssertStrEquals(tc, "z", token->str);
+	CuAssertIntEquals(tc, lexer_getc2(&lex, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_equal, token->kind);
+
+	/* Consuming at end stays on tk_eof */
+	for (int i = 0; i < 30; ++i) {
+		lexer_consume(&lex);
+	}
+	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_eof, token->kind);
+	CuAssertStrEquals(tc, "", token->str);
+
+	lexer_destruct(&lex);
+}
+
+/* Asserts the token tables of the pretokenized lexers are the same */
+static void assert_same_table(CuTest* tc, Lexer* lex, Lexer* lex_other) {
+	CuAssertIntEquals(tc, vec_size(&lex->table.kind), vec_size(&lex_other->table.kind));
+	CuAssertIntEquals(tc, lex->cursor, lex_other->cursor);
+	CuAssertIntEquals(tc, strpool_size(&lex->pool), strpool_size(&lex_other->pool));
+	for (int i = 0; i < vec_size(&lex->table.kind); ++i) {
+		CuAssertIntEquals(tc, vec_at(&lex->table.kind, i), vec_at(&lex_other->table.kind, i));
+		CuAssertIntEquals(tc, vec_at(&lex->table.id, i), vec_at(&lex_other->table.id, i));
+		CuAssertIntEquals(tc, vec_at(&lex->table.loc, i), vec_at(&lex_other->table.loc, i));
+		CuAssertIntEquals(tc, vec_at(&lex->table.length, i), vec_at(&lex_other->table.length, i));
+
+		int line_num;
+		int char_num;
+		int line_num_other;
+		int char_num_other;
+		SrcLoc loc = vec_at(&lex->table.loc, i);
+		CuAssertIntEquals(tc, lexer_location(lex, loc, &line_num, &char_num), ec_noerr);
+		CuAssertIntEquals(tc, lexer_location(lex_other, loc, &line_num_other, &char_num_other), ec_noerr);
+		CuAssertIntEquals(tc, line_num, line_num_other);
+		CuAssertIntEquals(tc, char_num, char_num_other);
+	}
+	for (StrId id = 0; id < strpool_size(&lex->pool); ++id) {
+		CuAssertStrEquals(tc, strpool_str(&lex->pool, id), strpool_str(&lex_other->pool, id));
+	}
+}
+
+static void ParallelSameTokens(CuTest* tc) {
+	const char* paths[] = {"testu/testcode", "testu/testlinemarker"};
+	/* Small chunks to split the input into many chunks */
+	int chunk_sizes[] = {1, 2, 7, 64, LEXER_CHUNK_SIZE};
+	for (int i = 0; i < ARRAY_SIZE(paths); ++i) {
+		for (int j = 0; j < ARRAY_SIZE(chunk_sizes); ++j) {
+			Lexer lex;
+			CuAssertIntEquals(tc, lexer_construct(&lex, paths[i]), ec_noerr);
+			CuAssertIntEquals(tc, lexer_tokenize(&lex), ec_noerr);
+			Lexer lex_parallel;
+			CuAssertIntEquals(tc, lexer_construct(&lex_parallel, paths[i]), ec_noerr);
+			CuAssertIntEquals(tc, lexer_tokenize_parallel(&lex_parallel, chunk_sizes[j]), ec_noerr);
+
+			assert_same_table(tc, &lex, &lex_parallel);
+
+			lexer_destruct(&lex_parallel);
+			lexer_destruct(&lex);
+		}
+	}
+}
+
+/* Tokens after a bad token are not lexed */
+static void ParallelTokenError(CuTest* tc) {
+	FILE* rf = tmpfile();
+	CuAssertPtrNotNull(tc, rf);
+	for (int i = 0; i < 100; ++i) {
+		fprintf(rf, "int value_%d = %d;\n", i, i);
+		if (i == 50) {
+			for (int j = 0; j < MAX_TOKEN_LEN + 1; ++j) {
+				fputc('a', rf);
+			}
+			fputc('\n', rf);
+		}
+	}
+
+	rewind(rf);
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct_stream(&lex, rf), ec_noerr);
+	CuAssertIntEquals(tc, lexer_tokenize(&lex), ec_lexer_tokbufexceed);
+
+	rewind(rf);
+	Lexer lex_parallel;
+	CuAssertIntEquals(tc, lexer_construct_stream(&lex_parallel, rf), ec_noerr);
+	CuAssertIntEquals(tc, lexer_tokenize_parallel(&lex_parallel, 32), ec_lexer_tokbufexceed);
+
+	assert_same_table(tc, &lex, &lex_parallel);
+	/* Cursor is at the bad token */
+	const Token* token;
+	CuAssertIntEquals(tc, lexer_getc(&lex_parallel, &token), ec_noerr);
+	int line_num;
+	int char_num;
+	CuAssertIntEquals(tc, lexer_location(&lex_parallel, token->loc, &line_num, &char_num), ec_noerr);
+	CuAssertIntEquals(tc, 52, line_num);
+	CuAssertIntEquals(tc, 1, char_num);
+
+	lexer_destruct(&lex_parallel);
+	lexer_destruct(&lex);
+	fclose(rf);
+}
+
+static void Location(CuTest* tc) {
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct(&lex, "testu/testlinemarker"), ec_noerr);
+
+	/* Line markers are skipped */
+	const Token* token;
+	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_int, token->kind);
+
+	/* Line number follows line markers */
+	int line_num;
+	int char_num;
+	CuAssertIntEquals(tc, lexer_location(&lex, token->loc, &line_num, &char_num), ec_noerr);
+	CuAssertIntEquals(tc, 10, line_num);
+	CuAssertIntEquals(tc, 1, char_num);
+
+	/* Last token of a line longer than any fixed size buffer */
+	const char* last = "last_on_long_line";
+	while (1) {
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		CuAssertTrue(tc, token->kind != tk_eof);
+		if (strequ(token->str, last)) break;
+		lexer_consume(&lex);
+	}
+	CuAssertIntEquals(tc, lexer_location(&lex, token->loc, &line_num, &char_num), ec_noerr);
+	CuAssertIntEquals(tc, 11, line_num);
+	CuAssertIntEquals(tc, 305, char_num);
+
+	/* Second line marker */
+	lexer_consume(&lex); /* last_on_long_line */
+	lexer_consume(&lex); /* ; */
+	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+	CuAssertStrEquals(tc, "after_marker", token->str);
+	CuAssertIntEquals(tc, lexer_location(&lex, token->loc, &line_num, &char_num), ec_noerr);
+	CuAssertIntEquals(tc, 50, line_num);
+	CuAssertIntEquals(tc, 5, char_num);
+
+	lexer_destruct(&lex);
+}
+
+static void StreamSameTokens(CuTest* tc) {
+	FILE* rf = fopen("testu/testcode", "rb");
+	CuAssertPtrNotNull(tc, rf);
+	Lexer lex_stream;
+	CuAssertIntEquals(tc, lexer_construct_stream(&lex_stream, rf), ec_noerr);
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct(&lex, "testu/testcode"), ec_noerr);
+
+	while (1) {
+		const Token* token;
+		const Token* token_stream;
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		CuAssertIntEquals(tc, lexer_getc(&lex_stream, &token_stream), ec_noerr);
+		CuAssertIntEquals(tc, token->kind, token_stream->kind);
+		CuAssertStrEquals(tc, token->str, token_stream->str);
+		CuAssertIntEquals(tc, token->loc, token_stream->loc);
+		if (token->kind == tk_eof) break;
+		lexer_consume(&lex);
+		lexer_consume(&lex_stream);
+	}
+
+	lexer_destruct(&lex);
+	lexer_destruct(&lex_stream);
+	fclose(rf);
+}
+
+/* Input many times larger than the window */
+static void StreamWindow(CuTest* tc) {
+	FILE* rf = tmpfile();
+	CuAssertPtrNotNull(tc, rf);
+
+	/* Lines of: name_i = i;
+	   Every 1000 lines, line marker sets the line number to 1000000 + i */
+	const int lines = 20000;
+	fprintf(rf, "# 1 \"gen.c\"\n");
+	for (int i = 0; i < lines; ++i) {
+		fprintf(rf, "    name_%d = %d;\n", i, i);
+		if (i % 1000 == 999) fprintf(rf, "# %d \"gen.c\" 2\n", 1000000 + i + 1);
+	}
+	/* Line longer than the window */
+	for (int i = 0; i < LEXER_WINDOW_SIZE * 2; ++i) {
+		fputc(' ', rf);
+	}
+	fprintf(rf, "last\n");
+	rewind(rf);
+
+	Lexer lex;
+	CuAssertIntEquals(tc, lexer_construct_stream(&lex, rf), ec_noerr);
+
+	const Token* token;
+	int line_num = 1;
+	for (int i = 0; i < lines; ++i) {
+		char name[20];
+		snprintf(name, sizeof(name), "name_%d", i);
+		char value[20];
+		snprintf(value, sizeof(value), "%d", i);
+
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		CuAssertIntEquals(tc, tk_identifier, token->kind);
+		CuAssertStrEquals(tc, name, token->str);
+
+		int tok_line_num;
+		int tok_char_num;
+		CuAssertIntEquals(tc, lexer_location(&lex, token->loc, &tok_line_num, &tok_char_num), ec_noerr);
+		CuAssertIntEquals(tc, line_num, tok_line_num);
+		CuAssertIntEquals(tc, 5, tok_char_num);
+		lexer_consume(&lex);
+
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		CuAssertIntEquals(tc, tk_equal, token->kind);
+		lexer_consume(&lex);
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		CuAssertStrEquals(tc, value, token->str);
+		lexer_consume(&lex);
+		CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+		CuAssertIntEquals(tc, tk_semicolon, token->kind);
+		lexer_consume(&lex);
+
+		line_num = i % 1000 == 999 ? 1000000 + i + 1 : line_num + 1;
+	}
+
+	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+	CuAssertStrEquals(tc, "last", token->str);
+	int tok_line_num;
+	int tok_char_num;
+	CuAssertIntEquals(tc, lexer_location(&lex, token->loc, &tok_line_num, &tok_char_num), ec_noerr);
+	CuAssertIntEquals(tc, line_num, tok_line_num);
+	CuAssertIntEquals(tc, LEXER_WINDOW_SIZE * 2 + 1, tok_char_num);
+	lexer_consume(&lex);
+
+	CuAssertIntEquals(tc, lexer_getc(&lex, &token), ec_noerr);
+	CuAssertIntEquals(tc, tk_eof, token->kind);
+	/* Window only grows to hold the long line, as the token before it is
+	   still loaded while the line is read */
+	CuAssertTrue(tc, lex.buf_capacity <= LEXER_WINDOW_SIZE * 4);
+
+	lexer_destruct(&lex);
+	fclose(rf);
+}
+
+static void ClassifyKeyword(CuTest* tc) {
+	/* Every keyword classifies as itself */
+	int keywords = 0;
+	for (int i = 0; i < tk_count; ++i) {
+		TokenKind kind = (TokenKind)i;
+		if (!tk_iskeyword(kind)) continue;
+
+		const char* str = tk_str(kind);
+		CuAssertIntEquals(tc, kind, tok_classify(str, strlength(str)));
+		CuAssertTrue(tc, tok_iskeyword(str));
+		++keywords;
+	}
+	CuAssertIntEquals(tc, 37, keywords);
+
+	/* Near misses are identifiers */
+	const char* identifiers[] = {
+		"", "d", "i", "in", "Int", "int2", "doo", "fo", "cas", "chars", "elso", "_Boo", "_Bools", "registe",
+		"restricts", "signet", "sizeoff", "statics", "strict", "switc", "_Imaginar", "_imaginary", "x", "main"};
+	for (int i = 0; i < ARRAY_SIZE(identifiers); ++i) {
+		const char* str = identifiers[i];
+		CuAssertIntEquals(tc, tk_identifier, tok_classify(str, strlength(str)));
+	}
+
+	/* Does not need to be null terminated */
+	CuAssertIntEquals(tc, tk_int, tok_classify("integer", 3));
+	CuAssertIntEquals(tc, tk_identifier, tok_classify("integer", 4));
+}
+
+static void ClassifyClass(CuTest* tc) {
+	CuAssertIntEquals(tc, tc_storeclass, tk_class(tok_classify("static", 6)));
+	CuAssertIntEquals(tc, tc_typespec, tk_class(tok_classify("unsigned", 8)));
+	CuAssertIntEquals(tc, tc_typequal, tk_class(tok_classify("volatile", 8)));
+	CuAssertIntEquals(tc, tc_funcspec, tk_class(tok_classify("inline", 6)));
+	CuAssertIntEquals(tc, tc_keyword, tk_class(tok_classify("while", 5)));
+	CuAssertIntEquals(tc, tc_none, tk_class(tok_classify("whilst", 6)));
+
+	CuAssertTrue(tc, tk_isstoreclass(tk_typedef));
+	CuAssertTrue(tc, tk_istypespec(tk_long));
+	CuAssertTrue(tc, !tk_istypespec(tk_struct));
+	CuAssertTrue(tc, tk_istypequal(tk_restrict));
+	CuAssertTrue(tc, tk_isfuncspec(tk_inline));
+	CuAssertTrue(tc, tk_isassignmentop(tk_lesslessequal));
+	CuAssertTrue(tc, !tk_isassignmentop(tk_equalequal));
+	CuAssertTrue(tc, !tk_iskeyword(tk_identifier));
+	CuAssertTrue(tc, !tk_iskeyword(tk_semicolon));
+}
+
 CuSuite* LexerGetSuite() {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, ReadToken);
+	SUITE_ADD_TEST(suite, ReadTokenEof);
+	SUITE_ADD_TEST(suite, TokenInterned);
+	SUITE_ADD_TEST(suite, PretokenizeSameTokens);
+	SUITE_ADD_TEST(suite, PretokenizeLookahead);
+	SUITE_ADD_TEST(suite, ParallelSameTokens);
+	SUITE_ADD_TEST(suite, ParallelTokenError);
+	SUITE_ADD_TEST(suite, Location);
+	SUITE_ADD_TEST(suite, StreamSameTokens);
+	SUITE_ADD_TEST(suite, StreamWindow);
+	SUITE_ADD_TEST(suite, ClassifyKeyword);
+	SUITE_ADD_TEST(suite, ClassifyClass);
 	return suite;
 }
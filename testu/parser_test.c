@@ -3,9 +3,9 @@
 #include "common.h"
 #include "parser.h"
 
-static void ParserConstruct(CuTest* tc, Parser* p) {
+static void ParserConstruct(CuTest* tc, Parser* p, const char* path) {
 	Lexer* lex = cmalloc(sizeof(Lexer));
-	CuAssertIntEquals(tc, lexer_construct(lex, "testu/testfunc"), ec_noerr);
+	CuAssertIntEquals(tc, lexer_construct(lex, path), ec_noerr);
 
 	Symtab* symtab = cmalloc(sizeof(Symtab));
 	CuAssertIntEquals(tc, symtab_construct(symtab), ec_noerr);
@@ -31,15 +31,129 @@ static void ParserDestruct(CuTest* /*tc*/, Parser* p) {
 
 static void ParseFunction(CuTest* tc) {
 	Parser p;
-	ParserConstruct(tc, &p);
+	ParserConstruct(tc, &p, "testu/testfunc");
 
 	parse_translation_unit(&p);
 
 	ParserDestruct(tc, &p);
 }
 
+/* Value and type of constants are computed when parsed */
+static void ParseConstant(CuTest* tc) {
+	Parser p;
+	ParserConstruct(tc, &p, "testu/testconstant");
+
+	CuAssertIntEquals(tc, parse_translation_unit(&p), ec_noerr);
+
+	const char* tokens[] = {"2147483647", "2147483648", "0xFFFFFFFF", "017", "10u", "10l", "0x8000000000000000",
+							"9223372036854775807LL", "18446744073709551615ull", "5Lu"};
+	uint64_t values[] = {2147483647, 2147483648, 0xFFFFFFFF, 15, 10, 10, 0x8000000000000000,
+						 9223372036854775807, 18446744073709551615u, 5};
+	/* long is 32 bits, larger values are long long */
+	TypeSpecifiers types[] = {ts_int, ts_longlong, ts_uint, ts_int, ts_uint, ts_long, ts_ulonglong,
+							  ts_longlong, ts_ulonglong, ts_ulong};
+
+	/* First 2 constants are the special constants 0 and 1, return 0 uses
+	   the special constant */
+	CuAssertIntEquals(tc, ARRAY_SIZE(tokens) + 2, svec_size(&p.symtab->constant));
+	for (int i = 0; i < ARRAY_SIZE(tokens); ++i) {
+		Symbol* sym = &svec_at(&p.symtab->constant, i + 2);
+		CuAssertStrEquals(tc, tokens[i], symbol_token(sym));
+		CuAssertTrue(tc, symbol_is_constant(sym));
+		CuAssertTrue(tc, values[i] == symbol_constant_value(sym));
+		CuAssertIntEquals(tc, types[i], type_typespec(symbol_type(sym)));
+	}
+
+	ParserDestruct(tc, &p);
+}
+
+/* Decimal constant without suffix has no unsigned type */
+static void ParseConstantTooLarge(CuTest* tc) {
+	Parser p;
+	ParserConstruct(tc, &p, "testu/testconstantlarge");
+	CuAssertIntEquals(tc, parse_translation_unit(&p), ec_syntaxerr);
+	ParserDestruct(tc, &p);
+}
+
+/* Asserts node has type and child count */
+static void assert_node(CuTest* tc, TNode* node, TNodeType type, int child_count) {
+	CuAssertStrEquals(tc, tt_str(type), tt_str(tnode_type(node)));
+	CuAssertIntEquals(tc, child_count, tnode_count_child(node));
+}
+
+/* Binary operators are grouped by precedence, with one node for each
+   operator and no nodes for productions without an operator */
+static void ParseExpression(CuTest* tc) {
+	Parser p;
+	ParserConstruct(tc, &p, "testu/testexpression");
+
+	CuAssertIntEquals(tc, parse_translation_unit(&p), ec_noerr);
+
+	TNode* compound = tnode_child(tnode_child(tree_root(p.tree), 0), 4);
+	assert_node(tc, compound, tt_compound_statement, 3);
+
+	/* a = a || a && a * a + a < a == a && a */
+	TNode* assign = tnode_child(compound, 1);
+	assert_node(tc, assign, tt_assignment_expression, 2);
+	assert_node(tc, tnode_child(assign, 0), tt_identifier, 0);
+
+	TNode* logical_or = tnode_child(assign, 1);
+	assert_node(tc, logical_or, tt_logical_or_expression, 2);
+	assert_node(tc, tnode_child(logical_or, 0), tt_identifier, 0);
+
+	TNode* logical_and = tnode_child(logical_or, 1);
+	assert_node(tc, logical_and, tt_logical_and_expression, 3);
+	assert_node(tc, tnode_child(logical_and, 2), tt_identifier, 0);
+
+	int ops[] = {TNodeBinaryExpression_e, TNodeBinaryExpression_l, TNodeBinaryExpression_add, TNodeBinaryExpression_mul};
+	TNode* node = tnode_child(logical_and, 1);
+	for (int i = 0; i < ARRAY_SIZE(ops); ++i) {
+		assert_node(tc, node, tt_binary_expression, 2);
+		CuAssertIntEquals(tc, ops[i], ((TNodeBinaryExpression*)tnode_data(node))->type);
+		assert_node(tc, tnode_child(node, 1), tt_identifier, 0);
+		node = tnode_child(node, 0);
+	}
+	assert_node(tc, node, tt_identifier, 0);
+
+	/* return a - a - a, left to right */
+	TNode* sub = tnode_child(tnode_child(compound, 2), 0);
+	assert_node(tc, sub, tt_binary_expression, 2);
+	assert_node(tc, tnode_child(sub, 0), tt_binary_expression, 2);
+	assert_node(tc, tnode_child(sub, 1), tt_identifier, 0);
+
+	ParserDestruct(tc, &p);
+}
+
+/* Each statement and declaration is chosen by its first token, no nodes
+   are allocated for productions which do not match */
+static void ParseStatement(CuTest* tc) {
+	Parser p;
+	ParserConstruct(tc, &p, "testu/teststatement");
+
+	CuAssertIntEquals(tc, parse_translation_unit(&p), ec_noerr);
+	CuAssertIntEquals(tc, 0, p.stats.discarded_nodes);
+
+	TNode* compound = tnode_child(tnode_child(tree_root(p.tree), 0), 4);
+	assert_node(tc, compound, tt_compound_statement, 7);
+
+	TNodeType types[] = {tt_declaration,  tt_compound_statement, tt_selection_statement, tt_while_statement,
+						 tt_do_statement, tt_for_statement,      tt_jump_statement};
+	for (int i = 0; i < ARRAY_SIZE(types); ++i) {
+		CuAssertStrEquals(tc, tt_str(types[i]), tt_str(tnode_type(tnode_child(compound, i))));
+	}
+
+	/* for with a declaration */
+	assert_node(tc, tnode_child(tnode_child(compound, 5), 0), tt_declaration, 4);
+
+	ParserDestruct(tc, &p);
+}
+
 CuSuite* ParserGetSuite() {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, ParseFunction);
+	SUITE_ADD_TEST(suite, ParseConstant);
+	SUITE_ADD_TEST(suite, ParseConstantTooLarge);
+	SUITE_ADD_TEST(suite, ParseExpression);
+	SUITE_ADD_TEST(suite, ParseStatement);
 	return suite;
 }
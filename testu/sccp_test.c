@@ -0,0 +1,296 @@
+#include "CuTest.h"
+
+#include <stdio.h>
+
+#include "cfg.h"
+#include "common.h"
+#include "sccp.h"
+#include "ssa.h"
+#include "symtab.h"
+
+/* Makes symbol table with function scope for the labels */
+static void MakeSymtab(CuTest* tc, Symtab* stab) {
+	CuAssertIntEquals(tc, symtab_construct(stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(stab), ec_noerr);
+}
+
+/* Returns constant of type ts */
+static Symbol* Constant(CuTest* tc, Symtab* stab, uint64_t value, TypeSpecifiers ts) {
+	Type type;
+	CuAssertIntEquals(tc, type_construct(&type, ts, 0), ec_noerr);
+	Symbol* sym;
+	char token[24];
+	snprintf(token, sizeof(token), "%llu", (unsigned long long)value);
+	CuAssertIntEquals(tc, symtab_add_constant(stab, &sym, token, value, &type), ec_noerr);
+	type_destruct(&type);
+	return sym;
+}
+
+/* Returns variable of type ts */
+static Symbol* Variable(CuTest* tc, Symtab* stab, const char* token, TypeSpecifiers ts) {
+	Type type;
+	CuAssertIntEquals(tc, type_construct(&type, ts, 0), ec_noerr);
+	Symbol* sym;
+	CuAssertIntEquals(tc, symtab_add(stab, &sym, token, &type), ec_noerr);
+	type_destruct(&type);
+	return sym;
+}
+
+/* Partitions the statements into blocks of the cfg, then propagates
+   the constants */
+static void Propagate(CuTest* tc, Symtab* stab, Cfg* cfg, IL2Statement* stats, int count) {
+	CuAssertIntEquals(tc, cfg_construct(cfg), ec_noerr);
+	Block* blk;
+	CuAssertIntEquals(tc, cfg_new_block(cfg, &blk), ec_noerr);
+	for (int i = 0; i < count; ++i) {
+		CuAssertIntEquals(tc, block_add_ilstat(blk, stats[i]), ec_noerr);
+	}
+	CuAssertIntEquals(tc, cfg_partition(cfg), ec_noerr);
+
+	Ssa ssa;
+	CuAssertIntEquals(tc, ssa_construct(&ssa), ec_noerr);
+	Sccp sccp;
+	CuAssertIntEquals(tc, sccp_construct(&sccp), ec_noerr);
+	CuAssertIntEquals(tc, ssa_convert(&ssa, cfg), ec_noerr);
+	CuAssertIntEquals(tc, sccp_run(&sccp, &ssa, stab), ec_noerr);
+	ssa_revert(&ssa);
+	sccp_destruct(&sccp);
+	ssa_destruct(&ssa);
+}
+
+/* Asserts statement at index i of block is a mov of the constant value
+   to dest */
+static void AssertMovConstant(CuTest* tc, Block* blk, int i, Symbol* dest, uint64_t value) {
+	IL2Statement* stat = block_ilstat(blk, i);
+	CuAssertIntEquals(tc, il2_mov, il2stat_ins(stat));
+	CuAssertPtrEquals(tc, dest, il2stat_arg(stat, 0));
+	CuAssertTrue(tc, symbol_is_constant(il2stat_arg(stat, 1)));
+	CuAssertTrue(tc, symbol_constant_value(il2stat_arg(stat, 1)) == value);
+	CuAssertPtrEquals(tc, symbol_type(dest), symbol_type(il2stat_arg(stat, 1)));
+}
+
+/* Each statement of a chain of arithmetic on constants is folded, and
+   the result replaces the variable read by ret */
+static void FoldChain(CuTest* tc) {
+	Symtab stab;
+	MakeSymtab(tc, &stab);
+	Symbol* t1 = Variable(tc, &stab, "t1", ts_int);
+	Symbol* t2 = Variable(tc, &stab, "t2", ts_int);
+	Symbol* t3 = Variable(tc, &stab, "t3", ts_int);
+
+	IL2Statement stats[] = {
+		il2stat_make(il2_mul, t1, Constant(tc, &stab, 2, ts_int), Constant(tc, &stab, 3, ts_int)),
+		il2stat_make(il2_sub, t2, t1, Constant(tc, &stab, 10, ts_int)),
+		il2stat_make(il2_mul, t3, t2, t2),
+		il2stat_make1(il2_ret, t2),
+	};
+	Cfg cfg;
+	Propagate(tc, &stab, &cfg, stats, ARRAY_SIZE(stats));
+
+	Block* blk = &vec_at(&cfg.blocks, 0);
+	CuAssertIntEquals(tc, 4, block_ilstat_count(blk));
+	AssertMovConstant(tc, blk, 0, t1, 6);
+	/* -4 as the bits of int */
+	AssertMovConstant(tc, blk, 1, t2, 0xFFFFFFFC);
+	AssertMovConstant(tc, blk, 2, t3, 16);
+	Symbol* ret = il2stat_arg(block_ilstat(blk, 3), 0);
+	CuAssertTrue(tc, symbol_is_constant(ret));
+	CuAssertTrue(tc, symbol_constant_value(ret) == 0xFFFFFFFC);
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* Values are computed in the types of the operands and results, and
+   statements which trap are not folded */
+static void FoldTypes(CuTest* tc) {
+	Symtab stab;
+	MakeSymtab(tc, &stab);
+	Symbol* n = Variable(tc, &stab, "n", ts_int);
+	Symbol* t1 = Variable(tc, &stab, "t1", ts_int);
+	Symbol* t2 = Variable(tc, &stab, "t2", ts_int);
+	Symbol* ch = Variable(tc, &stab, "ch", ts_char);
+	Symbol* q = Variable(tc, &stab, "q", ts_int);
+	Symbol* r = Variable(tc, &stab, "r", ts_int);
+	Symbol* min = Variable(tc, &stab, "min", ts_int);
+	Symbol* t3 = Variable(tc, &stab, "t3", ts_int);
+	Symbol* zero = Constant(tc, &stab, 0, ts_int);
+	Symbol* one = Constant(tc, &stab, 1, ts_int);
+
+	IL2Statement stats[] = {
+		il2stat_make(il2_sub, n, zero, one),
+		/* -1 is converted to unsigned */
+		il2stat_make(il2_cl, t1, n, Constant(tc, &stab, 1, ts_uint)),
+		il2stat_make(il2_cl, t2, n, one),
+		il2stat_make2(il2_mtc, ch, Constant(tc, &stab, 200, ts_int)),
+		il2stat_make(il2_div, q, n, Constant(tc, &stab, 2, ts_int)),
+		il2stat_make(il2_mod, r, n, zero),
+		il2stat_make(il2_sub, min, zero, Constant(tc, &stab, 0x80000000, ts_uint)),
+		il2stat_make(il2_div, t3, min, n),
+		il2stat_make1(il2_ret, r),
+	};
+	Cfg cfg;
+	Propagate(tc, &stab, &cfg, stats, ARRAY_SIZE(stats));
+
+	Block* blk = &vec_at(&cfg.blocks, 0);
+	AssertMovConstant(tc, blk, 0, n, 0xFFFFFFFF);
+	AssertMovConstant(tc, blk, 1, t1, 0);
+	AssertMovConstant(tc, blk, 2, t2, 1);
+	AssertMovConstant(tc, blk, 3, ch, 200);
+	/* Signed division truncates towards zero */
+	AssertMovConstant(tc, blk, 4, q, 0);
+	AssertMovConstant(tc, blk, 6, min, 0x80000000);
+
+	/* Operands are still replaced by constants */
+	IL2Statement* mod = block_ilstat(blk, 5);
+	CuAssertIntEquals(tc, il2_mod, il2stat_ins(mod));
+	CuAssertTrue(tc, symbol_is_constant(il2stat_arg(mod, 1)));
+	IL2Statement* div = block_ilstat(blk, 7);
+	CuAssertIntEquals(tc, il2_div, il2stat_ins(div));
+	CuAssertPtrEquals(tc, r, il2stat_arg(block_ilstat(blk, 8), 0));
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* A signed value widened into an unsigned type is zero extended, as
+   mtc does, the same when compared in an unsigned common type */
+static void FoldWidenUnsigned(CuTest* tc) {
+	Symtab stab;
+	MakeSymtab(tc, &stab);
+	Symbol* u = Variable(tc, &stab, "u", ts_uint);
+	Symbol* i = Variable(tc, &stab, "i", ts_int);
+	Symbol* t1 = Variable(tc, &stab, "t1", ts_int);
+	/* -1 as the bits of signed char */
+	Symbol* c = Constant(tc, &stab, 0xFF, ts_schar);
+
+	IL2Statement stats[] = {
+		il2stat_make2(il2_mtc, u, c),
+		il2stat_make2(il2_mtc, i, c),
+		il2stat_make(il2_ce, t1, c, Constant(tc, &stab, 255, ts_uint)),
+		il2stat_make1(il2_ret, u),
+	};
+	Cfg cfg;
+	Propagate(tc, &stab, &cfg, stats, ARRAY_SIZE(stats));
+
+	Block* blk = &vec_at(&cfg.blocks, 0);
+	AssertMovConstant(tc, blk, 0, u, 0xFF);
+	AssertMovConstant(tc, blk, 1, i, 0xFFFFFFFF);
+	AssertMovConstant(tc, blk, 2, t1, 1);
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* Jump on a constant becomes unconditional, the arm never taken is
+   emptied and the variable merged at the join is a constant
+   0: mov x, 1; jz l1, 0  -> 2
+   1: mov x, 2; jmp l2    (never executed)
+   2: l1: mov x, 3        -> 3
+   3: l2: ret x */
+static void FoldBranch(CuTest* tc) {
+	Symtab stab;
+	MakeSymtab(tc, &stab);
+	Symbol* x = Variable(tc, &stab, "x", ts_int);
+	Symbol* l1;
+	Symbol* l2;
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l1), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l2), ec_noerr);
+
+	IL2Statement stats[] = {
+		il2stat_make2(il2_mov, x, Constant(tc, &stab, 1, ts_int)),
+		il2stat_make2(il2_jz, l1, Constant(tc, &stab, 0, ts_int)),
+		il2stat_make2(il2_mov, x, Constant(tc, &stab, 2, ts_int)),
+		il2stat_make1(il2_jmp, l2),
+		il2stat_make1(il2_lab, l1),
+		il2stat_make2(il2_mov, x, Constant(tc, &stab, 3, ts_int)),
+		il2stat_make1(il2_lab, l2),
+		il2stat_make1(il2_ret, x),
+	};
+	Cfg cfg;
+	Propagate(tc, &stab, &cfg, stats, ARRAY_SIZE(stats));
+	Block* b = vec_data(&cfg.blocks);
+
+	CuAssertIntEquals(tc, 2, block_ilstat_count(&b[0]));
+	IL2Statement* jmp = block_ilstat(&b[0], 1);
+	CuAssertIntEquals(tc, il2_jmp, il2stat_ins(jmp));
+	CuAssertPtrEquals(tc, l1, il2stat_arg(jmp, 0));
+	CuAssertIntEquals(tc, 1, block_next_count(&b[0]));
+	CuAssertPtrEquals(tc, &b[2], block_next(&b[0], 0));
+
+	CuAssertIntEquals(tc, 0, block_ilstat_count(&b[1]));
+	CuAssertIntEquals(tc, 0, block_lab_count(&b[1]));
+	CuAssertIntEquals(tc, 0, block_next_count(&b[1]));
+
+	Symbol* ret = il2stat_arg(block_ilstat(&b[3], 0), 0);
+	CuAssertTrue(tc, symbol_is_constant(ret));
+	CuAssertTrue(tc, symbol_constant_value(ret) == 3);
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* Versions merged from a loop are constant only if every executable
+   link brings the same constant
+   0: mov i, 0; mov k, 5
+   1: l1: cl t, i, 10; jz l2, t  -> 2 3
+   2: add i, i, 1; mul k, k, 1; jmp l1  -> 1
+   3: l2: add s, i, k; ret s */
+static void LoopPhi(CuTest* tc) {
+	Symtab stab;
+	MakeSymtab(tc, &stab);
+	Symbol* i = Variable(tc, &stab, "i", ts_int);
+	Symbol* k = Variable(tc, &stab, "k", ts_int);
+	Symbol* t = Variable(tc, &stab, "t", ts_int);
+	Symbol* s = Variable(tc, &stab, "s", ts_int);
+	Symbol* l1;
+	Symbol* l2;
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l1), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l2), ec_noerr);
+	Symbol* one = Constant(tc, &stab, 1, ts_int);
+
+	IL2Statement stats[] = {
+		il2stat_make2(il2_mov, i, Constant(tc, &stab, 0, ts_int)),
+		il2stat_make2(il2_mov, k, Constant(tc, &stab, 5, ts_int)),
+		il2stat_make1(il2_lab, l1),
+		il2stat_make(il2_cl, t, i, Constant(tc, &stab, 10, ts_int)),
+		il2stat_make2(il2_jz, l2, t),
+		il2stat_make(il2_add, i, i, one),
+		il2stat_make(il2_mul, k, k, one),
+		il2stat_make1(il2_jmp, l1),
+		il2stat_make1(il2_lab, l2),
+		il2stat_make(il2_add, s, i, k),
+		il2stat_make1(il2_ret, s),
+	};
+	Cfg cfg;
+	Propagate(tc, &stab, &cfg, stats, ARRAY_SIZE(stats));
+	Block* b = vec_data(&cfg.blocks);
+
+	/* i changes each iteration, k does not */
+	IL2Statement* cl = block_ilstat(&b[1], 0);
+	CuAssertIntEquals(tc, il2_cl, il2stat_ins(cl));
+	CuAssertPtrEquals(tc, i, il2stat_arg(cl, 1));
+	CuAssertIntEquals(tc, il2_jz, il2stat_ins(block_ilstat(&b[1], 1)));
+	CuAssertIntEquals(tc, 2, block_next_count(&b[1]));
+
+	CuAssertIntEquals(tc, il2_add, il2stat_ins(block_ilstat(&b[2], 0)));
+	AssertMovConstant(tc, &b[2], 1, k, 5);
+	IL2Statement* add = block_ilstat(&b[3], 0);
+	CuAssertPtrEquals(tc, i, il2stat_arg(add, 1));
+	CuAssertTrue(tc, symbol_is_constant(il2stat_arg(add, 2)));
+	CuAssertTrue(tc, symbol_constant_value(il2stat_arg(add, 2)) == 5);
+
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+CuSuite* SccpGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, FoldChain);
+	SUITE_ADD_TEST(suite, FoldTypes);
+	SUITE_ADD_TEST(suite, FoldWidenUnsigned);
+	SUITE_ADD_TEST(suite, FoldBranch);
+	SUITE_ADD_TEST(suite, LoopPhi);
+	return suite;
+}
@@ -0,0 +1,306 @@
+#include "CuTest.h"
+
+#include "cfg.h"
+#include "common.h"
+#include "ssa.h"
+#include "symtab.h"
+
+/* Partitions the statements into blocks of the cfg */
+static void MakeCfg(CuTest* tc, Cfg* cfg, IL2Statement* stats, int count) {
+	CuAssertIntEquals(tc, cfg_construct(cfg), ec_noerr);
+	Block* blk;
+	CuAssertIntEquals(tc, cfg_new_block(cfg, &blk), ec_noerr);
+	for (int i = 0; i < count; ++i) {
+		CuAssertIntEquals(tc, block_add_ilstat(blk, stats[i]), ec_noerr);
+	}
+	CuAssertIntEquals(tc, cfg_partition(cfg), ec_noerr);
+}
+
+/* Returns the phi argument of phi for the edge from block pred */
+static Symbol* PhiArg(Ssa* ssa, int blk, SsaPhi* phi, int pred) {
+	SsaBlock* sblk = ssa_block(ssa, blk);
+	for (int i = 0; i < vec_size(&sblk->pred); ++i) {
+		if (vec_at(&sblk->pred, i) == pred) return vec_at(&ssa->phi_arg, phi->arg + i);
+	}
+	return NULL;
+}
+
+/* If else, both arms assign x which is returned after
+   0: mov x, 1; jz l1, a  -> 1 2
+   1: mov x, 2; jmp l2    -> 3
+   2: l1: mov x, 3        -> 3
+   3: l2: ret x */
+static void MakeDiamond(CuTest* tc, Symtab* stab, Cfg* cfg, Symbol** x) {
+	CuAssertIntEquals(tc, symtab_construct(stab), ec_noerr);
+	/* Labels are added in function scope */
+	CuAssertIntEquals(tc, symtab_push_scope(stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(stab), ec_noerr);
+
+	Symbol* a;
+	Symbol* l1;
+	Symbol* l2;
+	CuAssertIntEquals(tc, symtab_add(stab, &a, "a", symtab_type_int(stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add(stab, x, "x", symtab_type_int(stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(stab, &l1), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(stab, &l2), ec_noerr);
+	Symbol* c1;
+	Symbol* c2;
+	Symbol* c3;
+	CuAssertIntEquals(tc, symtab_add_constant(stab, &c1, "1", 1, symtab_type_int(stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_constant(stab, &c2, "2", 2, symtab_type_int(stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_constant(stab, &c3, "3", 3, symtab_type_int(stab)), ec_noerr);
+
+	IL2Statement stats[] = {
+		il2stat_make2(il2_mov, *x, c1),
+		il2stat_make2(il2_jz, l1, a),
+		il2stat_make2(il2_mov, *x, c2),
+		il2stat_make1(il2_jmp, l2),
+		il2stat_make1(il2_lab, l1),
+		il2stat_make2(il2_mov, *x, c3),
+		il2stat_make1(il2_lab, l2),
+		il2stat_make1(il2_ret, *x),
+	};
+	MakeCfg(tc, cfg, stats, ARRAY_SIZE(stats));
+	CuAssertIntEquals(tc, 4, vec_size(&cfg->blocks));
+}
+
+static void DominatorTree(CuTest* tc) {
+	Symtab stab;
+	Cfg cfg;
+	Symbol* x;
+	MakeDiamond(tc, &stab, &cfg, &x);
+
+	Ssa ssa;
+	CuAssertIntEquals(tc, ssa_construct(&ssa), ec_noerr);
+	CuAssertIntEquals(tc, ssa_convert(&ssa, &cfg), ec_noerr);
+
+	for (int i = 1; i < 4; ++i) {
+		CuAssertIntEquals(tc, 0, ssa_block(&ssa, i)->idom);
+		CuAssertTrue(tc, ssa_dominates(&ssa, 0, i));
+	}
+	CuAssertTrue(tc, !ssa_dominates(&ssa, 1, 3));
+	CuAssertTrue(tc, !ssa_dominates(&ssa, 2, 3));
+	CuAssertIntEquals(tc, 3, vec_size(&ssa_block(&ssa, 0)->child));
+
+	/* Dominance of each arm ends at the join */
+	CuAssertIntEquals(tc, 0, vec_size(&ssa_block(&ssa, 0)->frontier));
+	for (int i = 1; i < 3; ++i) {
+		SsaBlock* sblk = ssa_block(&ssa, i);
+		CuAssertIntEquals(tc, 1, vec_size(&sblk->frontier));
+		CuAssertIntEquals(tc, 3, vec_at(&sblk->frontier, 0));
+	}
+	CuAssertIntEquals(tc, 0, vec_size(&ssa_block(&ssa, 3)->frontier));
+
+	ssa_revert(&ssa);
+	ssa_destruct(&ssa);
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* Versions assigned in both arms merge at the join */
+static void PhiAtJoin(CuTest* tc) {
+	Symtab stab;
+	Cfg cfg;
+	Symbol* x;
+	MakeDiamond(tc, &stab, &cfg, &x);
+
+	IL2Statement before[4][2];
+	for (int i = 0; i < 4; ++i) {
+		Block* blk = &vec_at(&cfg.blocks, i);
+		for (int j = 0; j < block_ilstat_count(blk); ++j) {
+			before[i][j] = *block_ilstat(blk, j);
+		}
+	}
+
+	Ssa ssa;
+	CuAssertIntEquals(tc, ssa_construct(&ssa), ec_noerr);
+	CuAssertIntEquals(tc, ssa_convert(&ssa, &cfg), ec_noerr);
+
+	Block* b = vec_data(&cfg.blocks);
+	Symbol* x0 = il2stat_arg(block_ilstat(&b[0], 0), 0);
+	Symbol* x1 = il2stat_arg(block_ilstat(&b[1], 0), 0);
+	Symbol* x2 = il2stat_arg(block_ilstat(&b[2], 0), 0);
+	CuAssertTrue(tc, x0 != x && x1 != x && x2 != x);
+	CuAssertTrue(tc, x0 != x1 && x0 != x2 && x1 != x2);
+	CuAssertIntEquals(tc, ssa_var(&ssa, x), ssa_var(&ssa, x1));
+
+	CuAssertIntEquals(tc, 0, vec_size(&ssa_block(&ssa, 1)->phi));
+	CuAssertIntEquals(tc, 0, vec_size(&ssa_block(&ssa, 2)->phi));
+	SsaBlock* join = ssa_block(&ssa, 3);
+	CuAssertIntEquals(tc, 1, vec_size(&join->phi));
+	SsaPhi* phi = &vec_at(&join->phi, 0);
+	CuAssertPtrEquals(tc, x1, PhiArg(&ssa, 3, phi, 1));
+	CuAssertPtrEquals(tc, x2, PhiArg(&ssa, 3, phi, 2));
+	CuAssertPtrEquals(tc, phi->result, il2stat_arg(block_ilstat(&b[3], 0), 0));
+
+	/* Versions renamed back to x */
+	ssa_revert(&ssa);
+	for (int i = 0; i < 4; ++i) {
+		Block* blk = &vec_at(&cfg.blocks, i);
+		for (int j = 0; j < block_ilstat_count(blk); ++j) {
+			IL2Statement* stat = block_ilstat(blk, j);
+			CuAssertIntEquals(tc, il2stat_ins(&before[i][j]), il2stat_ins(stat));
+			for (int k = 0; k < il2stat_argc(stat); ++k) {
+				CuAssertPtrEquals(tc, il2stat_arg(&before[i][j], k), il2stat_arg(stat, k));
+			}
+		}
+	}
+
+	ssa_destruct(&ssa);
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* The entry block loops to itself, it merges the version on entering
+   the function with the version from the end of the loop
+   0: l0: add i, i, 1; jnz l0, i  -> 1 0
+   1: ret i */
+static void LoopToEntry(CuTest* tc) {
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+
+	Symbol* i;
+	Symbol* l0;
+	CuAssertIntEquals(tc, symtab_add(&stab, &i, "i", symtab_type_int(&stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_label(&stab, &l0), ec_noerr);
+
+	IL2Statement stats[] = {
+		il2stat_make1(il2_lab, l0),
+		il2stat_make(il2_add, i, i, symtab_constant_one(&stab)),
+		il2stat_make2(il2_jnz, l0, i),
+		il2stat_make1(il2_ret, i),
+	};
+	Cfg cfg;
+	MakeCfg(tc, &cfg, stats, ARRAY_SIZE(stats));
+	CuAssertIntEquals(tc, 2, vec_size(&cfg.blocks));
+
+	Ssa ssa;
+	CuAssertIntEquals(tc, ssa_construct(&ssa), ec_noerr);
+	CuAssertIntEquals(tc, ssa_convert(&ssa, &cfg), ec_noerr);
+
+	SsaBlock* entry = ssa_block(&ssa, 0);
+	CuAssertIntEquals(tc, 2, vec_size(&entry->pred));
+	CuAssertIntEquals(tc, 1, vec_size(&entry->frontier));
+	CuAssertIntEquals(tc, 0, vec_at(&entry->frontier, 0));
+	CuAssertIntEquals(tc, 0, ssa_block(&ssa, 1)->idom);
+	CuAssertTrue(tc, ssa_dominates(&ssa, 0, 1));
+	CuAssertTrue(tc, !ssa_dominates(&ssa, 1, 0));
+
+	Block* b = vec_data(&cfg.blocks);
+	IL2Statement* add = block_ilstat(&b[0], 0);
+	CuAssertIntEquals(tc, 1, vec_size(&entry->phi));
+	SsaPhi* phi = &vec_at(&entry->phi, 0);
+	CuAssertPtrEquals(tc, i, PhiArg(&ssa, 0, phi, -1));
+	CuAssertPtrEquals(tc, il2stat_arg(add, 0), PhiArg(&ssa, 0, phi, 0));
+	CuAssertPtrEquals(tc, phi->result, il2stat_arg(add, 1));
+	CuAssertPtrEquals(tc, il2stat_arg(add, 0), il2stat_arg(block_ilstat(&b[0], 1), 1));
+	CuAssertPtrEquals(tc, il2stat_arg(add, 0), il2stat_arg(block_ilstat(&b[1], 0), 0));
+
+	ssa_revert(&ssa);
+	CuAssertPtrEquals(tc, i, il2stat_arg(add, 0));
+	CuAssertPtrEquals(tc, i, il2stat_arg(add, 1));
+	CuAssertPtrEquals(tc, i, il2stat_arg(block_ilstat(&b[1], 0), 0));
+
+	ssa_destruct(&ssa);
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* Variables with their address taken may be assigned through pointers,
+   they are not renamed. Blocks which cannot be reached are left as is
+   0: mad p, x; mov x, 1; ret x
+   1: mov y, 0; ret y */
+static void EscapedAndUnreachable(CuTest* tc) {
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	/* Variables are added in function scope */
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+
+	Symbol* x;
+	Symbol* y;
+	Symbol* p;
+	CuAssertIntEquals(tc, symtab_add(&stab, &x, "x", symtab_type_int(&stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add(&stab, &y, "y", symtab_type_int(&stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add(&stab, &p, "p", symtab_type_int(&stab)), ec_noerr);
+
+	IL2Statement stats[] = {
+		il2stat_make2(il2_mad, p, x),
+		il2stat_make2(il2_mov, x, symtab_constant_one(&stab)),
+		il2stat_make1(il2_ret, x),
+		il2stat_make2(il2_mov, y, symtab_constant_zero(&stab)),
+		il2stat_make1(il2_ret, y),
+	};
+	Cfg cfg;
+	MakeCfg(tc, &cfg, stats, ARRAY_SIZE(stats));
+	CuAssertIntEquals(tc, 2, vec_size(&cfg.blocks));
+
+	Ssa ssa;
+	CuAssertIntEquals(tc, ssa_construct(&ssa), ec_noerr);
+	CuAssertIntEquals(tc, ssa_convert(&ssa, &cfg), ec_noerr);
+
+	Block* b = vec_data(&cfg.blocks);
+	CuAssertIntEquals(tc, -1, ssa_var(&ssa, x));
+	CuAssertPtrEquals(tc, x, il2stat_arg(block_ilstat(&b[0], 1), 0));
+	CuAssertPtrEquals(tc, x, il2stat_arg(block_ilstat(&b[0], 2), 0));
+	/* Assigned once before it is read, already in SSA form */
+	CuAssertIntEquals(tc, -1, ssa_var(&ssa, p));
+	CuAssertPtrEquals(tc, p, il2stat_arg(block_ilstat(&b[0], 0), 0));
+
+	CuAssertIntEquals(tc, -1, ssa_block(&ssa, 1)->idom);
+	CuAssertIntEquals(tc, -1, ssa_var(&ssa, y));
+	CuAssertPtrEquals(tc, y, il2stat_arg(block_ilstat(&b[1], 0), 0));
+
+	ssa_revert(&ssa);
+	ssa_destruct(&ssa);
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+/* Variables at file scope can be assigned by calls, they are not
+   renamed
+   0: mov g, 1; mov g, 0; ret g */
+static void FileScope(CuTest* tc) {
+	Symtab stab;
+	CuAssertIntEquals(tc, symtab_construct(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	Symbol* g;
+	CuAssertIntEquals(tc, symtab_add(&stab, &g, "g", symtab_type_int(&stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	CuAssertTrue(tc, symbol_file_scope(g));
+
+	IL2Statement stats[] = {
+		il2stat_make2(il2_mov, g, symtab_constant_one(&stab)),
+		il2stat_make2(il2_mov, g, symtab_constant_zero(&stab)),
+		il2stat_make1(il2_ret, g),
+	};
+	Cfg cfg;
+	MakeCfg(tc, &cfg, stats, ARRAY_SIZE(stats));
+
+	Ssa ssa;
+	CuAssertIntEquals(tc, ssa_construct(&ssa), ec_noerr);
+	CuAssertIntEquals(tc, ssa_convert(&ssa, &cfg), ec_noerr);
+
+	Block* b = vec_data(&cfg.blocks);
+	CuAssertIntEquals(tc, -1, ssa_var(&ssa, g));
+	for (int i = 0; i < 3; ++i) {
+		CuAssertPtrEquals(tc, g, il2stat_arg(block_ilstat(&b[0], i), 0));
+	}
+
+	ssa_revert(&ssa);
+	ssa_destruct(&ssa);
+	cfg_destruct(&cfg);
+	symtab_destruct(&stab);
+}
+
+CuSuite* SsaGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, DominatorTree);
+	SUITE_ADD_TEST(suite, PhiAtJoin);
+	SUITE_ADD_TEST(suite, LoopToEntry);
+	SUITE_ADD_TEST(suite, EscapedAndUnreachable);
+	SUITE_ADD_TEST(suite, FileScope);
+	return suite;
+}
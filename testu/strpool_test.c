@@ -0,0 +1,63 @@
+#include "CuTest.h"
+
+#include "common.h"
+#include "strpool.h"
+
+static void StrPoolIntern(CuTest* tc) {
+	StrPool pool;
+	CuAssertIntEquals(tc, ec_noerr, strpool_construct(&pool));
+
+	/* Strings do not need to be null terminated */
+	StrId id1;
+	StrId id2;
+	StrId id3;
+	CuAssertIntEquals(tc, ec_noerr, strpool_intern(&pool, "abcdef", 3, &id1));
+	CuAssertIntEquals(tc, ec_noerr, strpool_intern(&pool, "abc", 3, &id2));
+	CuAssertIntEquals(tc, ec_noerr, strpool_intern(&pool, "abcdef", 6, &id3));
+	CuAssertIntEquals(tc, id1, id2);
+	CuAssertTrue(tc, id1 != id3);
+	CuAssertIntEquals(tc, 2, strpool_size(&pool));
+
+	CuAssertStrEquals(tc, "abc", strpool_str(&pool, id1));
+	CuAssertStrEquals(tc, "abcdef", strpool_str(&pool, id3));
+	CuAssertIntEquals(tc, 3, strpool_len(&pool, id1));
+	CuAssertIntEquals(tc, 6, strpool_len(&pool, id3));
+
+	strpool_destruct(&pool);
+}
+
+static void StrPoolGrow(CuTest* tc) {
+	StrPool pool;
+	CuAssertIntEquals(tc, ec_noerr, strpool_construct(&pool));
+
+	/* Pointers to strings must remain valid as the pool grows */
+	StrId first;
+	CuAssertIntEquals(tc, ec_noerr, strpool_intern(&pool, "x0", 2, &first));
+	const char* first_str = strpool_str(&pool, first);
+
+	for (int i = 0; i < 10000; ++i) {
+		AAPPENDI(name, "x", i);
+		StrId id;
+		CuAssertIntEquals(tc, ec_noerr, strpool_intern(&pool, name, strlength(name), &id));
+		CuAssertIntEquals(tc, i, id);
+	}
+	CuAssertIntEquals(tc, 10000, strpool_size(&pool));
+	CuAssertPtrEquals(tc, (void*)first_str, (void*)strpool_str(&pool, first));
+
+	for (int i = 0; i < 10000; ++i) {
+		AAPPENDI(name, "x", i);
+		StrId id;
+		CuAssertIntEquals(tc, ec_noerr, strpool_intern(&pool, name, strlength(name), &id));
+		CuAssertIntEquals(tc, i, id);
+		CuAssertStrEquals(tc, name, strpool_str(&pool, id));
+	}
+
+	strpool_destruct(&pool);
+}
+
+CuSuite* StrPoolGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, StrPoolIntern);
+	SUITE_ADD_TEST(suite, StrPoolGrow);
+	return suite;
+}
@@ -48,9 +48,15 @@ static void SymbolNameTooLong(CuTest* tc) {
 	type_destruct(&type);
 }
 
+/* Symbols are numerous, mostly temporaries and labels */
+static void SymbolSize(CuTest* tc) {
+	CuAssertTrue(tc, sizeof(Symbol) <= 32);
+}
+
 CuSuite* SymbolGetSuite() {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, SymbolConstruct);
 	SUITE_ADD_TEST(suite, SymbolNameTooLong);
+	SUITE_ADD_TEST(suite, SymbolSize);
 	return suite;
 }
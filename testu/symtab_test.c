@@ -1,5 +1,7 @@
 #include "CuTest.h"
 
+#include <stdio.h>
+
 #include "symtab.h"
 
 static void AddSymbol(CuTest* tc) {
@@ -73,15 +75,95 @@ static void AccessSymbolOutOfScope(CuTest* tc) {
 	symtab_destruct(&stab);
 }
 
+static void ShadowSymbol(CuTest* tc) {
+	Symtab stab;
+	CuAssertTrue(tc, symtab_construct(&stab) == ec_noerr);
+
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	Symbol* outer;
+	CuAssertIntEquals(tc, symtab_add(&stab, &outer, "x", symtab_type_int(&stab)), ec_noerr);
+
+	/* Inner symbol of same name hides the outer one until its scope is popped */
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	Symbol* inner;
+	CuAssertIntEquals(tc, symtab_add(&stab, &inner, "x", symtab_type_int(&stab)), ec_noerr);
+	CuAssertTrue(tc, inner != outer);
+	CuAssertPtrEquals(tc, inner, symtab_find(&stab, "x"));
+	symtab_pop_scope(&stab);
+
+	CuAssertPtrEquals(tc, outer, symtab_find(&stab, "x"));
+
+	symtab_destruct(&stab);
+}
+
+/* Finding a symbol should not get slower as more are added,
+   each lookup must not search all the others */
+static void ManyDistinctLocals(CuTest* tc) {
+	const int locals = 100000;
+
+	Symtab stab;
+	CuAssertTrue(tc, symtab_construct(&stab) == ec_noerr);
+
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+	CuAssertIntEquals(tc, symtab_push_scope(&stab), ec_noerr);
+
+	char name[16];
+	for (int i = 0; i < locals; ++i) {
+		snprintf(name, sizeof(name), "v%d", i);
+		Symbol* sym;
+		CuAssertIntEquals(tc, symtab_add(&stab, &sym, name, symtab_type_int(&stab)), ec_noerr);
+	}
+	for (int i = 0; i < locals; ++i) {
+		snprintf(name, sizeof(name), "v%d", i);
+		Symbol* found = symtab_find(&stab, name);
+		CuAssertPtrNotNull(tc, found);
+		CuAssertStrEquals(tc, name, symbol_token(found));
+	}
+
+	symtab_pop_scope(&stab);
+	CuAssertPtrEquals(tc, NULL, symtab_find(&stab, "v0"));
+	CuAssertPtrEquals(tc, NULL, symtab_find(&stab, "v99999"));
+
+	symtab_destruct(&stab);
+}
+
 static void AddConstant(CuTest* tc) {
 	Symtab stab;
 	CuAssertTrue(tc, symtab_construct(&stab) == ec_noerr);
 
 	Symbol* sym = NULL;
-	symtab_add_constant(&stab, &sym, "1234", symtab_type_int(&stab));
+	symtab_add_constant(&stab, &sym, "1234", 1234, symtab_type_int(&stab));
 
 	CuAssertPtrNotNull(tc, sym);
 	CuAssertStrEquals(tc, symbol_token(sym), "1234");
+	CuAssertTrue(tc, symbol_is_constant(sym));
+	CuAssertTrue(tc, symbol_constant_value(sym) == 1234);
+
+	symtab_destruct(&stab);
+}
+
+/* Constants of same value and type are one symbol */
+static void DeduplicateConstant(CuTest* tc) {
+	Symtab stab;
+	CuAssertTrue(tc, symtab_construct(&stab) == ec_noerr);
+
+	Symbol* sym;
+	Symbol* dup;
+	CuAssertIntEquals(tc, symtab_add_constant(&stab, &sym, "16", 16, symtab_type_int(&stab)), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_constant(&stab, &dup, "0x10", 16, symtab_type_int(&stab)), ec_noerr);
+	CuAssertPtrEquals(tc, sym, dup);
+
+	Type type_long;
+	CuAssertIntEquals(tc, type_construct(&type_long, ts_long, 0), ec_noerr);
+	CuAssertIntEquals(tc, symtab_add_constant(&stab, &dup, "16l", 16, &type_long), ec_noerr);
+	CuAssertTrue(tc, sym != dup);
+	type_destruct(&type_long);
+
+	CuAssertIntEquals(tc, symtab_add_constant(&stab, &dup, "0", 0, symtab_type_int(&stab)), ec_noerr);
+	CuAssertPtrEquals(tc, symtab_constant_zero(&stab), dup);
+
+	/* Special constants 0 and 1, 16 and 16l */
+	CuAssertIntEquals(tc, 4, svec_size(&stab.constant));
 
 	symtab_destruct(&stab);
 }
@@ -94,6 +176,7 @@ static void ConstantZero(CuTest* tc) {
 
 	CuAssertPtrNotNull(tc, sym);
 	CuAssertStrEquals(tc, symbol_token(sym), "0");
+	CuAssertTrue(tc, symbol_constant_value(sym) == 0);
 
 	symtab_destruct(&stab);
 }
@@ -104,7 +187,10 @@ CuSuite* SymtabGetSuite() {
 	SUITE_ADD_TEST(suite, DuplicateSymbol);
 	SUITE_ADD_TEST(suite, FindSymbol);
 	SUITE_ADD_TEST(suite, AccessSymbolOutOfScope);
+	SUITE_ADD_TEST(suite, ShadowSymbol);
+	SUITE_ADD_TEST(suite, ManyDistinctLocals);
 	SUITE_ADD_TEST(suite, AddConstant);
+	SUITE_ADD_TEST(suite, DeduplicateConstant);
 	SUITE_ADD_TEST(suite, ConstantZero);
 	return suite;
 }
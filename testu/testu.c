@@ -3,24 +3,42 @@
 #include "CuTest.h"
 
 CuSuite* CfgGetSuite(void);
+CuSuite* CharscanGetSuite(void);
+CuSuite* CopyPropGetSuite(void);
+CuSuite* FlatTreeGetSuite(void);
+CuSuite* IL2GenGetSuite(void);
 CuSuite* LexerGetSuite(void);
 CuSuite* ParserGetSuite(void);
+CuSuite* SccpGetSuite(void);
+CuSuite* SsaGetSuite(void);
+CuSuite* StrPoolGetSuite(void);
 CuSuite* SymbolGetSuite(void);
 CuSuite* SymtabGetSuite(void);
 CuSuite* TreeGetSuite(void);
 CuSuite* TypeGetSuite(void);
+CuSuite* TypeTableGetSuite(void);
+CuSuite* VecGetSuite(void);
 
 int RunAllTests(void) {
 	CuString* output = CuStringNew();
 	CuSuite* suite = CuSuiteNew();
 
 	CuSuiteAddSuite(suite, CfgGetSuite());
+	CuSuiteAddSuite(suite, CharscanGetSuite());
+	CuSuiteAddSuite(suite, CopyPropGetSuite());
+	CuSuiteAddSuite(suite, FlatTreeGetSuite());
+	CuSuiteAddSuite(suite, IL2GenGetSuite());
 	CuSuiteAddSuite(suite, LexerGetSuite());
 	CuSuiteAddSuite(suite, ParserGetSuite());
+	CuSuiteAddSuite(suite, SccpGetSuite());
+	CuSuiteAddSuite(suite, SsaGetSuite());
+	CuSuiteAddSuite(suite, StrPoolGetSuite());
 	CuSuiteAddSuite(suite, SymbolGetSuite());
 	CuSuiteAddSuite(suite, SymtabGetSuite());
 	CuSuiteAddSuite(suite, TreeGetSuite());
 	CuSuiteAddSuite(suite, TypeGetSuite());
+	CuSuiteAddSuite(suite, TypeTableGetSuite());
+	CuSuiteAddSuite(suite, VecGetSuite());
 
 	CuSuiteRun(suite);
 	CuSuiteSummary(suite, output);
@@ -7,15 +7,15 @@ static void AttachDetachNode(CuTest* tc) {
 	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
 
 	TNode* node;
-	tnode_alloca(&node, tree_root(&tree));
+	tnode_alloca(&tree, &node, tree_root(&tree));
 
 	TNode* node_1;
-	tnode_alloca(&node_1, node);
+	tnode_alloca(&tree, &node_1, node);
 
 	TNode* node_2;
-	tnode_alloc(&node_2);
+	tnode_alloc(&tree, &node_2);
 
-	tnode_attach(node, node_2);
+	tnode_attach(&tree, node, node_2);
 
 	CuAssertIntEquals(tc, tnode_count_child(node), 2);
 
@@ -31,18 +31,18 @@ static void DeleteSingleChildNodes(CuTest* tc) {
 	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
 
 	TNode* n1_1;
-	tnode_alloca(&n1_1, tree_root(&tree));
+	tnode_alloca(&tree, &n1_1, tree_root(&tree));
 
 	TNode* n2_1;
-	tnode_alloca(&n2_1, n1_1);
+	tnode_alloca(&tree, &n2_1, n1_1);
 
 	TNode* n2_2;
-	tnode_alloca(&n2_2, n1_1);
+	tnode_alloca(&tree, &n2_2, n1_1);
 
 	TNode* n3_1;
-	tnode_alloca(&n3_1, n2_1);
+	tnode_alloca(&tree, &n3_1, n2_1);
 
-	tnode_remove_if(tree_root(&tree), cmp_func1);
+	tnode_remove_if(&tree, tree_root(&tree), cmp_func1);
 
 	CuAssertPtrEquals(tc, tnode_child(n1_1, 0), n3_1);
 
@@ -54,12 +54,12 @@ static void DeleteSingleChildNodes2(CuTest* tc) {
 	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
 
 	TNode* n1_1;
-	tnode_alloca(&n1_1, tree_root(&tree));
+	tnode_alloca(&tree, &n1_1, tree_root(&tree));
 
 	TNode* n2_1;
-	tnode_alloca(&n2_1, n1_1);
+	tnode_alloca(&tree, &n2_1, n1_1);
 
-	tnode_remove_if(tree_root(&tree), cmp_func1);
+	tnode_remove_if(&tree, tree_root(&tree), cmp_func1);
 
 	CuAssertPtrEquals(tc, tnode_child(tree_root(&tree), 0), n2_1);
 
@@ -75,20 +75,20 @@ static void DeleteMultipleChild(CuTest* tc) {
 	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
 
 	TNode* n1_1;
-	tnode_alloca(&n1_1, tree_root(&tree));
+	tnode_alloca(&tree, &n1_1, tree_root(&tree));
 	TNode* n1_2;
-	tnode_alloca(&n1_2, tree_root(&tree));
+	tnode_alloca(&tree, &n1_2, tree_root(&tree));
 	TNode* n1_3;
-	tnode_alloca(&n1_3, tree_root(&tree));
+	tnode_alloca(&tree, &n1_3, tree_root(&tree));
 
 	TNode* n2_1;
-	tnode_alloca(&n2_1, n1_1);
+	tnode_alloca(&tree, &n2_1, n1_1);
 	TNode* n2_2;
-	tnode_alloca(&n2_2, n1_2);
+	tnode_alloca(&tree, &n2_2, n1_2);
 	TNode* n2_3;
-	tnode_alloca(&n2_3, n1_3);
+	tnode_alloca(&tree, &n2_3, n1_3);
 
-	tnode_remove_if(tree_root(&tree), cmp_func2);
+	tnode_remove_if(&tree, tree_root(&tree), cmp_func2);
 
 	CuAssertIntEquals(tc, tnode_count_child(tree_root(&tree)), 3);
 	CuAssertPtrEquals(tc, tnode_child(tree_root(&tree), 0), n2_1);
@@ -103,20 +103,20 @@ static void DeleteMultipleChild2(CuTest* tc) {
 	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
 
 	TNode* n1_1;
-	tnode_alloca(&n1_1, tree_root(&tree));
+	tnode_alloca(&tree, &n1_1, tree_root(&tree));
 	TNode* n1_2;
-	tnode_alloca(&n1_2, tree_root(&tree));
+	tnode_alloca(&tree, &n1_2, tree_root(&tree));
 	TNode* n1_3;
-	tnode_alloca(&n1_3, tree_root(&tree));
+	tnode_alloca(&tree, &n1_3, tree_root(&tree));
 
 	TNode* n2_1;
-	tnode_alloca(&n2_1, n1_1);
+	tnode_alloca(&tree, &n2_1, n1_1);
 	TNode* n2_2;
-	tnode_alloca(&n2_2, n1_1);
+	tnode_alloca(&tree, &n2_2, n1_1);
 	TNode* n2_3;
-	tnode_alloca(&n2_3, n1_1);
+	tnode_alloca(&tree, &n2_3, n1_1);
 
-	tnode_remove_if(tree_root(&tree), cmp_func2);
+	tnode_remove_if(&tree, tree_root(&tree), cmp_func2);
 
 	CuAssertIntEquals(tc, tnode_count_child(tree_root(&tree)), 5);
 	CuAssertPtrEquals(tc, tnode_child(tree_root(&tree), 0), n2_1);
@@ -138,18 +138,18 @@ static void DeleteLeaf(CuTest* tc) {
 	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
 
 	TNode* n1_1;
-	tnode_alloca(&n1_1, tree_root(&tree));
+	tnode_alloca(&tree, &n1_1, tree_root(&tree));
 	TNode* n1_2;
-	tnode_alloca(&n1_2, tree_root(&tree));
+	tnode_alloca(&tree, &n1_2, tree_root(&tree));
 	TNode* n1_3;
-	tnode_alloca(&n1_3, tree_root(&tree));
+	tnode_alloca(&tree, &n1_3, tree_root(&tree));
 
 	TNode* n2_1;
-	tnode_alloca(&n2_1, n1_3);
+	tnode_alloca(&tree, &n2_1, n1_3);
 	TNodeIdentifier data;
 	tnode_set(n2_1, tt_identifier, &data);
 
-	tnode_remove_if(tree_root(&tree), cmp_func3);
+	tnode_remove_if(&tree, tree_root(&tree), cmp_func3);
 
 	CuAssertIntEquals(tc, tnode_count_child(tree_root(&tree)), 1);
 	CuAssertPtrEquals(tc, tnode_child(tree_root(&tree), 0), n1_3);
@@ -163,13 +163,13 @@ static void DeleteStartAtIndex(CuTest* tc) {
 	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
 
 	TNode* n1_1;
-	tnode_alloca(&n1_1, tree_root(&tree));
+	tnode_alloca(&tree, &n1_1, tree_root(&tree));
 	TNode* n1_2;
-	tnode_alloca(&n1_2, tree_root(&tree));
+	tnode_alloca(&tree, &n1_2, tree_root(&tree));
 	TNode* n1_3;
-	tnode_alloca(&n1_3, tree_root(&tree));
+	tnode_alloca(&tree, &n1_3, tree_root(&tree));
 
-	tnode_remove_ifi(tree_root(&tree), -2, cmp_func3);
+	tnode_remove_ifi(&tree, tree_root(&tree), -2, cmp_func3);
 
 	CuAssertIntEquals(tc, tnode_count_child(tree_root(&tree)), 2);
 	CuAssertPtrEquals(tc, tnode_child(tree_root(&tree), 0), n1_1);
@@ -183,14 +183,14 @@ static void ReplaceChild(CuTest* tc) {
 	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
 
 	TNode* n1_1;
-	tnode_alloca(&n1_1, tree_root(&tree));
+	tnode_alloca(&tree, &n1_1, tree_root(&tree));
 	TNode* n1_2;
-	tnode_alloca(&n1_2, tree_root(&tree));
+	tnode_alloca(&tree, &n1_2, tree_root(&tree));
 	TNode* n1_3;
-	tnode_alloca(&n1_3, tree_root(&tree));
+	tnode_alloca(&tree, &n1_3, tree_root(&tree));
 
 	TNode* new_child;
-	tnode_replace_child(tree_root(&tree), &new_child, -2);
+	tnode_replace_child(&tree, tree_root(&tree), &new_child, -2);
 
 	CuAssertPtrNotNull(tc, new_child);
 
@@ -205,6 +205,48 @@ static void ReplaceChild(CuTest* tc) {
 	tree_destruct(&tree);
 }
 
+static void DestructReusesNode(CuTest* tc) {
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+
+	TNode* n1;
+	tnode_alloc(&tree, &n1);
+	TNode* n2;
+	tnode_alloca(&tree, &n2, n1);
+
+	/* Memory of destructed nodes is reused by later allocations */
+	tnode_destruct(&tree, n1);
+
+	TNode* n3;
+	tnode_alloca(&tree, &n3, tree_root(&tree));
+	CuAssertTrue(tc, n3 == n1 || n3 == n2);
+	CuAssertIntEquals(tc, tree.node_reused, 1);
+	CuAssertIntEquals(tc, tnode_count_child(n3), 0);
+
+	tree_destruct(&tree);
+}
+
+static void WrapChild(CuTest* tc) {
+	Tree tree;
+	CuAssertIntEquals(tc, tree_construct(&tree), ec_noerr);
+
+	TNode* n1_1;
+	tnode_alloca(&tree, &n1_1, tree_root(&tree));
+	TNode* n1_2;
+	tnode_alloca(&tree, &n1_2, tree_root(&tree));
+
+	TNode* wrap;
+	CuAssertIntEquals(tc, tnode_wrap_child(&tree, tree_root(&tree), &wrap, -1), ec_noerr);
+
+	CuAssertIntEquals(tc, tnode_count_child(tree_root(&tree)), 2);
+	CuAssertPtrEquals(tc, tnode_child(tree_root(&tree), 0), n1_1);
+	CuAssertPtrEquals(tc, tnode_child(tree_root(&tree), 1), wrap);
+	CuAssertIntEquals(tc, tnode_count_child(wrap), 1);
+	CuAssertPtrEquals(tc, tnode_child(wrap, 0), n1_2);
+
+	tree_destruct(&tree);
+}
+
 CuSuite* TreeGetSuite() {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, AttachDetachNode);
@@ -215,5 +257,7 @@ CuSuite* TreeGetSuite() {
 	SUITE_ADD_TEST(suite, DeleteLeaf);
 	SUITE_ADD_TEST(suite, DeleteStartAtIndex);
 	SUITE_ADD_TEST(suite, ReplaceChild);
+	SUITE_ADD_TEST(suite, WrapChild);
+	SUITE_ADD_TEST(suite, DestructReusesNode);
 	return suite;
 }
@@ -86,6 +86,39 @@ void TypeEqualFunction(CuTest* tc) {
 	type_destruct(&return_type);
 }
 
+void TypeSameRepresentation(CuTest* tc) {
+	Type i;
+	type_construct(&i, ts_int, 0);
+	Type l;
+	type_construct(&l, ts_long, 0);
+	Type ul;
+	type_construct(&ul, ts_ulong, 0);
+	Type c;
+	type_construct(&c, ts_char, 0);
+	Type ip;
+	type_construct(&ip, ts_int, 1);
+	Type lp;
+	type_construct(&lp, ts_long, 1);
+	Type f;
+	type_construct(&f, ts_float, 0);
+
+	CuAssertTrue(tc, type_same_representation(&i, &l));
+	CuAssertTrue(tc, type_same_representation(&ip, &lp));
+	CuAssertFalse(tc, type_same_representation(&l, &ul));
+	CuAssertFalse(tc, type_same_representation(&i, &c));
+	CuAssertFalse(tc, type_same_representation(&i, &ip));
+	/* Same size, but not an integer */
+	CuAssertFalse(tc, type_same_representation(&i, &f));
+
+	type_destruct(&f);
+	type_destruct(&lp);
+	type_destruct(&ip);
+	type_destruct(&c);
+	type_destruct(&ul);
+	type_destruct(&l);
+	type_destruct(&i);
+}
+
 void TypeSpecifierFromString(CuTest* tc) {
 	CuAssertTrue(tc, ts_from_str("void") == ts_void);
 
@@ -140,6 +173,19 @@ void TypeSpecifierFromString(CuTest* tc) {
 	CuAssertTrue(tc, ts_from_str("long long double") == ts_none);
 }
 
+/* Limits of the integer types, long is 32 bits */
+static void TypeMax(CuTest* tc) {
+	CuAssertTrue(tc, type_max(ts_char) == INT8_MAX);
+	CuAssertTrue(tc, type_max(ts_uchar) == UINT8_MAX);
+	CuAssertTrue(tc, type_max(ts_short) == INT16_MAX);
+	CuAssertTrue(tc, type_max(ts_int) == INT32_MAX);
+	CuAssertTrue(tc, type_max(ts_uint) == UINT32_MAX);
+	CuAssertTrue(tc, type_max(ts_long) == INT32_MAX);
+	CuAssertTrue(tc, type_max(ts_ulong) == UINT32_MAX);
+	CuAssertTrue(tc, type_max(ts_longlong) == INT64_MAX);
+	CuAssertTrue(tc, type_max(ts_ulonglong) == UINT64_MAX);
+}
+
 CuSuite* TypeGetSuite() {
 	CuSuite* suite = CuSuiteNew();
 	SUITE_ADD_TEST(suite, TypeConstruct);
@@ -147,6 +193,8 @@ CuSuite* TypeGetSuite() {
 	SUITE_ADD_TEST(suite, TypeCopy);
 	SUITE_ADD_TEST(suite, TypeEqualPointers);
 	SUITE_ADD_TEST(suite, TypeEqualFunction);
+	SUITE_ADD_TEST(suite, TypeSameRepresentation);
 	SUITE_ADD_TEST(suite, TypeSpecifierFromString);
+	SUITE_ADD_TEST(suite, TypeMax);
 	return suite;
 }
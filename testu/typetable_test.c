@@ -0,0 +1,113 @@
+#include "CuTest.h"
+
+#include "typetable.h"
+
+/* Equal types have the same handle */
+static void InternType(CuTest* tc) {
+	TypeTable table;
+	CuAssertIntEquals(tc, typetable_construct(&table), ec_noerr);
+
+	Type type;
+	Type* int_ptr;
+	Type* int_ptr2;
+	Type* int_ptr_ptr;
+	CuAssertIntEquals(tc, type_construct(&type, ts_int, 1), ec_noerr);
+	CuAssertIntEquals(tc, typetable_intern(&table, &type, &int_ptr), ec_noerr);
+	CuAssertIntEquals(tc, typetable_intern(&table, &type, &int_ptr2), ec_noerr);
+	CuAssertPtrEquals(tc, int_ptr, int_ptr2);
+	CuAssertTrue(tc, int_ptr != &type);
+
+	type_set_pointer(&type, 2);
+	CuAssertIntEquals(tc, typetable_intern(&table, &type, &int_ptr_ptr), ec_noerr);
+	CuAssertTrue(tc, int_ptr != int_ptr_ptr);
+	CuAssertIntEquals(tc, 2, typetable_size(&table));
+	type_destruct(&type);
+
+	typetable_destruct(&table);
+}
+
+/* Arrays of different sizes and functions of different return types are
+   distinct types */
+static void InternDistinctType(CuTest* tc) {
+	TypeTable table;
+	CuAssertIntEquals(tc, typetable_construct(&table), ec_noerr);
+
+	Type array;
+	Type* array5;
+	Type* array6;
+	CuAssertIntEquals(tc, type_construct(&array, ts_int, 0), ec_noerr);
+	type_add_dimension(&array, 5);
+	CuAssertIntEquals(tc, typetable_intern(&table, &array, &array5), ec_noerr);
+	type_destruct(&array);
+	CuAssertIntEquals(tc, type_construct(&array, ts_int, 0), ec_noerr);
+	type_add_dimension(&array, 6);
+	CuAssertIntEquals(tc, typetable_intern(&table, &array, &array6), ec_noerr);
+	type_destruct(&array);
+	CuAssertTrue(tc, array5 != array6);
+
+	Type ret;
+	Type function;
+	Type* int_function;
+	Type* int_function2;
+	Type* long_function;
+	CuAssertIntEquals(tc, type_construct(&ret, ts_int, 0), ec_noerr);
+	CuAssertIntEquals(tc, type_constructf(&function, &ret, 1), ec_noerr);
+	CuAssertIntEquals(tc, typetable_intern(&table, &function, &int_function), ec_noerr);
+	CuAssertIntEquals(tc, typetable_intern(&table, &function, &int_function2), ec_noerr);
+	CuAssertPtrEquals(tc, int_function, int_function2);
+	type_destruct(&function);
+	type_destruct(&ret);
+
+	CuAssertIntEquals(tc, type_construct(&ret, ts_long, 0), ec_noerr);
+	CuAssertIntEquals(tc, type_constructf(&function, &ret, 1), ec_noerr);
+	CuAssertIntEquals(tc, typetable_intern(&table, &function, &long_function), ec_noerr);
+	CuAssertTrue(tc, int_function != long_function);
+	type_destruct(&function);
+	type_destruct(&ret);
+
+	typetable_destruct(&table);
+}
+
+static Type* InternStandard(CuTest* tc, TypeTable* table, TypeSpecifiers ts) {
+	Type type;
+	Type* handle;
+	CuAssertIntEquals(tc, type_construct(&type, ts, 0), ec_noerr);
+	CuAssertIntEquals(tc, typetable_intern(table, &type, &handle), ec_noerr);
+	type_destruct(&type);
+	return handle;
+}
+
+/* Operands are promoted before the common type is found */
+static void CommonType(CuTest* tc) {
+	TypeTable table;
+	CuAssertIntEquals(tc, typetable_construct(&table), ec_noerr);
+
+	Type* type_char = InternStandard(tc, &table, ts_char);
+	Type* type_short = InternStandard(tc, &table, ts_short);
+	Type* type_int = InternStandard(tc, &table, ts_int);
+	Type* type_uint = InternStandard(tc, &table, ts_uint);
+	Type* type_longlong = InternStandard(tc, &table, ts_longlong);
+
+	Type* common;
+	CuAssertIntEquals(tc, typetable_common(&table, type_char, type_short, &common), ec_noerr);
+	CuAssertPtrEquals(tc, type_int, common);
+	CuAssertIntEquals(tc, typetable_common(&table, type_uint, type_longlong, &common), ec_noerr);
+	CuAssertPtrEquals(tc, type_longlong, common);
+	CuAssertIntEquals(tc, typetable_common(&table, type_int, type_uint, &common), ec_noerr);
+	CuAssertPtrEquals(tc, type_uint, common);
+
+	/* Memoized result is the same */
+	CuAssertIntEquals(tc, typetable_common(&table, type_char, type_short, &common), ec_noerr);
+	CuAssertPtrEquals(tc, type_int, common);
+	CuAssertIntEquals(tc, 5, typetable_size(&table));
+
+	typetable_destruct(&table);
+}
+
+CuSuite* TypeTableGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, InternType);
+	SUITE_ADD_TEST(suite, InternDistinctType);
+	SUITE_ADD_TEST(suite, CommonType);
+	return suite;
+}
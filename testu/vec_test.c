@@ -0,0 +1,46 @@
+#include "CuTest.h"
+
+#include "vec.h"
+
+/* Elements keep their address when elements are inserted before them,
+   spliced before them, or the svec grows */
+static void SvecStableAddress(CuTest* tc) {
+	const int count = SVEC_SLAB_SIZE * 3 + 1;
+
+	svec_t(int) svec;
+	svec_construct(&svec);
+	for (int i = 0; i < count; ++i) {
+		CuAssertTrue(tc, svec_push_back(&svec, i));
+	}
+	int* last = &svec_back(&svec);
+	int* second = &svec_at(&svec, 1);
+
+	/* -1 0 1 2 ... */
+	CuAssertTrue(tc, svec_insert(&svec, -1, 0));
+	CuAssertIntEquals(tc, count + 1, svec_size(&svec));
+	CuAssertIntEquals(tc, -1, svec_at(&svec, 0));
+	CuAssertPtrEquals(tc, second, &svec_at(&svec, 2));
+	CuAssertPtrEquals(tc, last, &svec_back(&svec));
+
+	/* -1 1 2 ... */
+	svec_splice(&svec, 1, 1);
+	CuAssertIntEquals(tc, count, svec_size(&svec));
+	CuAssertPtrEquals(tc, second, &svec_at(&svec, 1));
+	CuAssertPtrEquals(tc, last, &svec_back(&svec));
+	for (int i = 1; i < count; ++i) {
+		CuAssertIntEquals(tc, i, svec_at(&svec, i));
+	}
+
+	/* Spliced element's storage is reused */
+	CuAssertTrue(tc, svec_push_back(&svec, count));
+	CuAssertIntEquals(tc, count, svec_back(&svec));
+	CuAssertPtrEquals(tc, last, &svec_at(&svec, count - 1));
+
+	svec_destruct(&svec);
+}
+
+CuSuite* VecGetSuite() {
+	CuSuite* suite = CuSuiteNew();
+	SUITE_ADD_TEST(suite, SvecStableAddress);
+	return suite;
+}